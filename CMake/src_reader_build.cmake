@@ -24,11 +24,21 @@ get_filename_component(SRC_READER_BINARY_DIR ${CMAKE_CURRENT_BINARY_DIR} DIRECTO
 # Compiler options
 add_definitions("-std=c++14")
 
+# the SIMD scanners use SSE2 on x86-64; AVX2 is opt-in as it needs a newer CPU
+option(SRCREADER_AVX2 "Build the SIMD text scanners with AVX2" OFF)
+
+# event counters and timers on srcml_reader and srcml_writer, compiled out unless enabled
+option(SRCREADER_STATS "Keep runtime statistics in srcml_reader and srcml_writer" OFF)
+if(SRCREADER_STATS)
+    add_definitions(-DSRCREADER_STATS)
+endif()
+
 # find needed libraries
 find_package(LibXml2 REQUIRED)
+find_package(Threads REQUIRED)
 
 set(LIBSRCML_INCLUDE_DIRS /usr/local/include ${LIBXML2_INCLUDE_DIR})
-set(LIBSRCML_LIBRARIES srcml ${LIBXML2_LIBRARIES})
+set(LIBSRCML_LIBRARIES srcml ${LIBXML2_LIBRARIES} ${CMAKE_THREAD_LIBS_INIT})
 link_directories(/usr/local/lib)
 
 set(SRC_READER_INCLUDE_DIRS ${SRC_READER_SOURCE_DIR}/src ${LIBSRCML_INCLUDE_DIRS}  CACHE INTERNAL "Include directories for SRC_READER")
@@ -39,3 +49,9 @@ include_directories(${SRC_READER_INCLUDE_DIRS})
 
 # Continue to build directory
 add_subdirectory(${SRC_READER_SOURCE_DIR}/src ${SRC_READER_BINARY_DIR}/src)
+
+# benchmarks and tests are only built for srcReader itself
+if(CMAKE_PROJECT_NAME STREQUAL "srcReader")
+    add_subdirectory(${SRC_READER_SOURCE_DIR}/bench ${SRC_READER_BINARY_DIR}/bench)
+    add_subdirectory(${SRC_READER_SOURCE_DIR}/test ${SRC_READER_BINARY_DIR}/test)
+endif()
@@ -0,0 +1,77 @@
+/*
+  allocation_bench.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_bench.hpp>
+
+#include <srcml_reader.hpp>
+
+/**
+ * node_allocations
+ *
+ * Heap allocations made while advancing the reader, broken down by the
+ * kind of event advanced to.  Allocations made by libxml2 itself are
+ * included, as they are part of the cost of an event.
+ */
+SRCREADER_BENCH(node_allocations, "<srcml file>") {
+
+  if(arguments.size() != 1) throw std::invalid_argument("expected a srcML file");
+
+  enum { START, START_ATTRIBUTES, END, TEXT, OTHER, KINDS };
+  static const char * const names[KINDS] = { "start", "start_with_attributes", "end", "text", "other" };
+  std::size_t events[KINDS] = {};
+  std::size_t allocations[KINDS] = {};
+
+  srcml_reader reader(arguments[0]);
+  srcml_reader::srcml_reader_iterator itr = reader.begin();
+  while(itr != reader.end()) {
+
+    std::size_t before = srcreader_bench::allocations();
+    ++itr;
+    std::size_t delta = srcreader_bench::allocations() - before;
+
+    int kind = OTHER;
+    if(itr->is_start())     kind = itr->attributes.empty() ? START : START_ATTRIBUTES;
+    else if(itr->is_end())  kind = END;
+    else if(itr->is_text()) kind = TEXT;
+
+    ++events[kind];
+    allocations[kind] += delta;
+
+  }
+
+  std::size_t total_events = 0;
+  std::size_t total_allocations = 0;
+  bench_report report("node_allocations");
+  for(int kind = 0; kind < KINDS; ++kind) {
+    total_events += events[kind];
+    total_allocations += allocations[kind];
+    report.add(std::string(names[kind]) + "_events", events[kind]);
+    report.add(std::string(names[kind]) + "_allocations_per_event", events[kind] ? double(allocations[kind]) / events[kind] : 0.0);
+  }
+  report.add("events", total_events);
+  report.add("allocations", total_allocations);
+  report.add("allocations_per_event", total_events ? double(total_allocations) / total_events : 0.0);
+  report.print();
+
+  return 0;
+}
@@ -0,0 +1,69 @@
+/*
+  allocation_counter.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_ALLOCATION_COUNTER_HPP
+#define INCLUDED_ALLOCATION_COUNTER_HPP
+
+#include <atomic>
+#include <new>
+#include <cstddef>
+#include <cstdlib>
+
+/**
+ * allocation_counter
+ *
+ * Replaces the global operator new and operator delete to count heap
+ * allocations in allocation_count.  The replacements are definitions,
+ * so the header is included by one source file of a program, e.g., the
+ * bench driver or a test.
+ */
+static std::atomic<std::size_t> allocation_count(0);
+
+void * operator new(std::size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  void * ptr = std::malloc(size ? size : 1);
+  if(!ptr) throw std::bad_alloc();
+  return ptr;
+}
+
+void * operator new[](std::size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void * ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void * ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+#endif
@@ -0,0 +1,100 @@
+/*
+  async_writer_bench.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_bench.hpp>
+
+#include <srcml_reader.hpp>
+#include <srcml_writer.hpp>
+#include <srcml_async_writer.hpp>
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static std::string read_file(const std::string & filename) {
+
+  std::ifstream in(filename, std::ios::binary);
+  if(!in) throw std::runtime_error("unable to open: " + filename);
+  return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+/**
+ * async_write
+ *
+ * Writes the nodes of a document, read into memory beforehand, with
+ * srcml_writer and then with srcml_async_writer, and checks the two
+ * outputs are the same.  write_seconds is the time the caller spends in
+ * write() calls, which is what the writer thread takes off the caller.
+ */
+SRCREADER_BENCH(async_write, "<srcml file> <output file> [batch size] [batches]") {
+
+  if(arguments.size() < 2 || arguments.size() > 4) throw std::invalid_argument("expected a srcML file, an output file and an optional batch size and batches");
+
+  const std::size_t batch_size = arguments.size() > 2 ? std::stoull(arguments[2]) : srcml_async_writer::DEFAULT_BATCH_SIZE;
+  const std::size_t batches = arguments.size() > 3 ? std::stoull(arguments[3]) : srcml_async_writer::DEFAULT_BATCHES;
+  const std::string sync_output = arguments[1] + ".sync";
+
+  std::vector<srcml_node> nodes;
+  {
+    srcml_reader reader(arguments[0]);
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end();) {
+      nodes.push_back(itr++);
+    }
+  }
+
+  bench_timer sync_timer;
+  {
+    srcml_writer writer(sync_output);
+    for(const srcml_node & node : nodes) {
+      writer.write(node);
+    }
+  }
+  const double sync_seconds = sync_timer.seconds();
+
+  double write_seconds = 0;
+  bench_timer async_timer;
+  {
+    srcml_async_writer writer(arguments[1], batch_size, batches);
+    for(const srcml_node & node : nodes) {
+      writer.write(node);
+    }
+    write_seconds = async_timer.seconds();
+    writer.flush();
+  }
+  const double async_seconds = async_timer.seconds();
+
+  if(read_file(sync_output) != read_file(arguments[1])) throw std::runtime_error("asynchronous output differs");
+
+  bench_report report("async_write");
+  report.add("nodes", nodes.size());
+  report.add("batch_size", batch_size);
+  report.add("batches", batches);
+  report.add("sync_seconds", sync_seconds);
+  report.add("async_seconds", async_seconds);
+  report.add("write_seconds", write_seconds);
+  report.print();
+
+  return 0;
+}
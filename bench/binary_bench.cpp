@@ -0,0 +1,90 @@
+/*
+  binary_bench.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_bench.hpp>
+
+#include <srcml_reader.hpp>
+#include <srcml_binary_reader.hpp>
+#include <srcml_binary_writer.hpp>
+
+#include <fstream>
+#include <stdexcept>
+
+static std::size_t file_size(const std::string & filename) {
+  std::ifstream file(filename, std::ios::in | std::ios::binary | std::ios::ate);
+  return file.tellg();
+}
+
+/**
+ * binary_reread
+ *
+ * Converts a srcML file to the binary event format, then compares the
+ * size of the two files and the time to read each of them.
+ */
+SRCREADER_BENCH(binary_reread, "<srcml file> <binary output file>") {
+
+  if(arguments.size() != 2) throw std::invalid_argument("expected a srcML file and a binary output file");
+
+  bench_timer convert_timer;
+  {
+    srcml_reader reader(arguments[0]);
+    srcml_binary_writer writer(arguments[1]);
+    for(const srcml_node & node : reader) {
+      writer.write(node);
+    }
+  }
+  double convert_seconds = convert_timer.seconds();
+
+  bench_timer xml_timer;
+  std::size_t xml_events = 0;
+  {
+    srcml_reader reader(arguments[0]);
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+      ++xml_events;
+    }
+  }
+  double xml_seconds = xml_timer.seconds();
+
+  bench_timer binary_timer;
+  std::size_t binary_events = 0;
+  {
+    srcml_binary_reader reader(arguments[1]);
+    for(srcml_binary_reader::srcml_binary_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+      ++binary_events;
+    }
+  }
+  double binary_seconds = binary_timer.seconds();
+
+  bench_report report("binary_reread");
+  report.add("xml_bytes", file_size(arguments[0]));
+  report.add("binary_bytes", file_size(arguments[1]));
+  report.add("convert_seconds", convert_seconds);
+  report.add("xml_events", xml_events);
+  report.add("xml_seconds", xml_seconds);
+  report.add("binary_events", binary_events);
+  report.add("binary_seconds", binary_seconds);
+  report.add("speedup", xml_seconds / binary_seconds);
+  report.print();
+
+  return 0;
+}
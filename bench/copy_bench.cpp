@@ -0,0 +1,111 @@
+/*
+  copy_bench.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_bench.hpp>
+
+#include <srcml_reader.hpp>
+
+#include <utility>
+#include <vector>
+
+/**
+ * counted_data
+ *
+ * user_data payload that counts how often it is copied.
+ */
+class counted_data {
+
+public:
+
+  static std::size_t copies;
+
+  counted_data() {}
+  counted_data(const counted_data &) { ++copies; }
+  counted_data(counted_data &&) noexcept {}
+  counted_data & operator=(const counted_data &) { ++copies; return *this; }
+  counted_data & operator=(counted_data &&) noexcept { return *this; }
+
+};
+
+std::size_t counted_data::copies = 0;
+
+/**
+ * node_copies
+ *
+ * Copies of node payloads made by reading, by collecting nodes with
+ * the postfix iterator, and by moving nodes into a container.  All of
+ * these should be zero; an explicit copy is counted for reference.
+ */
+SRCREADER_BENCH(node_copies, "<srcml file>") {
+
+  if(arguments.size() != 1) throw std::invalid_argument("expected a srcML file");
+
+  std::size_t events = 0;
+  std::size_t read_copies = 0;
+  std::size_t postfix_copies = 0;
+  std::size_t move_copies = 0;
+
+  // advancing past a node that holds a payload
+  srcml_reader scan(arguments[0]);
+  for(srcml_reader::srcml_reader_iterator itr = scan.begin(); itr != scan.end();) {
+
+    itr->user_data = counted_data();
+
+    std::size_t before = counted_data::copies;
+    ++itr;
+    read_copies += counted_data::copies - before;
+
+  }
+
+  std::vector<srcml_node> collected;
+  srcml_reader reader(arguments[0]);
+  for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end();) {
+
+    ++events;
+    itr->user_data = counted_data();
+
+    std::size_t before = counted_data::copies;
+    srcml_node node = itr++;
+    postfix_copies += counted_data::copies - before;
+
+    before = counted_data::copies;
+    collected.push_back(std::move(node));
+    if(collected.size() == 1024) collected.clear();
+    move_copies += counted_data::copies - before;
+
+  }
+
+  std::size_t before = counted_data::copies;
+  if(!collected.empty()) srcml_node copy = collected.back();
+  std::size_t explicit_copies = counted_data::copies - before;
+
+  bench_report report("node_copies");
+  report.add("events", events);
+  report.add("read_copies", read_copies);
+  report.add("postfix_copies", postfix_copies);
+  report.add("move_copies", move_copies);
+  report.add("explicit_copies", explicit_copies);
+  report.print();
+
+  return 0;
+}
@@ -0,0 +1,107 @@
+/*
+  element_path_bench.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_bench.hpp>
+
+#include <srcml_reader.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <stack>
+
+/**
+ * ancestor_queries
+ *
+ * Time to ask at every event whether the reader is inside an element
+ * and how deep the nearest one is, first by searching a copy of the
+ * string element stack, then with the element path.  Plain reading is
+ * timed for reference.
+ */
+SRCREADER_BENCH(ancestor_queries, "<srcml file> <element>") {
+
+  if(arguments.size() != 2) throw std::invalid_argument("expected a srcML file and an element");
+
+  const std::string & element = arguments[1];
+
+  bench_timer read_timer;
+  std::size_t events = 0;
+  {
+    srcml_reader reader(arguments[0]);
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+      ++events;
+    }
+  }
+  double read_seconds = read_timer.seconds();
+
+  bench_timer stack_timer;
+  std::size_t stack_inside = 0;
+  std::size_t stack_depths = 0;
+  {
+    srcml_reader reader(arguments[0]);
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+
+      std::stack<std::string> stack = reader.get_element_stack();
+      for(; !stack.empty(); stack.pop()) {
+        if(stack.top() == element) {
+          ++stack_inside;
+          stack_depths += stack.size() - 1;
+          break;
+        }
+      }
+
+    }
+  }
+  double stack_seconds = stack_timer.seconds();
+
+  bench_timer path_timer;
+  std::size_t path_inside = 0;
+  std::size_t path_depths = 0;
+  {
+    const srcml_symbol name(element);
+    srcml_reader reader(arguments[0]);
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+
+      const srcml_element_path & path = reader.get_element_path();
+      if(path.is_inside(name)) {
+        ++path_inside;
+        path_depths += path.nearest(name);
+      }
+
+    }
+  }
+  double path_seconds = path_timer.seconds();
+
+  if(stack_inside != path_inside || stack_depths != path_depths) throw std::runtime_error("element stack and path disagree");
+
+  bench_report report("ancestor_queries");
+  report.add("element", element);
+  report.add("events", events);
+  report.add("inside", path_inside);
+  report.add("read_seconds", read_seconds);
+  report.add("stack_seconds", stack_seconds);
+  report.add("path_seconds", path_seconds);
+  report.add("path_overhead", (path_seconds - read_seconds) / read_seconds);
+  report.print();
+
+  return 0;
+}
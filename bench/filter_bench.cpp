@@ -0,0 +1,96 @@
+/*
+  filter_bench.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_bench.hpp>
+
+#include <srcml_reader.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * filtered_read
+ *
+ * Time to collect the events inside one kind of element by reading
+ * everything and discarding the rest, compared with letting the reader
+ * filter, optionally also skipping another kind of element.
+ */
+SRCREADER_BENCH(filtered_read, "<srcml file> <element> [skipped element]") {
+
+  if(arguments.size() != 2 && arguments.size() != 3) throw std::invalid_argument("expected a srcML file and an element");
+
+  const std::string & element = arguments[1];
+  std::vector<std::string> skipped;
+  if(arguments.size() == 3) skipped.push_back(arguments[2]);
+
+  bench_timer full_timer;
+  std::size_t full_events = 0;
+  {
+    std::size_t depth = 0;
+    std::size_t skip_depth = 0;
+    srcml_reader reader(arguments[0]);
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+
+      if(skip_depth) {
+        if(itr->is_start()) ++skip_depth;
+        if(itr->is_end()) --skip_depth;
+        continue;
+      }
+
+      if(itr->is_start() && !skipped.empty() && itr->full_name() == skipped[0]) {
+        skip_depth = 1;
+        continue;
+      }
+
+      if(itr->is_start() && (depth || itr->full_name() == element)) ++depth;
+      if(depth) ++full_events;
+      if(depth && itr->is_end()) --depth;
+
+    }
+  }
+  double full_seconds = full_timer.seconds();
+
+  bench_timer filtered_timer;
+  std::size_t filtered_events = 0;
+  {
+    srcml_reader reader(arguments[0]);
+    reader.set_element_filter({ element }, skipped);
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+      ++filtered_events;
+    }
+  }
+  double filtered_seconds = filtered_timer.seconds();
+
+  bench_report report("filtered_read");
+  report.add("element", element);
+  report.add("skipped", skipped.empty() ? std::string() : skipped[0]);
+  report.add("full_events", full_events);
+  report.add("full_seconds", full_seconds);
+  report.add("filtered_events", filtered_events);
+  report.add("filtered_seconds", filtered_seconds);
+  report.add("speedup", full_seconds / filtered_seconds);
+  report.print();
+
+  return 0;
+}
@@ -0,0 +1,122 @@
+/*
+  input_bench.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_bench.hpp>
+
+#include <srcml_reader.hpp>
+#include <srcml_input.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <memory>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+static std::size_t count_events(srcml_reader & reader) {
+
+  std::size_t events = 0;
+  for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+    ++events;
+  }
+
+  return events;
+}
+
+/**
+ * input_paths
+ *
+ * Time to read a document through each input source: libxml2's own
+ * file I/O, a buffer already in memory, a memory-mapped file, a file
+ * descriptor with small and large blocks, and an istream.
+ */
+SRCREADER_BENCH(input_paths, "<srcml file>") {
+
+  if(arguments.size() != 1) throw std::invalid_argument("expected a srcML file");
+  const std::string & filename = arguments[0];
+
+  bench_report report("input_paths");
+
+  {
+    bench_timer timer;
+    srcml_reader reader(filename);
+    report.add("filename_events", count_events(reader));
+    report.add("filename_seconds", timer.seconds());
+  }
+
+  {
+    bench_timer load_timer;
+    std::ifstream in(filename, std::ios::in | std::ios::binary);
+    std::ostringstream contents;
+    contents << in.rdbuf();
+    std::string buffer = contents.str();
+    report.add("memory_load_seconds", load_timer.seconds());
+
+    bench_timer timer;
+    srcml_reader reader(buffer.data(), buffer.size());
+    report.add("memory_events", count_events(reader));
+    report.add("memory_seconds", timer.seconds());
+  }
+
+  {
+    bench_timer timer;
+    srcml_reader reader(std::unique_ptr<srcml_input>(new srcml_mapped_input(filename)));
+    report.add("mapped_events", count_events(reader));
+    report.add("mapped_seconds", timer.seconds());
+  }
+
+  for(std::size_t block_size : { std::size_t(4096), std::size_t(1 << 16), std::size_t(1 << 20) }) {
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    if(fd == -1) throw std::runtime_error("Error openining: " + filename);
+
+    bench_timer timer;
+    std::size_t events = 0;
+    {
+      srcml_reader reader(fd, block_size);
+      events = count_events(reader);
+    }
+    double seconds = timer.seconds();
+    close(fd);
+
+    std::string key = "fd_" + std::to_string(block_size);
+    report.add(key + "_events", events);
+    report.add(key + "_seconds", seconds);
+
+  }
+
+  {
+    std::ifstream in(filename, std::ios::in | std::ios::binary);
+
+    bench_timer timer;
+    srcml_reader reader(in);
+    report.add("istream_events", count_events(reader));
+    report.add("istream_seconds", timer.seconds());
+  }
+
+  report.print();
+
+  return 0;
+}
@@ -0,0 +1,82 @@
+/*
+  parallel_bench.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_bench.hpp>
+
+#include <srcml_reader.hpp>
+#include <srcml_parallel_reader.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * parallel_read
+ *
+ * Time to read every unit of an archive sequentially and with the
+ * parallel reader at 1, 2, 4, 8 and 16 threads, in archive order.
+ * Both collect the nodes of each unit into a vector so the times are
+ * comparable.
+ */
+SRCREADER_BENCH(parallel_read, "<srcml archive>") {
+
+  if(arguments.size() != 1) throw std::invalid_argument("expected a srcML archive");
+
+  bench_timer sequential_timer;
+  std::size_t sequential_events = 0;
+  std::vector<srcml_node> nodes;
+  srcml_reader reader(arguments[0]);
+  for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end();) {
+    nodes.push_back(itr++);
+    if(reader.get_element_path().depth() <= 1) {
+      sequential_events += nodes.size();
+      nodes.clear();
+    }
+  }
+  double sequential_seconds = sequential_timer.seconds();
+
+  bench_report report("parallel_read");
+  report.add("sequential_events", sequential_events);
+  report.add("sequential_seconds", sequential_seconds);
+
+  for(std::size_t threads = 1; threads <= 16; threads *= 2) {
+
+    bench_timer timer;
+    std::size_t events = 0;
+    srcml_parallel_reader parallel_reader(arguments[0], threads);
+    parallel_reader.read([&events](std::size_t, std::vector<srcml_node> & unit) {
+      events += unit.size();
+    });
+    double seconds = timer.seconds();
+
+    std::string key = "threads_" + std::to_string(threads);
+    report.add(key + "_events", events);
+    report.add(key + "_seconds", seconds);
+    report.add(key + "_speedup", sequential_seconds / seconds);
+
+  }
+
+  report.print();
+
+  return 0;
+}
@@ -0,0 +1,136 @@
+/*
+  parallel_writer_bench.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_bench.hpp>
+
+#include <srcml_reader.hpp>
+#include <srcml_parallel_reader.hpp>
+#include <srcml_writer.hpp>
+#include <srcml_unit_committer.hpp>
+
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static std::string read_output(const std::string & filename) {
+
+  std::ifstream in(filename, std::ios::binary);
+  if(!in) throw std::runtime_error("unable to open: " + filename);
+  return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+/**
+ * parallel_write
+ *
+ * Time to write the units of an archive, read into memory beforehand,
+ * sequentially with srcml_writer and with srcml_unit_builders on 1, 2,
+ * 4 and 8 threads committed in archive order.  Every output is checked
+ * against the sequential one.
+ */
+SRCREADER_BENCH(parallel_write, "<srcml archive> <output file>") {
+
+  if(arguments.size() != 2) throw std::invalid_argument("expected a srcML archive and an output file");
+
+  srcml_node root_start;
+  {
+    srcml_reader reader(arguments[0]);
+    root_start = *reader.begin();
+  }
+  srcml_node root_end = root_start;
+  root_end.type = srcml_node::srcml_node_type::END;
+
+  std::vector<std::vector<srcml_node>> units;
+  srcml_parallel_reader(arguments[0]).read([&units](std::size_t, std::vector<srcml_node> & unit) {
+    units.push_back(std::move(unit));
+  });
+
+  const std::string sequential_output = arguments[1] + ".sequential";
+  bench_timer sequential_timer;
+  {
+    srcml_writer writer(sequential_output);
+    writer.write(root_start);
+    for(const std::vector<srcml_node> & unit : units) {
+      for(const srcml_node & node : unit) {
+        writer.write(node);
+      }
+    }
+    writer.write(root_end);
+  }
+  const double sequential_seconds = sequential_timer.seconds();
+  const std::string expected = read_output(sequential_output);
+
+  bench_report report("parallel_write");
+  report.add("units", units.size());
+  report.add("sequential_seconds", sequential_seconds);
+
+  for(std::size_t threads : { 1, 2, 4, 8 }) {
+
+    bench_timer timer;
+    {
+      srcml_writer writer(arguments[1]);
+      writer.write(root_start);
+
+      srcml_unit_committer committer(writer);
+      for(std::size_t i = 0; i < units.size(); ++i) {
+        committer.submit();
+      }
+
+      std::atomic<std::size_t> next_unit(0);
+      auto work = [&]() {
+        for(std::size_t unit_number = next_unit++; unit_number < units.size(); unit_number = next_unit++) {
+          std::unique_ptr<srcml_unit_builder> builder = writer.create_unit_builder();
+          for(const srcml_node & node : units[unit_number]) {
+            builder->write(node);
+          }
+          committer.commit(unit_number, std::move(builder));
+        }
+      };
+
+      std::vector<std::thread> pool;
+      for(std::size_t i = 0; i < threads; ++i) {
+        pool.emplace_back(work);
+      }
+      for(std::thread & worker : pool) {
+        worker.join();
+      }
+
+      committer.finish();
+      writer.write(root_end);
+    }
+    const double seconds = timer.seconds();
+
+    if(read_output(arguments[1]) != expected) throw std::runtime_error("parallel output differs at " + std::to_string(threads) + " threads");
+
+    report.add("threads_" + std::to_string(threads) + "_seconds", seconds);
+    report.add("threads_" + std::to_string(threads) + "_speedup", sequential_seconds / seconds);
+
+  }
+
+  report.print();
+
+  return 0;
+}
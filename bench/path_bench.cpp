@@ -0,0 +1,93 @@
+/*
+  path_bench.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_bench.hpp>
+
+#include <srcml_reader.hpp>
+#include <srcml_path_matcher.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <set>
+#include <random>
+
+/**
+ * path_queries
+ *
+ * Time to run 1 to 1000 path queries over the nodes of a file, which
+ * are read into memory first so only matching is timed.  The queries
+ * are random paths over the element names found in the file.
+ */
+SRCREADER_BENCH(path_queries, "<srcml file>") {
+
+  if(arguments.size() != 1) throw std::invalid_argument("expected a srcML file");
+
+  std::vector<srcml_node> nodes;
+  std::set<std::string> element_names;
+  srcml_reader reader(arguments[0]);
+  for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end();) {
+    if(itr->is_start()) element_names.insert(itr->full_name());
+    nodes.push_back(itr++);
+  }
+
+  std::vector<std::string> names(element_names.begin(), element_names.end());
+  names.push_back("*");
+
+  bench_report report("path_queries");
+  report.add("events", nodes.size());
+
+  for(std::size_t count = 1; count <= 1000; count *= 10) {
+
+    std::mt19937 random(count);
+    srcml_path_matcher matcher;
+    for(std::size_t i = 0; i < count; ++i) {
+
+      std::string query;
+      for(std::size_t steps = 1 + random() % 4; steps; --steps) {
+        query += random() % 2 ? "//" : "/";
+        query += names[random() % names.size()];
+      }
+
+      matcher.add(query);
+    }
+
+    bench_timer timer;
+    std::size_t matches = 0;
+    for(const srcml_node & node : nodes) {
+      matcher.process(node);
+      matches += matcher.started().size();
+    }
+    double seconds = timer.seconds();
+
+    std::string key = "queries_" + std::to_string(count);
+    report.add(key + "_matches", matches);
+    report.add(key + "_seconds", seconds);
+    report.add(key + "_ns_per_event", seconds * 1e9 / nodes.size());
+
+  }
+
+  report.print();
+
+  return 0;
+}
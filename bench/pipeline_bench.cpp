@@ -0,0 +1,113 @@
+/*
+  pipeline_bench.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_bench.hpp>
+
+#include <srcml_reader.hpp>
+#include <srcml_pipelined_reader.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <cstdint>
+
+/** stand-in for per-node analysis: rounds of hashing the node */
+static std::uint64_t analyze(const srcml_node & node, std::size_t rounds) {
+
+  std::uint64_t hash = 14695981039346656037ull ^ node.type;
+  const std::string & name = node.name;
+  for(std::size_t round = 0; round < rounds; ++round) {
+    for(char ch : name) {
+      hash = (hash ^ (unsigned char)ch) * 1099511628211ull;
+    }
+    for(std::size_t i = 0; i < node.content.size(); ++i) {
+      hash = (hash ^ (unsigned char)node.content.data()[i]) * 1099511628211ull;
+    }
+  }
+
+  return hash;
+}
+
+/**
+ * pipelined_read
+ *
+ * Reading with per-node analysis on one thread, and with
+ * srcml_pipelined_reader parsing on a background thread.  The ideal
+ * pipelined time is the larger of parsing alone and analysis alone.
+ */
+SRCREADER_BENCH(pipelined_read, "<srcml file> [analysis rounds per node] [batch size] [batches]") {
+
+  if(arguments.empty() || arguments.size() > 4) throw std::invalid_argument("expected a srcML file and optional rounds, batch size and batches");
+
+  const std::size_t rounds = arguments.size() > 1 ? std::stoull(arguments[1]) : 4;
+  const std::size_t batch_size = arguments.size() > 2 ? std::stoull(arguments[2]) : srcml_pipelined_reader::DEFAULT_BATCH_SIZE;
+  const std::size_t batches = arguments.size() > 3 ? std::stoull(arguments[3]) : srcml_pipelined_reader::DEFAULT_BATCHES;
+
+  bench_timer parse_timer;
+  {
+    srcml_reader reader(arguments[0]);
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {}
+  }
+  const double parse_seconds = parse_timer.seconds();
+
+  std::size_t nodes = 0;
+  std::uint64_t sequential_hash = 0;
+  bench_timer sequential_timer;
+  {
+    srcml_reader reader(arguments[0]);
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+      sequential_hash += analyze(*itr, rounds);
+      ++nodes;
+    }
+  }
+  const double sequential_seconds = sequential_timer.seconds();
+
+  std::uint64_t pipelined_hash = 0;
+  bench_timer pipelined_timer;
+  {
+    srcml_pipelined_reader reader(arguments[0], srcml_reader::srcml_backend::TEXT_READER, batch_size, batches);
+    for(srcml_pipelined_reader::srcml_pipelined_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+      pipelined_hash += analyze(*itr, rounds);
+    }
+  }
+  const double pipelined_seconds = pipelined_timer.seconds();
+
+  if(sequential_hash != pipelined_hash) throw std::runtime_error("pipelined nodes differ");
+
+  const double analyze_seconds = std::max(sequential_seconds - parse_seconds, 0.0);
+
+  bench_report report("pipelined_read");
+  report.add("nodes", nodes);
+  report.add("rounds", rounds);
+  report.add("batch_size", batch_size);
+  report.add("batches", batches);
+  report.add("parse_seconds", parse_seconds);
+  report.add("sequential_seconds", sequential_seconds);
+  report.add("pipelined_seconds", pipelined_seconds);
+  report.add("ideal_seconds", std::max(parse_seconds, analyze_seconds));
+  report.add("speedup", sequential_seconds / pipelined_seconds);
+  report.add("peak_rss", srcreader_bench::peak_rss());
+  report.print();
+
+  return 0;
+}
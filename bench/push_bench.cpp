@@ -0,0 +1,95 @@
+/*
+  push_bench.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_bench.hpp>
+
+#include <srcml_reader.hpp>
+
+#include <stdexcept>
+#include <string>
+
+/** everything about two nodes an application can see */
+static bool same_node(const srcml_node & text_node, const srcml_node & push_node) {
+
+  if(text_node != push_node || text_node.ns != push_node.ns || text_node.empty != push_node.empty
+     || text_node.extra != push_node.extra || text_node.attributes != push_node.attributes) return false;
+
+  return text_node.ns_definition == push_node.ns_definition;
+}
+
+/**
+ * push_parser
+ *
+ * Time to read every event of a file with the xmlTextReader backend and
+ * with the SAX2 push parser backend, then read both in lockstep and
+ * check that they report the same events with the same element paths.
+ */
+SRCREADER_BENCH(push_parser, "<srcml file>") {
+
+  if(arguments.size() != 1) throw std::invalid_argument("expected a srcML file");
+
+  bench_timer text_timer;
+  std::size_t text_events = 0;
+  {
+    srcml_reader reader(arguments[0], srcml_reader::srcml_backend::TEXT_READER);
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+      ++text_events;
+    }
+  }
+  double text_seconds = text_timer.seconds();
+
+  bench_timer push_timer;
+  std::size_t push_events = 0;
+  {
+    srcml_reader reader(arguments[0], srcml_reader::srcml_backend::PUSH_PARSER);
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+      ++push_events;
+    }
+  }
+  double push_seconds = push_timer.seconds();
+
+  srcml_reader text_reader(arguments[0], srcml_reader::srcml_backend::TEXT_READER);
+  srcml_reader push_reader(arguments[0], srcml_reader::srcml_backend::PUSH_PARSER);
+  srcml_reader::srcml_reader_iterator text_itr = text_reader.begin();
+  srcml_reader::srcml_reader_iterator push_itr = push_reader.begin();
+  std::size_t compared = 0;
+  for(; text_itr != text_reader.end(); ++text_itr, ++push_itr, ++compared) {
+
+    if(!(push_itr != push_reader.end()) || !same_node(*text_itr, *push_itr)
+       || text_reader.get_element_path().depth() != push_reader.get_element_path().depth())
+      throw std::runtime_error("backends differ at event " + std::to_string(compared));
+
+  }
+  if(push_itr != push_reader.end()) throw std::runtime_error("push parser reports extra events");
+
+  bench_report report("push_parser");
+  report.add("events", compared);
+  report.add("text_reader_events", text_events);
+  report.add("text_reader_seconds", text_seconds);
+  report.add("push_parser_events", push_events);
+  report.add("push_parser_seconds", push_seconds);
+  report.add("speedup", text_seconds / push_seconds);
+  report.print();
+
+  return 0;
+}
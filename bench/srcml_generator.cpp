@@ -0,0 +1,231 @@
+/*
+  srcml_generator.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_generator.hpp>
+
+#include <stdexcept>
+#include <cmath>
+
+static const char * const ELEMENTS[] = {
+  "function", "block", "block_content", "expr_stmt", "expr", "name", "operator", "call", "argument_list",
+  "argument", "decl_stmt", "decl", "type", "init", "if_stmt", "if", "condition", "return", "literal",
+  "specifier", "parameter_list", "parameter", "comment", "cpp:include", "cpp:file"
+};
+
+static const char * const EMPTY_ELEMENTS[] = { "empty_stmt", "parameter_list", "argument_list", "specifier" };
+
+static const char * const ATTRIBUTES[] = { "type", "pos:start", "pos:end", "ref" };
+
+static const char * const TYPES[] = { "generic", "operator", "pointer", "block", "line", "prev" };
+
+static const char * const TOKENS[] = {
+  "x", "y", "count", "value", "index", "result", "std", "::", "size_t", "int", "return", "0", "1", "42",
+  "=", "+", "-", "*", "(", ")", ";", ",", "&lt;", "&gt;", "&amp;", "&amp;&amp;", "\"text\""
+};
+
+template<class type, std::size_t size>
+static std::size_t count(type (&)[size]) {
+  return size;
+}
+
+srcml_generator::srcml_generator_options::srcml_generator_options()
+  : size(16 * 1024 * 1024), units(100), depth(12), attribute_density(0.5), text_ratio(0.4), seed(1) {}
+
+/**
+ * set
+ * @param option one of size=<megabytes>, units=<count>, depth=<levels>,
+ * attributes=<per start tag>, text=<fraction> or seed=<number>
+ */
+void srcml_generator::srcml_generator_options::set(const std::string & option) {
+
+  std::string::size_type equals = option.find('=');
+  if(equals == std::string::npos) throw std::invalid_argument("expected <option>=<value>: " + option);
+
+  const std::string key = option.substr(0, equals);
+  const std::string value = option.substr(equals + 1);
+
+  if(key == "size")            size = std::size_t(std::stod(value) * 1024 * 1024);
+  else if(key == "units")      units = std::stoull(value);
+  else if(key == "depth")      depth = std::stoull(value);
+  else if(key == "attributes") attribute_density = std::stod(value);
+  else if(key == "text")       text_ratio = std::stod(value);
+  else if(key == "seed")       seed = std::stoull(value);
+  else throw std::invalid_argument("unknown option: " + key);
+
+  if(!units) throw std::invalid_argument("units must be positive");
+  if(attribute_density < 0 || attribute_density > count(ATTRIBUTES)) throw std::invalid_argument("attributes must be from 0 to 4");
+  if(text_ratio < 0 || text_ratio > 1) throw std::invalid_argument("text must be from 0 to 1");
+
+}
+
+srcml_generator::srcml_generator(const srcml_generator_options & options)
+  : options(options), state(options.seed), text_bytes(0), line(1) {}
+
+/** splitmix64, which accepts any seed */
+std::uint64_t srcml_generator::random() {
+
+  std::uint64_t value = (state += 0x9e3779b97f4a7c15ull);
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+  return value ^ (value >> 31);
+}
+
+std::size_t srcml_generator::random(std::size_t bound) {
+  return bound ? std::size_t(random() % bound) : 0;
+}
+
+double srcml_generator::uniform() {
+  return (random() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * generate
+ *
+ * The archive, with the options' size split evenly among its units.
+ */
+std::string srcml_generator::generate() {
+
+  state = options.seed;
+  text_bytes = 0;
+  line = 1;
+
+  std::string out;
+  out.reserve(options.size + options.size / 8);
+
+  out += "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+         "<unit xmlns=\"http://www.srcML.org/srcML/src\" xmlns:cpp=\"http://www.srcML.org/srcML/cpp\""
+         " xmlns:pos=\"http://www.srcML.org/srcML/position\" revision=\"1.0.0\">\n\n";
+
+  const std::size_t start = out.size();
+  for(std::size_t unit_number = 0; unit_number < options.units; ++unit_number) {
+    write_unit(out, unit_number, start + (unit_number + 1) * options.size / options.units);
+  }
+
+  out += "</unit>\n";
+  return out;
+}
+
+void srcml_generator::write_unit(std::string & out, std::size_t unit_number, std::size_t end) {
+
+  line = 1;
+  out += "<unit revision=\"1.0.0\" language=\"C++\" filename=\"unit" + std::to_string(unit_number) + ".cpp\">";
+  write_content(out, 0, end);
+  out += "</unit>\n\n";
+
+}
+
+/**
+ * write_content
+ *
+ * Text and elements until the output reaches end.  Text is chosen while
+ * the archive has less than its share of text, and always at the
+ * deepest level.  Each element takes a random part of what is left, so
+ * the first children of an element are the largest.
+ */
+void srcml_generator::write_content(std::string & out, std::size_t level, std::size_t end) {
+
+  while(out.size() < end) {
+
+    if(level >= options.depth || text_bytes < options.text_ratio * out.size()) {
+      if(level >= options.depth && options.text_ratio == 0) return;
+      write_text(out, level);
+      continue;
+    }
+
+    const std::size_t remaining = end - out.size();
+    if(remaining < 32 || (level + 1 >= options.depth && options.text_ratio == 0)) {
+      out += '<';
+      write_start_tag(out, EMPTY_ELEMENTS[random(count(EMPTY_ELEMENTS))]);
+      out += "/>";
+      continue;
+    }
+
+    const char * name = ELEMENTS[random(count(ELEMENTS))];
+    out += '<';
+    write_start_tag(out, name);
+    out += '>';
+
+    write_content(out, level + 1, out.size() + 1 + random(remaining));
+
+    out += "</";
+    out += name;
+    out += '>';
+
+  }
+
+}
+
+/**
+ * write_start_tag
+ *
+ * The name and attributes of a start tag.  Attributes are consecutive
+ * entries of ATTRIBUTES, so they are never repeated.
+ */
+void srcml_generator::write_start_tag(std::string & out, const char * name) {
+
+  out += name;
+
+  std::size_t attributes = std::size_t(options.attribute_density);
+  if(uniform() < options.attribute_density - std::floor(options.attribute_density)) ++attributes;
+
+  const std::size_t first = random(count(ATTRIBUTES));
+  for(std::size_t i = 0; i < attributes; ++i) {
+
+    const char * attribute = ATTRIBUTES[(first + i) % count(ATTRIBUTES)];
+    out += ' ';
+    out += attribute;
+    out += "=\"";
+    if(attribute[0] == 'p')      out += std::to_string(line) + ':' + std::to_string(1 + random(80));
+    else if(attribute[0] == 't') out += TYPES[random(count(TYPES))];
+    else                         out += "x" + std::to_string(random(1000));
+    out += '"';
+
+  }
+
+}
+
+/**
+ * write_text
+ *
+ * A run of tokens, each after a space, sometimes starting a new,
+ * indented line.
+ */
+void srcml_generator::write_text(std::string & out, std::size_t level) {
+
+  const std::size_t before = out.size();
+
+  if(random(4) == 0) {
+    out += '\n';
+    out.append(4 * level, ' ');
+    ++line;
+  }
+
+  const std::size_t tokens = 1 + random(6);
+  for(std::size_t i = 0; i < tokens; ++i) {
+    out += ' ';
+    out += TOKENS[random(count(TOKENS))];
+  }
+
+  text_bytes += out.size() - before;
+
+}
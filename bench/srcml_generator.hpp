@@ -0,0 +1,90 @@
+/*
+  srcml_generator.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_GENERATOR_HPP
+#define INCLUDED_SRCML_GENERATOR_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * srcml_generator
+ *
+ * Generates a synthetic srcML archive from a seed.  Units are trees of
+ * srcML element names, with attributes and runs of escaped source text,
+ * shaped by the options.  Random numbers come from a fixed xorshift
+ * generator rather than <random>, whose distributions differ between
+ * standard libraries, so a seed gives the same archive everywhere.
+ */
+class srcml_generator {
+
+public:
+
+  class srcml_generator_options {
+
+  public:
+
+    /** approximate size of the archive in bytes */
+    std::size_t size;
+    std::size_t units;
+    /** maximum element nesting within a unit */
+    std::size_t depth;
+    /** mean number of attributes per start tag, at most 4 */
+    double attribute_density;
+    /** approximate fraction of the archive that is text */
+    double text_ratio;
+    std::uint64_t seed;
+
+    srcml_generator_options();
+
+    void set(const std::string & option);
+
+  };
+
+private:
+
+  srcml_generator_options options;
+  std::uint64_t state;
+  std::size_t text_bytes;
+  std::size_t line;
+
+  std::uint64_t random();
+  std::size_t random(std::size_t bound);
+  double uniform();
+
+  void write_unit(std::string & out, std::size_t unit_number, std::size_t end);
+  void write_content(std::string & out, std::size_t level, std::size_t end);
+  void write_start_tag(std::string & out, const char * name);
+  void write_text(std::string & out, std::size_t level);
+
+public:
+
+  srcml_generator(const srcml_generator_options & options);
+
+  std::string generate();
+
+};
+
+#endif
@@ -0,0 +1,136 @@
+/*
+  srcreader_bench.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_bench.hpp>
+#include <allocation_counter.hpp>
+
+#include <iostream>
+#include <sstream>
+#include <map>
+#include <exception>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+typedef std::map<std::string, std::pair<std::string, srcreader_bench::bench_function>> bench_map;
+
+static bench_map & benchmarks() {
+  static bench_map registered;
+  return registered;
+}
+
+srcreader_bench::srcreader_bench(const std::string & name, const std::string & usage, bench_function function) {
+  benchmarks().emplace(name, std::make_pair(usage, function));
+}
+
+std::size_t srcreader_bench::allocations() {
+  return allocation_count.load(std::memory_order_relaxed);
+}
+
+std::size_t srcreader_bench::peak_rss() {
+
+#ifdef _WIN32
+  return 0;
+#else
+  struct rusage usage;
+  if(getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+  return std::size_t(usage.ru_maxrss);
+#else
+  return std::size_t(usage.ru_maxrss) * 1024;
+#endif
+#endif
+
+}
+
+int srcreader_bench::run(int argc, char * argv[]) {
+
+  if(argc < 2 || benchmarks().find(argv[1]) == benchmarks().end()) {
+    std::cerr << "usage: " << argv[0] << " <benchmark> [arguments]\n\n";
+    for(const bench_map::value_type & bench : benchmarks()) {
+      std::cerr << "  " << bench.first << ' ' << bench.second.first << '\n';
+    }
+    return 1;
+  }
+
+  std::vector<std::string> arguments(argv + 2, argv + argc);
+  try {
+    return benchmarks()[argv[1]].second(arguments);
+  } catch(const std::exception & error) {
+    std::cerr << argv[1] << ": " << error.what() << '\n';
+    return 1;
+  }
+
+}
+
+bench_report::bench_report(const std::string & name) : name(name), fields() {
+  add("build_type", SRCREADER_BENCH_BUILD_TYPE);
+}
+
+static std::string quote(const std::string & str) {
+
+  std::string quoted = "\"";
+  for(char ch : str) {
+    if(ch == '"' || ch == '\\') quoted += '\\';
+    quoted += ch;
+  }
+  quoted += '"';
+  return quoted;
+}
+
+void bench_report::add(const std::string & key, const std::string & value) {
+  fields.emplace_back(key, quote(value));
+}
+
+void bench_report::add(const std::string & key, const char * value) {
+  add(key, std::string(value));
+}
+
+void bench_report::add(const std::string & key, double value) {
+  std::ostringstream out;
+  out << value;
+  fields.emplace_back(key, out.str());
+}
+
+void bench_report::add(const std::string & key, std::size_t value) {
+  fields.emplace_back(key, std::to_string(value));
+}
+
+void bench_report::add_json(const std::string & key, const std::string & value) {
+  fields.emplace_back(key, value);
+}
+
+void bench_report::print() const {
+
+  std::cout << "{\"benchmark\":" << quote(name);
+  for(const std::pair<std::string, std::string> & field : fields) {
+    std::cout << ',' << quote(field.first) << ':' << field.second;
+  }
+  std::cout << "}\n";
+
+}
+
+int main(int argc, char * argv[]) {
+  return srcreader_bench::run(argc, argv);
+}
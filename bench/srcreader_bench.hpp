@@ -0,0 +1,112 @@
+/*
+  srcreader_bench.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCREADER_BENCH_HPP
+#define INCLUDED_SRCREADER_BENCH_HPP
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <chrono>
+#include <functional>
+
+/**
+ * srcreader_bench
+ *
+ * Registry of benchmarks run by the srcreader_bench driver.  Each
+ * benchmark is a subcommand receiving the remaining arguments.
+ */
+class srcreader_bench {
+
+public:
+
+  typedef std::function<int (const std::vector<std::string> & arguments)> bench_function;
+
+  srcreader_bench(const std::string & name, const std::string & usage, bench_function function);
+
+  static int run(int argc, char * argv[]);
+
+  /** number of heap allocations made by the process so far */
+  static std::size_t allocations();
+
+  /** largest resident set of the process so far in bytes, or 0 if unknown */
+  static std::size_t peak_rss();
+
+};
+
+/**
+ * bench_report
+ *
+ * Collects the results of one benchmark and prints them as a single
+ * line of JSON.  The first field is the CMake build type.
+ */
+class bench_report {
+
+private:
+
+  std::string name;
+  std::vector<std::pair<std::string, std::string>> fields;
+
+public:
+
+  bench_report(const std::string & name);
+
+  void add(const std::string & key, const std::string & value);
+  void add(const std::string & key, const char * value);
+  void add(const std::string & key, double value);
+  void add(const std::string & key, std::size_t value);
+  /** a value that is already JSON, e.g., srcml_stats::to_json() */
+  void add_json(const std::string & key, const std::string & value);
+
+  void print() const;
+
+};
+
+/**
+ * bench_timer
+ *
+ * Wall clock seconds since construction.
+ */
+class bench_timer {
+
+private:
+
+  std::chrono::steady_clock::time_point start;
+
+public:
+
+  bench_timer() : start(std::chrono::steady_clock::now()) {}
+
+  double seconds() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+};
+
+#define SRCREADER_BENCH(NAME, USAGE) \
+  static int NAME##_bench(const std::vector<std::string> & arguments); \
+  static srcreader_bench NAME##_registration(#NAME, USAGE, NAME##_bench); \
+  static int NAME##_bench(const std::vector<std::string> & arguments)
+
+#endif
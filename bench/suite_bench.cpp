@@ -0,0 +1,293 @@
+/*
+  suite_bench.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_bench.hpp>
+#include <srcml_generator.hpp>
+
+#include <srcml_reader.hpp>
+#include <srcml_writer.hpp>
+#include <srcml_pass_through_writer.hpp>
+#include <srcml_input.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static const double MEGABYTE = 1024 * 1024;
+
+static srcml_reader::srcml_backend backend(const std::string & name) {
+
+  if(name == "text") return srcml_reader::srcml_backend::TEXT_READER;
+  if(name == "push") return srcml_reader::srcml_backend::PUSH_PARSER;
+  if(name == "tokenizer") return srcml_reader::srcml_backend::TOKENIZER;
+  throw std::invalid_argument("unknown backend: " + name);
+}
+
+static std::size_t file_size(const std::string & filename) {
+
+  std::ifstream in(filename, std::ios::binary | std::ios::ate);
+  if(!in) throw std::runtime_error("unable to open: " + filename);
+  return std::size_t(in.tellg());
+}
+
+/**
+ * Fields common to the suite: throughput in nodes and megabytes, heap
+ * allocations per node and the peak resident set of the process.
+ */
+static void add_throughput(bench_report & report, std::size_t nodes, std::size_t bytes, double seconds, std::size_t allocations) {
+
+  report.add("nodes", nodes);
+  report.add("bytes", bytes);
+  report.add("seconds", seconds);
+  report.add("nodes_per_second", nodes / seconds);
+  report.add("mb_per_second", bytes / MEGABYTE / seconds);
+  report.add("allocations_per_node", nodes ? double(allocations) / nodes : 0.0);
+  report.add("peak_rss", srcreader_bench::peak_rss());
+
+}
+
+/**
+ * generate
+ *
+ * Writes a synthetic archive from srcml_generator, e.g.,
+ *   generate corpus.xml size=64 units=500 depth=16 attributes=1 text=0.3 seed=7
+ */
+SRCREADER_BENCH(generate, "<output file> [size=<megabytes>] [units=<count>] [depth=<levels>] [attributes=<per tag>] [text=<fraction>] [seed=<number>]") {
+
+  if(arguments.empty()) throw std::invalid_argument("expected an output file");
+
+  srcml_generator::srcml_generator_options options;
+  for(std::size_t i = 1; i < arguments.size(); ++i) {
+    options.set(arguments[i]);
+  }
+
+  bench_timer timer;
+  const std::string archive = srcml_generator(options).generate();
+
+  std::ofstream out(arguments[0], std::ios::binary);
+  out.write(archive.data(), archive.size());
+  if(!out) throw std::runtime_error("unable to write: " + arguments[0]);
+
+  bench_report report("generate");
+  report.add("file", arguments[0]);
+  report.add("bytes", archive.size());
+  report.add("units", options.units);
+  report.add("depth", options.depth);
+  report.add("attributes", options.attribute_density);
+  report.add("text", options.text_ratio);
+  report.add("seed", std::size_t(options.seed));
+  report.add("seconds", timer.seconds());
+  report.print();
+
+  return 0;
+}
+
+/**
+ * reader_scan
+ *
+ * Reads every node of a document, touching its name, attributes and
+ * text, with the given backend.  With SRCREADER_STATS the reader's
+ * statistics are included.
+ */
+SRCREADER_BENCH(reader_scan, "<srcml file> [text|push|tokenizer]") {
+
+  if(arguments.empty() || arguments.size() > 2) throw std::invalid_argument("expected a srcML file and an optional backend");
+
+  const srcml_reader::srcml_backend reader_backend = backend(arguments.size() == 2 ? arguments[1] : "text");
+
+  std::size_t nodes = 0;
+  std::size_t attributes = 0;
+  std::size_t text_bytes = 0;
+  srcml_stats stats;
+  const std::size_t allocations = srcreader_bench::allocations();
+  bench_timer timer;
+  {
+    srcml_reader reader(arguments[0], reader_backend);
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+      ++nodes;
+      attributes += itr->attributes.size();
+      if(itr->is_text()) text_bytes += itr->content.size();
+    }
+    stats = reader.get_stats();
+  }
+  const double seconds = timer.seconds();
+
+  bench_report report("reader_scan");
+  report.add("backend", arguments.size() == 2 ? arguments[1] : "text");
+  add_throughput(report, nodes, file_size(arguments[0]), seconds, srcreader_bench::allocations() - allocations);
+  report.add("attributes", attributes);
+  report.add("text_bytes", text_bytes);
+  if(srcml_stats::enabled) report.add_json("reader_stats", stats.to_json());
+  report.print();
+
+  return 0;
+}
+
+/**
+ * writer_emit
+ *
+ * Writes the nodes of a document, read into memory beforehand, with
+ * srcml_writer.  Throughput is of the output.
+ */
+SRCREADER_BENCH(writer_emit, "<srcml file> <output file>") {
+
+  if(arguments.size() != 2) throw std::invalid_argument("expected a srcML file and an output file");
+
+  std::vector<srcml_node> nodes;
+  {
+    srcml_reader reader(arguments[0]);
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end();) {
+      nodes.push_back(itr++);
+    }
+  }
+
+  const std::size_t allocations = srcreader_bench::allocations();
+  bench_timer timer;
+  {
+    srcml_writer writer(arguments[1]);
+    for(const srcml_node & node : nodes) {
+      writer.write(node);
+    }
+  }
+  const double seconds = timer.seconds();
+
+  bench_report report("writer_emit");
+  add_throughput(report, nodes.size(), file_size(arguments[1]), seconds, srcreader_bench::allocations() - allocations);
+  report.print();
+
+  return 0;
+}
+
+/**
+ * round_trip
+ *
+ * Reads a document and writes each node as it is read, with text split
+ * into runs or not.  Throughput is of the input.  With SRCREADER_STATS
+ * the reader's and writer's statistics are included.
+ */
+SRCREADER_BENCH(round_trip, "<srcml file> <output file> [text|push|tokenizer] [split|unsplit]") {
+
+  if(arguments.size() < 2 || arguments.size() > 4) throw std::invalid_argument("expected a srcML file, an output file, an optional backend and text splitting");
+
+  const srcml_reader::srcml_backend reader_backend = backend(arguments.size() > 2 ? arguments[2] : "text");
+  const std::string split = arguments.size() > 3 ? arguments[3] : "split";
+  if(split != "split" && split != "unsplit") throw std::invalid_argument("unknown text splitting: " + split);
+
+  std::size_t nodes = 0;
+  srcml_stats reader_stats;
+  srcml_stats writer_stats;
+  const std::size_t allocations = srcreader_bench::allocations();
+  bench_timer timer;
+  {
+    srcml_reader reader(arguments[0], reader_backend);
+    reader.set_split_text(split == "split");
+    srcml_writer writer(arguments[1]);
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+      writer.write(*itr);
+      ++nodes;
+    }
+    reader_stats = reader.get_stats();
+    writer_stats = writer.get_stats();
+  }
+  const double seconds = timer.seconds();
+
+  bench_report report("round_trip");
+  report.add("backend", arguments.size() > 2 ? arguments[2] : "text");
+  report.add("split", split);
+  add_throughput(report, nodes, file_size(arguments[0]), seconds, srcreader_bench::allocations() - allocations);
+  report.add("output_bytes", file_size(arguments[1]));
+  if(srcml_stats::enabled) {
+    report.add_json("reader_stats", reader_stats.to_json());
+    report.add_json("writer_stats", writer_stats.to_json());
+  }
+  report.print();
+
+  return 0;
+}
+
+/**
+ * pass_through
+ *
+ * round_trip with srcml_pass_through_writer, marking one unit in every
+ * modify_every as modified, none by default.  copy_seconds is the time
+ * to write the input as it is, the floor for an unmodified archive.
+ */
+SRCREADER_BENCH(pass_through, "<srcml file> <output file> [text|push|tokenizer] [modify every nth unit]") {
+
+  if(arguments.size() < 2 || arguments.size() > 4) throw std::invalid_argument("expected a srcML file, an output file, an optional backend and unit interval");
+
+  const srcml_reader::srcml_backend reader_backend = backend(arguments.size() > 2 ? arguments[2] : "text");
+  const std::size_t modify_every = arguments.size() > 3 ? std::stoull(arguments[3]) : 0;
+
+  bench_timer copy_timer;
+  {
+    srcml_mapped_input input(arguments[0]);
+    std::ofstream out(arguments[1], std::ios::out | std::ios::binary | std::ios::trunc);
+    out.write(input.data(), input.size());
+  }
+  const double copy_seconds = copy_timer.seconds();
+
+  std::size_t nodes = 0;
+  std::size_t modified_units = 0;
+  const std::size_t allocations = srcreader_bench::allocations();
+  bench_timer timer;
+  {
+    srcml_reader reader(std::unique_ptr<srcml_input>(new srcml_mapped_input(arguments[0])), reader_backend);
+    reader.track_units();
+    srcml_pass_through_writer writer(arguments[1], reader);
+    std::size_t last_unit = srcml_reader::npos;
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+
+      const std::size_t unit = reader.get_unit_number();
+      if(modify_every && unit != last_unit && unit != srcml_reader::npos && unit % modify_every == 0) {
+        reader.mark_unit_modified();
+        ++modified_units;
+      }
+      last_unit = unit;
+
+      writer.write(itr);
+      ++nodes;
+    }
+  }
+  const double seconds = timer.seconds();
+
+  std::ifstream in(arguments[0], std::ios::binary);
+  std::ifstream out(arguments[1], std::ios::binary);
+  const bool identical = std::equal(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>(),
+                                    std::istreambuf_iterator<char>(out), std::istreambuf_iterator<char>());
+
+  bench_report report("pass_through");
+  report.add("backend", arguments.size() > 2 ? arguments[2] : "text");
+  add_throughput(report, nodes, file_size(arguments[0]), seconds, srcreader_bench::allocations() - allocations);
+  report.add("modified_units", modified_units);
+  report.add("output_bytes", file_size(arguments[1]));
+  report.add("identical", identical ? "true" : "false");
+  report.add("copy_seconds", copy_seconds);
+  report.print();
+
+  return 0;
+}
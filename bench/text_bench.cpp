@@ -0,0 +1,221 @@
+/*
+  text_bench.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_bench.hpp>
+
+#include <srcml_reader.hpp>
+#include <srcml_text_run.hpp>
+
+#include <string>
+#include <cctype>
+#include <algorithm>
+
+/**
+ * text_split
+ *
+ * Heap allocations made while advancing to text events, i.e., the cost
+ * of splitting text into whitespace/non-whitespace runs.  As a baseline,
+ * each run is also copied into a std::string, the owning copy the reader
+ * made for every text event before runs were borrowed.
+ */
+SRCREADER_BENCH(text_split, "<srcml file>") {
+
+  if(arguments.size() != 1) throw std::invalid_argument("expected a srcML file");
+
+  std::size_t text_events = 0;
+  std::size_t text_allocations = 0;
+  std::size_t owning_allocations = 0;
+  std::size_t text_bytes = 0;
+  std::size_t events = 0;
+
+  bench_timer timer;
+  srcml_reader reader(arguments[0]);
+  for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end();) {
+
+    ++events;
+    if(itr->is_text()) text_bytes += itr->content.size();
+
+    std::size_t before = srcreader_bench::allocations();
+    ++itr;
+    if(itr->is_text()) {
+      ++text_events;
+      text_allocations += srcreader_bench::allocations() - before;
+
+      boost::string_view run = itr->content.view();
+      before = srcreader_bench::allocations();
+      std::string owning_copy(run.data(), run.size());
+      owning_allocations += srcreader_bench::allocations() - before;
+    }
+
+  }
+  double seconds = timer.seconds();
+
+  bench_report report("text_split");
+  report.add("events", events);
+  report.add("text_events", text_events);
+  report.add("text_bytes", text_bytes);
+  report.add("text_allocations", text_allocations);
+  report.add("allocations_per_text_event", text_events ? double(text_allocations) / text_events : 0.0);
+  report.add("owning_copy_allocations", owning_allocations);
+  report.add("owning_copy_allocations_per_text_event", text_events ? double(owning_allocations) / text_events : 0.0);
+  report.add("seconds", seconds);
+  report.print();
+
+  return 0;
+}
+
+/**
+ * generate_text
+ * @param comments comment-heavy text if true, otherwise indentation-heavy
+ *
+ * Source-like text without markup characters.  Comment-heavy text is
+ * long lines of words with some UTF-8 and banners; indentation-heavy
+ * text is short tokens under deep space and tab indentation.
+ */
+static std::string generate_text(bool comments, std::size_t size) {
+
+  static const char * const WORDS[] = { "the", "parser", "returns", "caf\xc3\xa9", "if", "nodes", "are", "na\xc3\xafve", "x", "srcML" };
+
+  std::string text;
+  unsigned int seed = 12345;
+  auto random = [&seed](unsigned int limit) { seed = seed * 1103515245u + 12345u; return (seed >> 16) % limit; };
+
+  while(text.size() < size) {
+
+    if(comments) {
+
+      text.append("    ");
+      if(random(8) == 0) {
+        text.append("/*").append(60 + random(16), '*').append("*/");
+      } else {
+        text.append("//");
+        for(unsigned int words = 5 + random(10); words; --words) {
+          text += ' ';
+          text.append(WORDS[random(10)]);
+        }
+      }
+
+    } else {
+
+      if(random(4) == 0) text += '\n';
+      text.append(4 * random(10), ' ').append(random(3), '\t');
+      text.append(random(2) ? "}" : "x;");
+
+    }
+
+    text += '\n';
+
+  }
+
+  return text;
+}
+
+/** runs and lines found with the std::isspace loop srcml_text_run replaces, then rescanning for newlines */
+static std::size_t isspace_runs(const std::string & text, std::size_t & lines) {
+
+  std::size_t runs = 0;
+  for(std::size_t start = 0; start < text.size(); ++runs) {
+
+    bool is_space = std::isspace((unsigned char)text[start]);
+    std::size_t end = start + 1;
+    while(end < text.size() && bool(std::isspace((unsigned char)text[end])) == is_space) {
+      ++end;
+    }
+
+    lines += std::count(text.data() + start, text.data() + end, '\n');
+    start = end;
+
+  }
+
+  return runs;
+}
+
+static std::size_t text_runs(const std::string & text, std::size_t & lines) {
+
+  std::size_t runs = 0;
+  for(std::size_t start = 0; start < text.size(); ++runs) {
+
+    srcml_text_run run(text.data() + start, text.size() - start);
+    lines += run.line_delta;
+    start += run.length;
+
+  }
+
+  return runs;
+}
+
+/**
+ * text_runs
+ *
+ * Splitting comment-heavy and indentation-heavy text into runs and
+ * counting its lines, with the std::isspace loop and a rescan of each
+ * run, then with srcml_text_run.  The text is also read as a srcML
+ * document to time the reader with lines taken from the text nodes'
+ * line_delta.
+ */
+SRCREADER_BENCH(text_runs, "[megabytes]") {
+
+  const std::size_t size = (arguments.empty() ? 8 : std::stoul(arguments[0])) << 20;
+
+  for(bool comments : { true, false }) {
+
+    const std::string text = generate_text(comments, size);
+
+    std::size_t isspace_lines = 0;
+    bench_timer isspace_timer;
+    std::size_t runs = isspace_runs(text, isspace_lines);
+    double isspace_seconds = isspace_timer.seconds();
+
+    std::size_t run_lines = 0;
+    bench_timer run_timer;
+    std::size_t run_count = text_runs(text, run_lines);
+    double run_seconds = run_timer.seconds();
+
+    if(runs != run_count || isspace_lines != run_lines) throw std::runtime_error("srcml_text_run differs from std::isspace");
+
+    const std::string document = "<unit xmlns=\"http://www.srcML.org/srcML/src\"><comment>" + text + "</comment></unit>";
+    std::size_t reader_lines = 0;
+    bench_timer reader_timer;
+    srcml_reader reader(document.data(), document.size(), srcml_reader::srcml_backend::TOKENIZER);
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+      reader_lines += itr->line_delta;
+    }
+    double reader_seconds = reader_timer.seconds();
+
+    if(reader_lines != run_lines) throw std::runtime_error("reader line count differs");
+
+    bench_report report("text_runs");
+    report.add("input", comments ? "comments" : "indentation");
+    report.add("bytes", text.size());
+    report.add("runs", runs);
+    report.add("lines", run_lines);
+    report.add("isspace_seconds", isspace_seconds);
+    report.add("text_run_seconds", run_seconds);
+    report.add("speedup", isspace_seconds / run_seconds);
+    report.add("reader_seconds", reader_seconds);
+    report.print();
+
+  }
+
+  return 0;
+}
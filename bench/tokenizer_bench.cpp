@@ -0,0 +1,102 @@
+/*
+  tokenizer_bench.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_bench.hpp>
+
+#include <srcml_reader.hpp>
+
+#include <stdexcept>
+#include <string>
+
+/** everything about two nodes an application can see */
+static bool same_node(const srcml_node & text_node, const srcml_node & token_node) {
+
+  if(text_node != token_node || text_node.ns != token_node.ns || text_node.empty != token_node.empty
+     || text_node.extra != token_node.extra || text_node.attributes != token_node.attributes) return false;
+
+  return text_node.ns_definition == token_node.ns_definition;
+}
+
+/** seconds to read every event of a file with a backend */
+static double read_seconds(const std::string & filename, srcml_reader::srcml_backend backend, std::size_t & events) {
+
+  bench_timer timer;
+  srcml_reader reader(filename, backend);
+  for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+    ++events;
+  }
+
+  return timer.seconds();
+}
+
+/**
+ * tokenizer
+ *
+ * Differential test and timing of the tokenizer backend over a corpus.
+ * Each file is read in lockstep with the xmlTextReader backend, which
+ * must report the same events with the same element paths, then every
+ * file is timed with each backend.
+ */
+SRCREADER_BENCH(tokenizer, "<srcml file>...") {
+
+  if(arguments.empty()) throw std::invalid_argument("expected srcML files");
+
+  std::size_t compared = 0;
+  for(const std::string & filename : arguments) {
+
+    srcml_reader text_reader(filename, srcml_reader::srcml_backend::TEXT_READER);
+    srcml_reader token_reader(filename, srcml_reader::srcml_backend::TOKENIZER);
+    srcml_reader::srcml_reader_iterator text_itr = text_reader.begin();
+    srcml_reader::srcml_reader_iterator token_itr = token_reader.begin();
+    for(std::size_t event = 0; text_itr != text_reader.end(); ++text_itr, ++token_itr, ++event, ++compared) {
+
+      if(!(token_itr != token_reader.end()) || !same_node(*text_itr, *token_itr)
+         || text_reader.get_element_path().depth() != token_reader.get_element_path().depth())
+        throw std::runtime_error(filename + ": backends differ at event " + std::to_string(event));
+
+    }
+    if(token_itr != token_reader.end()) throw std::runtime_error(filename + ": tokenizer reports extra events");
+
+  }
+
+  std::size_t text_events = 0, push_events = 0, token_events = 0;
+  double text_seconds = 0, push_seconds = 0, token_seconds = 0;
+  for(const std::string & filename : arguments) {
+    text_seconds += read_seconds(filename, srcml_reader::srcml_backend::TEXT_READER, text_events);
+    push_seconds += read_seconds(filename, srcml_reader::srcml_backend::PUSH_PARSER, push_events);
+    token_seconds += read_seconds(filename, srcml_reader::srcml_backend::TOKENIZER, token_events);
+  }
+
+  bench_report report("tokenizer");
+  report.add("files", arguments.size());
+  report.add("events", compared);
+  report.add("text_reader_seconds", text_seconds);
+  report.add("push_parser_seconds", push_seconds);
+  report.add("tokenizer_events", token_events);
+  report.add("tokenizer_seconds", token_seconds);
+  report.add("speedup", text_seconds / token_seconds);
+  report.add("push_speedup", push_seconds / token_seconds);
+  report.print();
+
+  return 0;
+}
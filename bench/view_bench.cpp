@@ -0,0 +1,81 @@
+/*
+  view_bench.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_bench.hpp>
+
+#include <srcml_reader.hpp>
+
+#include <stdexcept>
+#include <string>
+
+/**
+ * node_view
+ *
+ * A read-only consumer, counting the elements named by the second
+ * argument and the bytes of text, once through the iterator, which
+ * builds every node, and once through srcml_node_view.
+ */
+SRCREADER_BENCH(node_view, "<srcml file> [element]") {
+
+  if(arguments.empty() || arguments.size() > 2) throw std::invalid_argument("expected a srcML file and an optional element");
+
+  const std::string element = arguments.size() == 2 ? arguments[1] : "name";
+  const srcml_symbol element_symbol(element);
+
+  std::size_t node_elements = 0;
+  std::size_t node_text = 0;
+  bench_timer node_timer;
+  {
+    srcml_reader reader(arguments[0]);
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+      if(itr->is_start() && itr->name == element_symbol) ++node_elements;
+      else if(itr->is_text()) node_text += itr->content.size();
+    }
+  }
+  double node_seconds = node_timer.seconds();
+
+  std::size_t view_elements = 0;
+  std::size_t view_text = 0;
+  bench_timer view_timer;
+  {
+    srcml_reader reader(arguments[0]);
+    while(reader.next()) {
+      const srcml_node_view & view = reader.get_current_view();
+      if(view.is_start() && view.name() == element) ++view_elements;
+      else if(view.is_text()) view_text += view.content().size();
+    }
+  }
+  double view_seconds = view_timer.seconds();
+
+  if(node_elements != view_elements || node_text != view_text) throw std::runtime_error("views differ from nodes");
+
+  bench_report report("node_view");
+  report.add("elements", view_elements);
+  report.add("text_bytes", view_text);
+  report.add("node_seconds", node_seconds);
+  report.add("view_seconds", view_seconds);
+  report.add("speedup", node_seconds / view_seconds);
+  report.print();
+
+  return 0;
+}
@@ -0,0 +1,179 @@
+/*
+  srcml_async_writer.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_async_writer.hpp>
+#include <srcml_back_off.hpp>
+
+#include <algorithm>
+
+const std::size_t srcml_async_writer::DEFAULT_BATCH_SIZE;
+const std::size_t srcml_async_writer::DEFAULT_BATCHES;
+
+/**
+ * srcml_async_writer
+ * @param filename file to write the srcML to
+ * @param batch_size nodes handed over at a time
+ * @param batches batches in flight, which bounds memory
+ *
+ * The file is opened here, so an error opening it is thrown by the
+ * constructor.
+ */
+srcml_async_writer::srcml_async_writer(const std::string & filename, std::size_t batch_size, std::size_t batches)
+  : writer(new srcml_writer(filename)), batch_size(std::max<std::size_t>(batch_size, 1)), batch_pool(),
+    full(std::max<std::size_t>(batches, 1)), empty(std::max<std::size_t>(batches, 1)), batch(nullptr),
+    submitted(0), completed(0), failed(false), error(), stop(false), consumer() {
+
+  start(std::max<std::size_t>(batches, 1));
+
+}
+
+/**
+ * ~srcml_async_writer
+ *
+ * Writes what is left and closes the output.  Errors are not reported
+ * here; call flush() first to see them.
+ */
+srcml_async_writer::~srcml_async_writer() {
+
+  try {
+    flush();
+  } catch(...) {}
+
+  stop = true;
+  if(consumer.joinable()) consumer.join();
+
+}
+
+void srcml_async_writer::start(std::size_t batch_count) {
+
+  for(std::size_t i = 0; i < batch_count; ++i) {
+    batch_pool.emplace_back(new srcml_batch());
+    empty.push(batch_pool.back().get());
+  }
+
+  consumer = std::thread(&srcml_async_writer::consume, this);
+
+}
+
+/**
+ * consume
+ *
+ * Body of the writer thread.  Writes each batch in order and returns
+ * it.  After an error, batches are returned without being written.
+ */
+void srcml_async_writer::consume() {
+
+  while(true) {
+
+    srcml_batch * current = nullptr;
+    srcml_back_off back_off;
+    while(!full.pop(current)) {
+      if(stop && !full.read_available()) return;
+      back_off.wait();
+    }
+
+    if(!failed) {
+
+      try {
+        for(std::size_t i = 0; i < current->size; ++i) {
+          writer->write(current->nodes[i]);
+        }
+      } catch(...) {
+        error = std::current_exception();
+        failed = true;
+      }
+
+    }
+
+    empty.push(current);
+    ++completed;
+
+  }
+
+}
+
+void srcml_async_writer::check_error() const {
+  if(failed) std::rethrow_exception(error);
+}
+
+/**
+ * submit
+ *
+ * Hand the current batch to the writer thread.
+ */
+void srcml_async_writer::submit() {
+
+  full.push(batch);
+  batch = nullptr;
+  ++submitted;
+
+}
+
+/**
+ * write
+ * @param node node to write; it is copied, so it may be borrowed
+ *
+ * Queue a node for the writer thread, waiting for a free batch if all
+ * are in flight.
+ */
+bool srcml_async_writer::write(const srcml_node & node) {
+
+  check_error();
+
+  if(!batch) {
+
+    srcml_back_off back_off;
+    while(!empty.pop(batch)) {
+      back_off.wait();
+    }
+    batch->size = 0;
+
+  }
+
+  if(batch->size == batch->nodes.size()) batch->nodes.emplace_back();
+  batch->nodes[batch->size++] = node;
+
+  if(batch->size == batch_size) submit();
+
+  return true;
+}
+
+/**
+ * flush
+ *
+ * Wait until every node written so far has been written by the
+ * srcml_writer, and rethrow its error if it failed.  libsrcml still
+ * buffers a unit until the unit ends.
+ */
+void srcml_async_writer::flush() {
+
+  if(batch && batch->size) submit();
+
+  srcml_back_off back_off;
+  while(completed != submitted) {
+    back_off.wait();
+  }
+
+  check_error();
+
+}
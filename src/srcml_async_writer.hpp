@@ -0,0 +1,114 @@
+/*
+  srcml_async_writer.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_ASYNC_WRITER_HPP
+#define INCLUDED_SRCML_ASYNC_WRITER_HPP
+
+#include <srcml_writer.hpp>
+
+#include <boost/lockfree/spsc_queue.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <exception>
+
+/**
+ * srcml_async_writer
+ *
+ * Runs a srcml_writer on a background thread, so libsrcml's work
+ * overlaps with the caller's.  write() copies each node into a batch.
+ * A full batch is handed to the writer thread through a
+ * single-producer/single-consumer lock-free queue, and comes back
+ * through a second queue once it is written.  A fixed number of batches
+ * are used.  When they are all in flight, write() waits, which bounds
+ * memory to batch_size * batches nodes.
+ *
+ * The nodes reach the srcml_writer in the order they were written, so
+ * the output is the same as writing them synchronously.  If the writer
+ * throws, the error is rethrown by the next write() or flush(), and
+ * later nodes are dropped.
+ */
+class srcml_async_writer {
+
+public:
+
+  static const std::size_t DEFAULT_BATCH_SIZE = 512;
+  static const std::size_t DEFAULT_BATCHES = 8;
+
+private:
+
+  /**
+   * srcml_batch
+   *
+   * The first size nodes are in use.  Nodes are copied into the slots
+   * of earlier rounds, so their storage is reused.
+   */
+  class srcml_batch {
+
+  public:
+
+    std::vector<srcml_node> nodes;
+    std::size_t size;
+
+    srcml_batch() : nodes(), size(0) {}
+
+  };
+
+  std::unique_ptr<srcml_writer> writer;
+  std::size_t batch_size;
+
+  std::vector<std::unique_ptr<srcml_batch>> batch_pool;
+  boost::lockfree::spsc_queue<srcml_batch *> full;
+  boost::lockfree::spsc_queue<srcml_batch *> empty;
+  srcml_batch * batch;
+
+  std::size_t submitted;
+  std::atomic<std::size_t> completed;
+  std::atomic<bool> failed;
+  std::exception_ptr error;
+  std::atomic<bool> stop;
+  std::thread consumer;
+
+  void start(std::size_t batch_count);
+  void consume();
+  void submit();
+  void check_error() const;
+
+public:
+
+  srcml_async_writer(const std::string & filename,
+                     std::size_t batch_size = DEFAULT_BATCH_SIZE, std::size_t batches = DEFAULT_BATCHES);
+  ~srcml_async_writer();
+
+  srcml_async_writer(const srcml_async_writer &) = delete;
+  srcml_async_writer & operator=(const srcml_async_writer &) = delete;
+
+  bool write(const srcml_node & node);
+  void flush();
+
+};
+
+#endif
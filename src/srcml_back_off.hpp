@@ -0,0 +1,62 @@
+/*
+  srcml_back_off.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_BACK_OFF_HPP
+#define INCLUDED_SRCML_BACK_OFF_HPP
+
+#include <thread>
+#include <chrono>
+#include <cstddef>
+
+/**
+ * srcml_back_off
+ *
+ * Waiting on another thread that shares a lock-free queue with this
+ * one, after finding the queue empty or full.  The first waits yield;
+ * if the wait runs long, later ones sleep, so an idle thread does not
+ * hold a core.
+ */
+class srcml_back_off {
+
+private:
+
+  std::size_t attempts;
+
+public:
+
+  srcml_back_off() : attempts(0) {}
+
+  void wait() {
+
+    if(++attempts < 64) {
+      std::this_thread::yield();
+      return;
+    }
+
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+
+  }
+
+};
+
+#endif
@@ -0,0 +1,88 @@
+/*
+  srcml_binary_format.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_BINARY_FORMAT_HPP
+#define INCLUDED_SRCML_BINARY_FORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * srcml_binary_format
+ *
+ * Constants of the binary srcML event format shared by
+ * srcml_binary_writer and srcml_binary_reader.
+ *
+ * A file is the magic bytes and a version followed by records.  Every
+ * integer is an unsigned LEB128 varint.  A record starts with a header
+ * whose low three bits are its kind and whose remaining bits are flags.
+ * Symbols and namespaces are defined by their own records before the
+ * first node that uses them and are referred to by their position in
+ * order of definition; symbol 0 is the empty symbol.
+ *
+ *   symbol:    length, bytes
+ *   namespace: uri length, uri bytes, prefix symbol + 1 or 0
+ *   node:      [!PREVIOUS_NAME] name symbol, namespace + 1 or 0
+ *              [HAS_CONTENT]    length, bytes
+ *              [NS_DEFINITIONS] count, namespaces
+ *              [ATTRIBUTES]     count, per attribute: key symbol, name symbol,
+ *                               namespace + 1 or 0, value length + 1 or 0, value bytes
+ *              [EXTRA]          extra
+ *
+ * Node kinds are the values of srcml_node::srcml_node_type.  Two flags
+ * keep the common cases small: PREVIOUS_NAME reuses the name and
+ * namespace of the previous node of the same kind, which makes text
+ * nodes two bytes plus their text, and MATCHES_START marks an end node
+ * identical to its start node, as libxml2 reports them, which is then
+ * only its header.  A text node flagged SPLIT_TEXT holds consecutive
+ * text runs and is split back into maximal whitespace and
+ * non-whitespace runs on reading, as srcml_reader splits text.
+ */
+class srcml_binary_format {
+
+public:
+
+  static constexpr const char * MAGIC = "SRCMLBIN";
+  static const std::size_t MAGIC_SIZE = 8;
+  static const std::uint32_t VERSION = 1;
+
+  enum srcml_record_kind : unsigned int { SYMBOL = 4, NAMESPACE = 5 };
+
+  static const unsigned int KIND_BITS = 3;
+  static const unsigned int KIND_MASK = (1 << KIND_BITS) - 1;
+  static const unsigned int NODE_KINDS = 4;
+
+  enum srcml_node_flag : unsigned int {
+    EMPTY          = 1 << 0,
+    HAS_CONTENT    = 1 << 1,
+    NS_DEFINITIONS = 1 << 2,
+    ATTRIBUTES     = 1 << 3,
+    EXTRA          = 1 << 4,
+    PREVIOUS_NAME  = 1 << 5,
+    MATCHES_START  = 1 << 6,
+    SPLIT_TEXT     = 1 << 7
+  };
+
+};
+
+#endif
@@ -0,0 +1,395 @@
+/*
+  srcml_binary_reader.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_binary_reader.hpp>
+#include <srcml_text_run.hpp>
+
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+
+class srcml_binary_reader_error : public std::runtime_error {
+public:
+  srcml_binary_reader_error(const std::string & what_arg) : std::runtime_error(what_arg) {}
+
+};
+
+srcml_binary_reader::srcml_binary_reader(const std::string & filename)
+  : input(new srcml_mapped_input(filename)), input_position(nullptr), input_end(nullptr), symbols(), namespaces(),
+    open_starts(), split_data(nullptr), split_size(0), split_offset(0), split_name(), split_ns(), node(), current_node(nullptr), is_eof(false), iterator() {
+
+  start();
+
+}
+
+/**
+ * srcml_binary_reader
+ * @param data binary srcML in memory
+ * @param size length of the data
+ *
+ * The data is not copied and must outlive the reader.
+ */
+srcml_binary_reader::srcml_binary_reader(const char * data, std::size_t size)
+  : input(new srcml_memory_input(data, size)), input_position(nullptr), input_end(nullptr), symbols(), namespaces(),
+    open_starts(), split_data(nullptr), split_size(0), split_offset(0), split_name(), split_ns(), node(), current_node(nullptr), is_eof(false), iterator() {
+
+  start();
+
+}
+
+void srcml_binary_reader::start() {
+
+  input_position = input->data();
+  input_end = input->data() + input->size();
+
+  if(input->size() < srcml_binary_format::MAGIC_SIZE
+     || std::memcmp(input_position, srcml_binary_format::MAGIC, srcml_binary_format::MAGIC_SIZE) != 0)
+    throw srcml_binary_reader_error("Not binary srcML");
+  input_position += srcml_binary_format::MAGIC_SIZE;
+
+  if(read_varint() != srcml_binary_format::VERSION) throw srcml_binary_reader_error("Unsupported binary srcML version");
+
+  symbols.emplace_back();
+  std::fill(previous_names, previous_names + srcml_binary_format::NODE_KINDS, 0);
+  std::fill(previous_namespaces, previous_namespaces + srcml_binary_format::NODE_KINDS, 0);
+
+}
+
+const srcml_element_path & srcml_binary_reader::get_element_path() const {
+  return element_path;
+}
+
+const std::stack<std::string> & srcml_binary_reader::get_element_stack() const {
+  return element_path.to_stack();
+}
+
+std::uint64_t srcml_binary_reader::read_varint() {
+
+  std::uint64_t value = 0;
+  for(int shift = 0; shift < 64; shift += 7) {
+
+    if(input_position == input_end) throw srcml_binary_reader_error("Truncated binary srcML");
+
+    unsigned char byte = *input_position++;
+    value |= std::uint64_t(byte & 0x7f) << shift;
+    if(!(byte & 0x80)) return value;
+
+  }
+
+  throw srcml_binary_reader_error("Corrupt binary srcML");
+}
+
+const char * srcml_binary_reader::read_bytes(std::size_t size) {
+
+  if(size > std::size_t(input_end - input_position)) throw srcml_binary_reader_error("Truncated binary srcML");
+
+  const char * bytes = input_position;
+  input_position += size;
+  return bytes;
+}
+
+srcml_symbol srcml_binary_reader::read_symbol() {
+
+  std::uint64_t number = read_varint();
+  if(number >= symbols.size()) throw srcml_binary_reader_error("Undefined symbol in binary srcML");
+
+  return symbols[number];
+}
+
+std::shared_ptr<srcml_node::srcml_namespace> srcml_binary_reader::read_namespace() {
+
+  std::uint64_t number = read_varint();
+  if(number >= namespaces.size()) throw srcml_binary_reader_error("Undefined namespace in binary srcML");
+
+  return namespaces[number];
+}
+
+/** namespace stored plus one, zero for none */
+std::shared_ptr<srcml_node::srcml_namespace> srcml_binary_reader::get_namespace(std::uint64_t number) const {
+
+  if(number > namespaces.size()) throw srcml_binary_reader_error("Undefined namespace in binary srcML");
+
+  return number ? namespaces[number - 1] : std::shared_ptr<srcml_node::srcml_namespace>();
+}
+
+/** everything after the name and namespace of a node */
+void srcml_binary_reader::read_body(unsigned int flags) {
+
+  node.empty = flags & srcml_binary_format::EMPTY;
+
+  if(flags & srcml_binary_format::HAS_CONTENT) {
+    std::size_t size = read_varint();
+    node.content.borrow(read_bytes(size), size);
+  } else {
+    node.content.reset();
+  }
+
+  if(!node.ns_definition.empty()) node.ns_definition.clear();
+  if(flags & srcml_binary_format::NS_DEFINITIONS) {
+    for(std::uint64_t count = read_varint(); count; --count) {
+      node.ns_definition.push_back(read_namespace());
+    }
+  }
+
+  if(!node.attributes.empty()) node.attributes.clear();
+  if(flags & srcml_binary_format::ATTRIBUTES) {
+    for(std::uint64_t count = read_varint(); count; --count) {
+
+      srcml_symbol key = read_symbol();
+
+      srcml_node::srcml_attribute attribute;
+      attribute.name = read_symbol();
+      attribute.ns = get_namespace(read_varint());
+
+      std::uint64_t value = read_varint();
+      if(value) attribute.value = std::string(read_bytes(value - 1), value - 1);
+
+      node.attributes.emplace(key, attribute);
+
+    }
+  }
+
+  node.extra = flags & srcml_binary_format::EXTRA ? read_varint() : 0;
+
+}
+
+/**
+ * read
+ *
+ * Read definitions up to the next node and decode it into the reused
+ * node.  Text is borrowed from the input.
+ */
+bool srcml_binary_reader::read() {
+  if(is_eof) return false;
+
+  if(split_offset < split_size) {
+    next_text_run();
+    return true;
+  }
+
+  std::uint64_t header = 0;
+  while(true) {
+
+    if(input_position == input_end) {
+      // a stream cut at a record boundary has open elements, or definitions and no node
+      if(!open_starts.empty() || (!current_node && (symbols.size() > 1 || !namespaces.empty())))
+        throw srcml_binary_reader_error("Truncated binary srcML");
+      is_eof = true;
+      node.clear();
+      current_node = &node;
+      return false;
+    }
+
+    header = read_varint();
+    std::uint64_t kind = header & srcml_binary_format::KIND_MASK;
+
+    if(kind == srcml_binary_format::SYMBOL) {
+
+      std::size_t size = read_varint();
+      const char * bytes = read_bytes(size);
+      symbols.emplace_back(bytes, size);
+
+    } else if(kind == srcml_binary_format::NAMESPACE) {
+
+      std::size_t size = read_varint();
+      const char * bytes = read_bytes(size);
+      std::uint64_t prefix = read_varint();
+      if(prefix > symbols.size()) throw srcml_binary_reader_error("Undefined symbol in binary srcML");
+
+      namespaces.push_back(srcml_node::get_namespace(std::string(bytes, size),
+        prefix ? boost::optional<std::string>(symbols[prefix - 1].str()) : boost::optional<std::string>()));
+
+    } else if(kind <= srcml_node::srcml_node_type::TEXT) {
+      break;
+    } else {
+      throw srcml_binary_reader_error("Corrupt binary srcML");
+    }
+
+  }
+
+  unsigned int kind = header & srcml_binary_format::KIND_MASK;
+  unsigned int flags = header >> srcml_binary_format::KIND_BITS;
+  std::uint64_t name = 0;
+  std::uint64_t ns = 0;
+
+  if(kind == srcml_node::srcml_node_type::END && (flags & srcml_binary_format::MATCHES_START)) {
+
+    if(open_starts.empty()) throw srcml_binary_reader_error("Corrupt binary srcML");
+
+    // decode the body of the start node again, in place
+    const srcml_open_start & start = open_starts.back();
+    flags = start.flags;
+    name = start.name;
+    ns = start.ns;
+
+    const char * position = input_position;
+    input_position = start.body;
+    read_body(flags);
+    input_position = position;
+
+  } else {
+
+    if(flags & srcml_binary_format::PREVIOUS_NAME) {
+      name = previous_names[kind];
+      ns = previous_namespaces[kind];
+    } else {
+      name = previous_names[kind] = read_varint();
+      ns = previous_namespaces[kind] = read_varint();
+    }
+
+    if(kind == srcml_node::srcml_node_type::START) open_starts.push_back(srcml_open_start{ flags, name, ns, input_position });
+    read_body(flags);
+
+  }
+
+  if(kind == srcml_node::srcml_node_type::END && !open_starts.empty()) open_starts.pop_back();
+
+  if(name >= symbols.size()) throw srcml_binary_reader_error("Undefined symbol in binary srcML");
+
+  node.type = (srcml_node::srcml_node_type)kind;
+  node.name = symbols[name];
+
+  std::shared_ptr<srcml_node::srcml_namespace> node_ns = get_namespace(ns);
+  if(node.ns != node_ns) node.ns = node_ns;
+
+  if(flags & srcml_binary_format::SPLIT_TEXT) {
+    split_name = node.name;
+    split_ns = std::move(node_ns);
+  }
+
+  if(!node.user_data.empty()) node.user_data = boost::any();
+
+  node.line_delta = 0;
+  node.column_delta = 0;
+  if(node.is_text() && !(flags & srcml_binary_format::SPLIT_TEXT))
+    srcml_text_run::count_lines(node.content.data(), node.content.size(), node.line_delta, node.column_delta);
+
+  current_node = &node;
+
+  if(flags & srcml_binary_format::SPLIT_TEXT) {
+    split_data = node.content.data();
+    split_size = node.content.size();
+    split_offset = 0;
+    next_text_run();
+    return true;
+  }
+
+  if(node.is_start()) {
+    element_path.push(node.qualified_name());
+  } else if(node.is_end()) {
+    element_path.pop();
+  }
+
+  return true;
+}
+
+/**
+ * next_text_run
+ *
+ * Point the node at the next maximal whitespace or non-whitespace run
+ * of the current SPLIT_TEXT record.  The node may have been modified
+ * or moved from since the last run, so every field is set.
+ */
+void srcml_binary_reader::next_text_run() {
+
+  srcml_text_run run(split_data + split_offset, split_size - split_offset);
+
+  node.type = srcml_node::srcml_node_type::TEXT;
+  node.name = split_name;
+  if(node.ns != split_ns) node.ns = split_ns;
+  node.content.borrow(split_data + split_offset, run.length);
+  if(!node.ns_definition.empty()) node.ns_definition.clear();
+  if(!node.attributes.empty()) node.attributes.clear();
+  node.empty = false;
+  node.extra = 0;
+  if(!node.user_data.empty()) node.user_data = boost::any();
+  node.line_delta = run.line_delta;
+  node.column_delta = run.column_delta;
+  current_node = &node;
+
+  split_offset += run.length;
+
+}
+
+srcml_binary_reader::srcml_binary_reader_iterator srcml_binary_reader::begin() {
+
+  if(!iterator.reader) {
+    read();
+    iterator.reader = this;
+  }
+
+  return iterator;
+}
+
+srcml_binary_reader::srcml_binary_reader_iterator srcml_binary_reader::end() {
+  return srcml_binary_reader_iterator();
+}
+
+srcml_binary_reader::operator bool() const {
+  return current_node && !is_eof;
+}
+
+srcml_binary_reader::srcml_binary_reader_iterator::srcml_binary_reader_iterator(srcml_binary_reader * reader)
+  : reader(reader) {}
+
+const srcml_node & srcml_binary_reader::srcml_binary_reader_iterator::operator*() const {
+  return *reader->current_node;
+}
+
+srcml_node & srcml_binary_reader::srcml_binary_reader_iterator::operator*() {
+  return *reader->current_node;
+}
+
+const srcml_node * srcml_binary_reader::srcml_binary_reader_iterator::operator->() const {
+  return reader->current_node;
+}
+
+srcml_node * srcml_binary_reader::srcml_binary_reader_iterator::operator->() {
+  return reader->current_node;
+}
+
+const srcml_node & srcml_binary_reader::srcml_binary_reader_iterator::operator++() {
+
+  reader->read();
+  return *reader->current_node;
+
+}
+
+/**
+ * operator++(int)
+ *
+ * The current node is moved out and its borrowed text made owning, as
+ * for srcml_reader.
+ */
+srcml_node srcml_binary_reader::srcml_binary_reader_iterator::operator++(int) {
+
+  srcml_node node = std::move(*reader->current_node);
+  node.content.own();
+  reader->read();
+  return node;
+
+}
+
+bool srcml_binary_reader::srcml_binary_reader_iterator::operator!=(const srcml_binary_reader_iterator &) const {
+  return *reader;
+}
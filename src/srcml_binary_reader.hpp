@@ -0,0 +1,127 @@
+/*
+  srcml_binary_reader.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_BINARY_READER_HPP
+#define INCLUDED_SRCML_BINARY_READER_HPP
+
+#include <srcml_node.hpp>
+#include <srcml_input.hpp>
+#include <srcml_binary_format.hpp>
+#include <srcml_element_path.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <stack>
+#include <cstdint>
+
+class srcml_binary_reader_error;
+
+/**
+ * srcml_binary_reader
+ *
+ * Reads the binary srcML event format written by srcml_binary_writer.
+ * The interface is that of srcml_reader.  Text is borrowed from the
+ * input, which is memory-mapped when reading a file.
+ */
+class srcml_binary_reader {
+public:
+      class srcml_binary_reader_iterator {
+      private:
+        srcml_binary_reader * reader;
+        srcml_binary_reader_iterator(srcml_binary_reader * reader = nullptr);
+      public:
+        const srcml_node & operator*() const;
+        srcml_node & operator*();
+        const srcml_node * operator->() const;
+        srcml_node * operator->();
+        const srcml_node & operator++();
+        srcml_node operator++(int);
+        bool operator!=(const srcml_binary_reader_iterator & that) const;
+
+        friend class srcml_binary_reader;
+  };
+private:
+
+  void start();
+  bool read();
+  std::uint64_t read_varint();
+  const char * read_bytes(std::size_t size);
+  srcml_symbol read_symbol();
+  std::shared_ptr<srcml_node::srcml_namespace> read_namespace();
+  std::shared_ptr<srcml_node::srcml_namespace> get_namespace(std::uint64_t number) const;
+  void read_body(unsigned int flags);
+  void next_text_run();
+
+  std::unique_ptr<srcml_memory_input> input;
+  const char * input_position;
+  const char * input_end;
+
+  std::vector<srcml_symbol> symbols;
+  std::vector<std::shared_ptr<srcml_node::srcml_namespace>> namespaces;
+
+  /** flags, name and body of an open start node */
+  class srcml_open_start {
+
+  public:
+
+    unsigned int flags;
+    std::uint64_t name;
+    std::uint64_t ns;
+    const char * body;
+
+  };
+
+  std::vector<srcml_open_start> open_starts;
+  std::uint64_t previous_names[srcml_binary_format::NODE_KINDS];
+  std::uint64_t previous_namespaces[srcml_binary_format::NODE_KINDS];
+
+  const char * split_data;
+  std::size_t split_size;
+  std::size_t split_offset;
+  srcml_symbol split_name;
+  std::shared_ptr<srcml_node::srcml_namespace> split_ns;
+
+  srcml_node node;
+  srcml_node * current_node;
+  bool is_eof;
+
+  srcml_binary_reader_iterator iterator;
+
+  srcml_element_path element_path;
+
+public:
+  srcml_binary_reader(const std::string & filename);
+  srcml_binary_reader(const char * data, std::size_t size);
+
+  const srcml_element_path & get_element_path() const;
+  const std::stack<std::string> & get_element_stack() const;
+
+  srcml_binary_reader_iterator begin();
+  srcml_binary_reader_iterator end();
+
+  operator bool() const;
+
+};
+
+#endif
@@ -0,0 +1,310 @@
+/*
+  srcml_binary_writer.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_binary_writer.hpp>
+#include <srcml_text_run.hpp>
+
+#include <stdexcept>
+#include <algorithm>
+
+class srcml_binary_writer_error : public std::runtime_error {
+public:
+  srcml_binary_writer_error(const std::string & what_arg) : std::runtime_error(what_arg) {}
+
+};
+
+static const std::size_t NO_NAMESPACE = std::size_t(-1);
+static const std::uint64_t NONE = std::uint64_t(-1);
+
+srcml_binary_writer::srcml_binary_writer(const std::string & filename)
+  : out(filename, std::ios::out | std::ios::binary | std::ios::trunc), buffer(), symbol_numbers(1, 1), symbol_count(1),
+    namespaces(), open_starts(), depth(0), body(), pending_text(), pending_name(0), pending_ns(0), pending_space(false) {
+
+  std::fill(previous_names, previous_names + srcml_binary_format::NODE_KINDS, NONE);
+  std::fill(previous_namespaces, previous_namespaces + srcml_binary_format::NODE_KINDS, NONE);
+
+  if(!out) throw srcml_binary_writer_error("Error opening: " + filename);
+
+  buffer.reserve(FLUSH_SIZE + 1024);
+  write_bytes(srcml_binary_format::MAGIC, srcml_binary_format::MAGIC_SIZE);
+  write_varint(srcml_binary_format::VERSION);
+
+}
+
+srcml_binary_writer::~srcml_binary_writer() {
+  try {
+    write_text();
+    flush();
+  } catch(const srcml_binary_writer_error &) {}
+}
+
+void srcml_binary_writer::flush() {
+
+  out.write(buffer.data(), buffer.size());
+  out.flush();
+  buffer.clear();
+
+  if(!out) throw srcml_binary_writer_error("Error writing binary srcML");
+
+}
+
+void srcml_binary_writer::append_varint(std::string & out, std::uint64_t value) {
+
+  while(value >= 0x80) {
+    out += char((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  out += char(value);
+
+}
+
+void srcml_binary_writer::write_varint(std::uint64_t value) {
+  append_varint(buffer, value);
+}
+
+void srcml_binary_writer::write_bytes(const char * data, std::size_t size) {
+  buffer.append(data, size);
+}
+
+/** symbol numbers are stored plus one so zero means not yet written */
+void srcml_binary_writer::define(srcml_symbol symbol) {
+
+  if(symbol.id() < symbol_numbers.size() && symbol_numbers[symbol.id()]) return;
+
+  if(symbol.id() >= symbol_numbers.size()) symbol_numbers.resize(symbol.id() + 1, 0);
+  symbol_numbers[symbol.id()] = ++symbol_count;
+
+  const std::string & str = symbol.str();
+  write_varint(srcml_binary_format::SYMBOL);
+  write_varint(str.size());
+  write_bytes(str.data(), str.size());
+
+}
+
+std::uint32_t srcml_binary_writer::get_symbol(srcml_symbol symbol) const {
+  return symbol_numbers[symbol.id()] - 1;
+}
+
+/** namespaces are matched by pointer first, then by value */
+std::size_t srcml_binary_writer::find_namespace(const std::shared_ptr<srcml_node::srcml_namespace> & ns) const {
+
+  for(std::size_t i = 0; i < namespaces.size(); ++i) {
+    if(namespaces[i].first == ns) return i;
+  }
+
+  for(std::size_t i = 0; i < namespaces.size(); ++i) {
+    if(namespaces[i].first->uri == ns->uri && namespaces[i].first->prefix == ns->prefix) return i;
+  }
+
+  return NO_NAMESPACE;
+}
+
+void srcml_binary_writer::define(const std::shared_ptr<srcml_node::srcml_namespace> & ns) {
+
+  if(!ns || find_namespace(ns) != NO_NAMESPACE) return;
+
+  if(ns->prefix) define(*ns->prefix);
+
+  write_varint(srcml_binary_format::NAMESPACE);
+  write_varint(ns->uri.size());
+  write_bytes(ns->uri.data(), ns->uri.size());
+  write_varint(ns->prefix ? get_symbol(*ns->prefix) + 1 : 0);
+
+  namespaces.emplace_back(ns, namespaces.size());
+
+}
+
+std::uint32_t srcml_binary_writer::get_namespace(const std::shared_ptr<srcml_node::srcml_namespace> & ns) const {
+  return namespaces[find_namespace(ns)].second;
+}
+
+/** a text node that can be merged with its neighbours into one SPLIT_TEXT record */
+static bool is_text_run(const srcml_node & node) {
+
+  if(!node.is_text() || !node.content || node.content.size() == 0 || node.empty || node.extra
+     || !node.ns_definition.empty() || !node.attributes.empty())
+    return false;
+
+  return srcml_text_run(node.content.data(), node.content.size()).length == node.content.size();
+}
+
+/** everything after the name and namespace of a node */
+void srcml_binary_writer::write_body(const srcml_node & node) {
+
+  body.clear();
+
+  if(node.content) {
+    append_varint(body, node.content.size());
+    body.append(node.content.data(), node.content.size());
+  }
+
+  if(!node.ns_definition.empty()) {
+    append_varint(body, node.ns_definition.size());
+    for(const std::shared_ptr<srcml_node::srcml_namespace> & ns : node.ns_definition) {
+      append_varint(body, get_namespace(ns));
+    }
+  }
+
+  if(!node.attributes.empty()) {
+    append_varint(body, node.attributes.size());
+    for(const srcml_node::srcml_attribute_map_pair & attribute : node.attributes) {
+      append_varint(body, get_symbol(attribute.first));
+      append_varint(body, get_symbol(attribute.second.name));
+      append_varint(body, attribute.second.ns ? get_namespace(attribute.second.ns) + 1 : 0);
+      if(attribute.second.value) {
+        append_varint(body, attribute.second.value->size() + 1);
+        body.append(*attribute.second.value);
+      } else {
+        append_varint(body, 0);
+      }
+    }
+  }
+
+  if(node.extra) append_varint(body, node.extra);
+
+}
+
+/**
+ * write
+ * @param node the node to write
+ *
+ * Writes any symbols and namespaces the node uses for the first time,
+ * then the node itself.
+ */
+bool srcml_binary_writer::write(const srcml_node & node) {
+
+  if(is_text_run(node)) {
+    append_text(node);
+    return true;
+  }
+
+  write_text();
+
+  define(node.name);
+  define(node.ns);
+  for(const std::shared_ptr<srcml_node::srcml_namespace> & ns : node.ns_definition) {
+    define(ns);
+  }
+  for(const srcml_node::srcml_attribute_map_pair & attribute : node.attributes) {
+    define(attribute.first);
+    define(attribute.second.name);
+    define(attribute.second.ns);
+  }
+
+  unsigned int kind = node.type;
+  unsigned int flags = 0;
+  if(node.empty)                  flags |= srcml_binary_format::EMPTY;
+  if(node.content)                flags |= srcml_binary_format::HAS_CONTENT;
+  if(!node.ns_definition.empty()) flags |= srcml_binary_format::NS_DEFINITIONS;
+  if(!node.attributes.empty())    flags |= srcml_binary_format::ATTRIBUTES;
+  if(node.extra)                  flags |= srcml_binary_format::EXTRA;
+
+  std::uint64_t name = get_symbol(node.name);
+  std::uint64_t ns = node.ns ? get_namespace(node.ns) + 1 : 0;
+  write_body(node);
+
+  if(node.is_start()) {
+
+    if(depth == open_starts.size()) open_starts.emplace_back();
+    srcml_open_start & start = open_starts[depth++];
+    start.flags = flags;
+    start.name = name;
+    start.ns = ns;
+    start.body = body;
+
+  } else if(node.is_end() && depth) {
+
+    const srcml_open_start & start = open_starts[--depth];
+    if(start.flags == flags && start.name == name && start.ns == ns && start.body == body) {
+      write_varint(kind | (srcml_binary_format::MATCHES_START << srcml_binary_format::KIND_BITS));
+      if(buffer.size() >= FLUSH_SIZE) flush();
+      return true;
+    }
+
+  }
+
+  write_record(kind, flags, name, ns);
+
+  return true;
+}
+
+/**
+ * append_text
+ * @param node a whitespace or non-whitespace text run
+ *
+ * srcml_reader splits text into alternating whitespace and
+ * non-whitespace runs.  Such runs are gathered and written as one
+ * record that the reader splits the same way.
+ */
+void srcml_binary_writer::append_text(const srcml_node & node) {
+
+  define(node.name);
+  define(node.ns);
+
+  std::uint64_t name = get_symbol(node.name);
+  std::uint64_t ns = node.ns ? get_namespace(node.ns) + 1 : 0;
+  bool is_space = srcml_text_run::is_whitespace(node.content.data()[0]);
+
+  if(!pending_text.empty() && (pending_name != name || pending_ns != ns || pending_space == is_space)) write_text();
+
+  pending_text.append(node.content.data(), node.content.size());
+  pending_name = name;
+  pending_ns = ns;
+  pending_space = is_space;
+
+}
+
+void srcml_binary_writer::write_text() {
+
+  if(pending_text.empty()) return;
+
+  body.clear();
+  append_varint(body, pending_text.size());
+  body += pending_text;
+  pending_text.clear();
+
+  write_record(srcml_node::srcml_node_type::TEXT, srcml_binary_format::HAS_CONTENT | srcml_binary_format::SPLIT_TEXT,
+               pending_name, pending_ns);
+
+}
+
+/** header, name and namespace unless they repeat, then the body */
+void srcml_binary_writer::write_record(unsigned int kind, unsigned int flags, std::uint64_t name, std::uint64_t ns) {
+
+  if(kind < srcml_binary_format::NODE_KINDS && previous_names[kind] == name && previous_namespaces[kind] == ns) {
+    flags |= srcml_binary_format::PREVIOUS_NAME;
+  } else if(kind < srcml_binary_format::NODE_KINDS) {
+    previous_names[kind] = name;
+    previous_namespaces[kind] = ns;
+  }
+
+  write_varint(kind | (std::uint64_t(flags) << srcml_binary_format::KIND_BITS));
+  if(!(flags & srcml_binary_format::PREVIOUS_NAME)) {
+    write_varint(name);
+    write_varint(ns);
+  }
+  write_bytes(body.data(), body.size());
+
+  if(buffer.size() >= FLUSH_SIZE) flush();
+
+}
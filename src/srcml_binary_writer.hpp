@@ -0,0 +1,107 @@
+/*
+  srcml_binary_writer.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_BINARY_WRITER_HPP
+#define INCLUDED_SRCML_BINARY_WRITER_HPP
+
+#include <srcml_node.hpp>
+#include <srcml_binary_format.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <cstdint>
+
+class srcml_binary_writer_error;
+
+/**
+ * srcml_binary_writer
+ *
+ * Writes a stream of srcml_nodes in the binary srcML event format
+ * described in srcml_binary_format.hpp, to be read back with
+ * srcml_binary_reader.  Symbols and namespaces are written once and
+ * then referred to by number.  User data is not written.
+ */
+class srcml_binary_writer {
+
+private:
+
+  static const std::size_t FLUSH_SIZE = 1 << 16;
+
+  std::ofstream out;
+  std::string buffer;
+
+  std::vector<std::uint32_t> symbol_numbers;
+  std::uint32_t symbol_count;
+  std::vector<std::pair<std::shared_ptr<srcml_node::srcml_namespace>, std::uint32_t>> namespaces;
+
+  /** flags, name and body of an open start node */
+  class srcml_open_start {
+
+  public:
+
+    unsigned int flags;
+    std::uint64_t name;
+    std::uint64_t ns;
+    std::string body;
+
+  };
+
+  std::vector<srcml_open_start> open_starts;
+  std::size_t depth;
+  std::uint64_t previous_names[srcml_binary_format::NODE_KINDS];
+  std::uint64_t previous_namespaces[srcml_binary_format::NODE_KINDS];
+  std::string body;
+
+  std::string pending_text;
+  std::uint64_t pending_name;
+  std::uint64_t pending_ns;
+  bool pending_space;
+
+  static void append_varint(std::string & out, std::uint64_t value);
+  void write_varint(std::uint64_t value);
+  void write_bytes(const char * data, std::size_t size);
+  void write_body(const srcml_node & node);
+  void write_record(unsigned int kind, unsigned int flags, std::uint64_t name, std::uint64_t ns);
+  void append_text(const srcml_node & node);
+  void write_text();
+
+  void define(srcml_symbol symbol);
+  void define(const std::shared_ptr<srcml_node::srcml_namespace> & ns);
+  std::uint32_t get_symbol(srcml_symbol symbol) const;
+  std::uint32_t get_namespace(const std::shared_ptr<srcml_node::srcml_namespace> & ns) const;
+  std::size_t find_namespace(const std::shared_ptr<srcml_node::srcml_namespace> & ns) const;
+
+  void flush();
+
+public:
+
+  srcml_binary_writer(const std::string & filename);
+  ~srcml_binary_writer();
+
+  bool write(const srcml_node & node);
+
+};
+
+#endif
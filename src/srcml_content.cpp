@@ -0,0 +1,201 @@
+/*
+  srcml_content.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_content.hpp>
+
+#include <utility>
+
+srcml_content::srcml_content()
+  : borrowed_data(nullptr), borrowed_size(0), engaged(false), borrowed(false), materialized(false), text() {}
+
+srcml_content::srcml_content(boost::none_t)
+  : srcml_content() {}
+
+srcml_content::srcml_content(const std::string & str)
+  : borrowed_data(nullptr), borrowed_size(0), engaged(true), borrowed(false), materialized(false), text(str) {}
+
+srcml_content::srcml_content(std::string && str)
+  : borrowed_data(nullptr), borrowed_size(0), engaged(true), borrowed(false), materialized(false), text(std::move(str)) {}
+
+srcml_content::srcml_content(const char * str)
+  : borrowed_data(nullptr), borrowed_size(0), engaged(str != nullptr), borrowed(false), materialized(false),
+    text(str ? str : "") {}
+
+srcml_content::srcml_content(const boost::optional<std::string> & str)
+  : borrowed_data(nullptr), borrowed_size(0), engaged(bool(str)), borrowed(false), materialized(false),
+    text(str ? *str : std::string()) {}
+
+srcml_content::srcml_content(const srcml_content & that)
+  : borrowed_data(nullptr), borrowed_size(0), engaged(that.engaged), borrowed(false), materialized(false),
+    text(that.data(), that.size()) {}
+
+srcml_content::srcml_content(srcml_content && that) noexcept
+  : borrowed_data(that.borrowed_data), borrowed_size(that.borrowed_size), engaged(that.engaged),
+    borrowed(that.borrowed), materialized(that.materialized), text(std::move(that.text)) {
+
+  that.reset();
+}
+
+srcml_content & srcml_content::operator=(const srcml_content & that) {
+
+  if(this == &that) return *this;
+
+  text.assign(that.data(), that.size());
+  engaged = that.engaged;
+  borrowed = false;
+  materialized = false;
+  return *this;
+}
+
+srcml_content & srcml_content::operator=(srcml_content && that) noexcept {
+
+  if(this == &that) return *this;
+
+  borrowed_data = that.borrowed_data;
+  borrowed_size = that.borrowed_size;
+  engaged = that.engaged;
+  borrowed = that.borrowed;
+  materialized = that.materialized;
+  text.swap(that.text);
+  that.reset();
+  return *this;
+}
+
+srcml_content & srcml_content::operator=(boost::none_t) {
+  reset();
+  return *this;
+}
+
+srcml_content & srcml_content::operator=(const std::string & str) {
+  text = str;
+  engaged = true;
+  borrowed = false;
+  materialized = false;
+  return *this;
+}
+
+srcml_content & srcml_content::operator=(std::string && str) {
+  text = std::move(str);
+  engaged = true;
+  borrowed = false;
+  materialized = false;
+  return *this;
+}
+
+srcml_content & srcml_content::operator=(const char * str) {
+  if(!str) return *this = boost::none;
+  text = str;
+  engaged = true;
+  borrowed = false;
+  materialized = false;
+  return *this;
+}
+
+/**
+ * assign
+ * @param data start of the text
+ * @param size length of the text
+ *
+ * Copy text into owned storage, reusing its capacity.
+ */
+void srcml_content::assign(const char * data, std::size_t size) {
+  text.assign(data, size);
+  engaged = true;
+  borrowed = false;
+  materialized = false;
+}
+
+/**
+ * borrow
+ * @param data start of the slice
+ * @param size length of the slice
+ *
+ * Reference data without copying it.  The caller guarantees the
+ * buffer outlives every access through this content.
+ */
+void srcml_content::borrow(const char * data, std::size_t size) {
+  borrowed_data = data;
+  borrowed_size = size;
+  engaged = true;
+  borrowed = true;
+  materialized = false;
+}
+
+/**
+ * own
+ *
+ * Copy a borrowed slice into storage owned by this content.
+ */
+void srcml_content::own() {
+  if(!borrowed) return;
+
+  if(!materialized) text.assign(borrowed_data, borrowed_size);
+  borrowed = false;
+  materialized = false;
+}
+
+/**
+ * reset
+ *
+ * Disengage the content.  Owned storage keeps its capacity so it can
+ * be reused by the next assignment or materialization.
+ */
+void srcml_content::reset() noexcept {
+  borrowed_data = nullptr;
+  borrowed_size = 0;
+  engaged = false;
+  borrowed = false;
+  materialized = false;
+  text.clear();
+}
+
+const std::string & srcml_content::materialize() const {
+  if(!materialized) {
+    text.assign(borrowed_data, borrowed_size);
+    materialized = true;
+  }
+  return text;
+}
+
+boost::string_view srcml_content::view() const {
+  return boost::string_view(data(), size());
+}
+
+std::string & srcml_content::get() {
+  own();
+  return text;
+}
+
+bool srcml_content::operator==(const srcml_content & that) const {
+  if(engaged != that.engaged) return false;
+  if(!engaged) return true;
+  return view() == that.view();
+}
+
+bool srcml_content::operator!=(const srcml_content & that) const {
+  return !operator==(that);
+}
+
+std::ostream & operator<<(std::ostream & out, const srcml_content & content) {
+  return out << content.view();
+}
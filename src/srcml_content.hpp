@@ -0,0 +1,103 @@
+/*
+  srcml_content.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_CONTENT_HPP
+#define INCLUDED_SRCML_CONTENT_HPP
+
+#include <string>
+#include <cstddef>
+#include <ostream>
+
+#include <boost/none.hpp>
+#include <boost/optional.hpp>
+#include <boost/utility/string_view.hpp>
+
+/**
+ * srcml_content
+ *
+ * Optional text of a node.  Behaves like boost::optional<std::string>,
+ * but may instead borrow a slice of a buffer owned by a reader.  A
+ * borrowed slice is only valid until the reader advances; view() reads
+ * it in place, dereferencing copies it into reusable storage, and
+ * own() (or copying the content) makes an independent owning copy.
+ */
+class srcml_content {
+
+private:
+
+  const char * borrowed_data;
+  std::size_t borrowed_size;
+  bool engaged;
+  bool borrowed;
+  mutable bool materialized;
+  mutable std::string text;
+
+  const std::string & materialize() const;
+
+public:
+
+  srcml_content();
+  srcml_content(boost::none_t);
+  srcml_content(const std::string & str);
+  srcml_content(std::string && str);
+  srcml_content(const char * str);
+  srcml_content(const boost::optional<std::string> & str);
+  srcml_content(const srcml_content & that);
+  srcml_content(srcml_content && that) noexcept;
+
+  srcml_content & operator=(const srcml_content & that);
+  srcml_content & operator=(srcml_content && that) noexcept;
+  srcml_content & operator=(boost::none_t);
+  srcml_content & operator=(const std::string & str);
+  srcml_content & operator=(std::string && str);
+  srcml_content & operator=(const char * str);
+
+  void assign(const char * data, std::size_t size);
+  void borrow(const char * data, std::size_t size);
+  void own();
+  void reset() noexcept;
+
+  bool is_borrowed() const { return engaged && borrowed; }
+  bool is_initialized() const { return engaged; }
+  explicit operator bool() const { return engaged; }
+  bool operator!() const { return !engaged; }
+
+  boost::string_view view() const;
+  const char * data() const { return borrowed ? borrowed_data : text.data(); }
+  std::size_t size() const { return borrowed ? borrowed_size : text.size(); }
+
+  const std::string & get() const { return borrowed ? materialize() : text; }
+  std::string & get();
+  const std::string & operator*() const { return get(); }
+  std::string & operator*() { return get(); }
+  const std::string * operator->() const { return &get(); }
+  std::string * operator->() { return &get(); }
+
+  bool operator==(const srcml_content & that) const;
+  bool operator!=(const srcml_content & that) const;
+
+  friend std::ostream & operator<<(std::ostream & out, const srcml_content & content);
+
+};
+
+#endif
@@ -0,0 +1,95 @@
+/*
+  srcml_element_path.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_element_path.hpp>
+
+const std::size_t srcml_element_path::npos;
+const std::uint32_t srcml_element_path::NONE;
+
+srcml_element_path::srcml_element_path()
+  : names(), previous(), counts(), innermost(), stack(), stack_valid(0) {
+
+  names.reserve(64);
+  previous.reserve(64);
+
+}
+
+void srcml_element_path::push(srcml_symbol name) {
+
+  srcml_symbol::id_type id = name.id();
+  if(id >= counts.size()) {
+    counts.resize(id + 1, 0);
+    innermost.resize(id + 1, NONE);
+  }
+
+  previous.push_back(counts[id] ? innermost[id] : NONE);
+  innermost[id] = std::uint32_t(names.size());
+  ++counts[id];
+  names.push_back(name);
+
+}
+
+void srcml_element_path::pop() {
+
+  if(names.empty()) return;
+
+  srcml_symbol::id_type id = names.back().id();
+  innermost[id] = previous.back();
+  --counts[id];
+
+  names.pop_back();
+  previous.pop_back();
+  if(stack_valid > names.size()) stack_valid = names.size();
+
+}
+
+void srcml_element_path::clear() {
+
+  while(!names.empty()) {
+    pop();
+  }
+
+}
+
+/**
+ * to_stack
+ *
+ * The path as a stack of qualified names, innermost on top, for code
+ * written against the string element stack.  The stack is brought up
+ * to date on demand: only the elements pushed since the deepest common
+ * point with the previous call are rebuilt.
+ */
+const std::stack<std::string> & srcml_element_path::to_stack() const {
+
+  while(stack.size() > stack_valid) {
+    stack.pop();
+  }
+
+  for(std::size_t position = stack.size(); position < names.size(); ++position) {
+    stack.push(names[position].str());
+  }
+
+  stack_valid = names.size();
+  return stack;
+
+}
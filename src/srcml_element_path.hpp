@@ -0,0 +1,112 @@
+/*
+  srcml_element_path.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_ELEMENT_PATH_HPP
+#define INCLUDED_SRCML_ELEMENT_PATH_HPP
+
+#include <srcml_symbol.hpp>
+
+#include <string>
+#include <vector>
+#include <stack>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * srcml_element_path
+ *
+ * The open elements of a reader, from the root to the innermost, as
+ * the interned qualified names of the elements.  Besides the path
+ * itself, the number of open elements and the innermost open element
+ * of every name are kept up to date on push and pop, so asking for the
+ * depth, whether the reader is inside an element or where the nearest
+ * enclosing element is takes constant time.  After the first few
+ * elements nothing is allocated.
+ */
+class srcml_element_path {
+
+public:
+
+  typedef std::vector<srcml_symbol>::const_iterator const_iterator;
+  typedef std::vector<srcml_symbol>::const_reverse_iterator const_reverse_iterator;
+
+  static const std::size_t npos = std::size_t(-1);
+
+private:
+
+  static const std::uint32_t NONE = std::uint32_t(-1);
+
+  /** names of the open elements, root first */
+  std::vector<srcml_symbol> names;
+
+  /** per open element, the position of the previous open element of the same name */
+  std::vector<std::uint32_t> previous;
+
+  /** per symbol id, the number of open elements of that name */
+  std::vector<std::uint32_t> counts;
+
+  /** per symbol id, the position of the innermost open element of that name */
+  std::vector<std::uint32_t> innermost;
+
+  mutable std::stack<std::string> stack;
+  mutable std::size_t stack_valid;
+
+public:
+
+  srcml_element_path();
+
+  void push(srcml_symbol name);
+  void pop();
+  void clear();
+
+  std::size_t depth() const { return names.size(); }
+  bool empty() const { return names.empty(); }
+
+  /** name of the open element at a position, 0 being the root */
+  srcml_symbol operator[](std::size_t position) const { return names[position]; }
+
+  /** name of the innermost open element */
+  srcml_symbol back() const { return names.back(); }
+
+  const_iterator begin() const { return names.begin(); }
+  const_iterator end() const { return names.end(); }
+  const_reverse_iterator rbegin() const { return names.rbegin(); }
+  const_reverse_iterator rend() const { return names.rend(); }
+
+  /** number of open elements with the name */
+  std::size_t count(srcml_symbol name) const {
+    return name.id() < counts.size() ? counts[name.id()] : 0;
+  }
+
+  bool is_inside(srcml_symbol name) const { return count(name) != 0; }
+
+  /** position of the innermost open element with the name, or npos */
+  std::size_t nearest(srcml_symbol name) const {
+    return count(name) ? innermost[name.id()] : npos;
+  }
+
+  const std::stack<std::string> & to_stack() const;
+
+};
+
+#endif
@@ -0,0 +1,41 @@
+/*
+  srcml_event_parser.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_event_parser.hpp>
+
+/**
+ * skip_subtree
+ *
+ * If the current event is the start of a non-empty element, move to
+ * its end without handing out anything in between.
+ */
+void srcml_event_parser::skip_subtree() {
+
+  if(!current().is_start() || current().empty) return;
+
+  std::size_t element_depth = current_depth();
+  while(next() == 1) {
+    if(current().is_end() && current_depth() == element_depth) return;
+  }
+
+}
@@ -0,0 +1,60 @@
+/*
+  srcml_event_parser.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_EVENT_PARSER_HPP
+#define INCLUDED_SRCML_EVENT_PARSER_HPP
+
+#include <srcml_node.hpp>
+
+#include <cstddef>
+
+/**
+ * srcml_event_parser
+ *
+ * A parser that hands srcml_reader one srcml_node event at a time, in
+ * place of an xmlTextReader.  Events and their depths are those an
+ * xmlTextReader reports for the same document.
+ */
+class srcml_event_parser {
+
+public:
+
+  virtual ~srcml_event_parser() {}
+
+  /** move to the next event: 1 on success, 0 at the end, -1 on an error */
+  virtual int next() = 0;
+
+  /** the current event */
+  virtual srcml_node & current() = 0;
+
+  /** depth of the current event as xmlTextReaderDepth() gives it */
+  virtual std::size_t current_depth() const = 0;
+
+  /** bytes of the input parsed so far */
+  virtual std::size_t bytes_consumed() const = 0;
+
+  void skip_subtree();
+
+};
+
+#endif
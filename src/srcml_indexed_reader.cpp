@@ -0,0 +1,96 @@
+/*
+  srcml_indexed_reader.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_indexed_reader.hpp>
+
+#include <stdexcept>
+
+#include <sys/stat.h>
+
+class srcml_indexed_reader_error : public std::runtime_error {
+public:
+  srcml_indexed_reader_error(const std::string & what_arg) : std::runtime_error(what_arg) {}
+
+};
+
+/** modification time of a file in nanoseconds, or 0 if unknown */
+static std::uint64_t modification_time(const std::string & filename) {
+
+  struct stat status;
+  if(stat(filename.c_str(), &status) != 0) return 0;
+
+#if defined(_WIN32)
+  return std::uint64_t(status.st_mtime) * 1000000000;
+#elif defined(__APPLE__)
+  return std::uint64_t(status.st_mtimespec.tv_sec) * 1000000000 + status.st_mtimespec.tv_nsec;
+#else
+  return std::uint64_t(status.st_mtim.tv_sec) * 1000000000 + status.st_mtim.tv_nsec;
+#endif
+}
+
+srcml_indexed_reader::srcml_indexed_reader(const std::string & archive)
+  : srcml_indexed_reader(archive, srcml_unit_index::sidecar_filename(archive)) {}
+
+srcml_indexed_reader::srcml_indexed_reader(const std::string & archive, const std::string & index_filename)
+  : input(new srcml_mapped_input(archive)), index() {
+
+  std::uint64_t mtime = modification_time(archive);
+
+  try {
+    index.load(index_filename);
+    if(index.matches(input->data(), input->size(), mtime)) return;
+  } catch(const std::runtime_error &) {}
+
+  index = srcml_unit_index(input->data(), input->size(), mtime);
+
+  // the sidecar only saves work for later runs
+  try {
+    index.save(index_filename);
+  } catch(const std::runtime_error &) {}
+
+}
+
+std::unique_ptr<srcml_reader> srcml_indexed_reader::read_unit(std::size_t unit_number) const {
+
+  if(unit_number >= index.size())
+    throw srcml_indexed_reader_error("No unit " + std::to_string(unit_number) + " in archive");
+
+  const srcml_unit_index::srcml_unit_entry & unit = index.get_unit(unit_number);
+  if(!index.unit_matches(input->data(), unit_number))
+    throw srcml_indexed_reader_error("Unit index does not match archive");
+
+  std::unique_ptr<srcml_input> unit_input(new srcml_unit_input(input->data(), index.is_archive() ? index.get_prolog_size() : 0,
+                                                               input->data() + unit.offset, unit.length,
+                                                               index.is_archive() ? index.get_root_end_tag() : std::string()));
+
+  return std::unique_ptr<srcml_reader>(new srcml_reader(std::move(unit_input), index.is_archive()));
+}
+
+std::unique_ptr<srcml_reader> srcml_indexed_reader::read_unit(const std::string & filename) const {
+
+  std::size_t unit_number = index.find(filename);
+  if(unit_number == srcml_unit_index::npos)
+    throw srcml_indexed_reader_error("No unit with filename " + filename + " in archive");
+
+  return read_unit(unit_number);
+}
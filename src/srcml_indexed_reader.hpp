@@ -0,0 +1,67 @@
+/*
+  srcml_indexed_reader.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_INDEXED_READER_HPP
+#define INCLUDED_SRCML_INDEXED_READER_HPP
+
+#include <srcml_reader.hpp>
+#include <srcml_input.hpp>
+#include <srcml_unit_index.hpp>
+
+#include <string>
+#include <memory>
+
+class srcml_indexed_reader_error;
+
+/**
+ * srcml_indexed_reader
+ *
+ * Random access to the units of a memory-mapped srcML archive.  The
+ * sidecar index is loaded if it matches the archive's size,
+ * modification time and prolog; otherwise the archive is indexed and
+ * the sidecar is rewritten when possible.  A unit whose start tag no
+ * longer matches the index is not read.
+ * Each unit is read with its own srcml_reader that sees the unit as
+ * if the archive had been read up to it.
+ */
+class srcml_indexed_reader {
+
+private:
+
+  std::unique_ptr<srcml_mapped_input> input;
+  srcml_unit_index index;
+
+public:
+
+  srcml_indexed_reader(const std::string & archive);
+  srcml_indexed_reader(const std::string & archive, const std::string & index_filename);
+
+  const srcml_unit_index & get_index() const { return index; }
+  std::size_t size() const { return index.size(); }
+
+  std::unique_ptr<srcml_reader> read_unit(std::size_t unit_number) const;
+  std::unique_ptr<srcml_reader> read_unit(const std::string & filename) const;
+
+};
+
+#endif
@@ -0,0 +1,278 @@
+/*
+  srcml_input.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_input.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <cerrno>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+class srcml_input_error : public std::runtime_error {
+public:
+  srcml_input_error(const std::string & what_arg) : std::runtime_error(what_arg) {}
+
+};
+
+static int close_input(void *) {
+  return 0;
+}
+
+srcml_memory_input::srcml_memory_input()
+  : buffer(""), buffer_size(0), position(0) {}
+
+srcml_memory_input::srcml_memory_input(const char * data, std::size_t size)
+  : buffer(data), buffer_size(size), position(0) {}
+
+int srcml_memory_input::read(void * context, char * buffer, int length) {
+
+  srcml_memory_input * input = (srcml_memory_input *)context;
+
+  std::size_t count = std::min<std::size_t>(length, input->buffer_size - input->position);
+  std::memcpy(buffer, input->buffer + input->position, count);
+  input->position += count;
+
+  return count;
+}
+
+/**
+ * create_reader
+ *
+ * libxml2 parses a memory buffer in place, but only up to INT_MAX
+ * bytes.  Larger buffers are fed through I/O callbacks instead.
+ */
+xmlTextReaderPtr srcml_memory_input::create_reader() {
+
+  if(buffer_size <= INT_MAX)
+    return xmlReaderForMemory(buffer, (int)buffer_size, nullptr, nullptr, 0);
+
+  position = 0;
+  return xmlReaderForIO(&srcml_memory_input::read, &close_input, this, nullptr, nullptr, 0);
+}
+
+std::size_t srcml_memory_input::read_chunk(const char *& data) {
+
+  data = buffer + position;
+  std::size_t count = buffer_size - position;
+  position = buffer_size;
+
+  return count;
+}
+
+srcml_mapped_input::srcml_mapped_input(const std::string & filename)
+  : srcml_memory_input(), mapping(nullptr), mapping_size(0), contents() {
+
+#ifdef _WIN32
+
+  std::ifstream input(filename, std::ios::in | std::ios::binary);
+  if(!input) throw srcml_input_error("Error openining: " + filename);
+
+  std::ostringstream stream;
+  stream << input.rdbuf();
+  contents = stream.str();
+
+  buffer = contents.data();
+  buffer_size = contents.size();
+
+#else
+
+  int fd = open(filename.c_str(), O_RDONLY);
+  if(fd == -1) throw srcml_input_error("Error openining: " + filename);
+
+  struct stat status;
+  if(fstat(fd, &status) == -1) {
+    close(fd);
+    throw srcml_input_error("Error reading: " + filename);
+  }
+
+  // mmap rejects empty mappings, so an empty file stays an empty buffer
+  if(status.st_size > 0) {
+
+    mapping_size = status.st_size;
+    mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(mapping == MAP_FAILED) {
+      mapping = nullptr;
+      close(fd);
+      throw srcml_input_error("Error mapping: " + filename);
+    }
+
+    madvise(mapping, mapping_size, MADV_SEQUENTIAL);
+
+    buffer = (const char *)mapping;
+    buffer_size = mapping_size;
+  }
+
+  close(fd);
+
+#endif
+
+}
+
+srcml_mapped_input::~srcml_mapped_input() {
+
+#ifndef _WIN32
+  if(mapping) munmap(mapping, mapping_size);
+#endif
+
+}
+
+srcml_block_input::srcml_block_input(std::size_t block_size)
+  : block(std::max<std::size_t>(block_size, 1)), block_start(0), block_end(0) {}
+
+int srcml_block_input::read(void * context, char * buffer, int length) {
+
+  srcml_block_input * input = (srcml_block_input *)context;
+
+  try {
+
+    // requests at least as large as a block skip the copy
+    if(input->block_start == input->block_end && (std::size_t)length >= input->block.size())
+      return input->fill(buffer, length);
+
+    if(input->block_start == input->block_end) {
+      input->block_start = 0;
+      input->block_end = input->fill(input->block.data(), input->block.size());
+    }
+
+  } catch(const srcml_input_error &) {
+    return -1;
+  }
+
+  std::size_t count = std::min<std::size_t>(length, input->block_end - input->block_start);
+  std::memcpy(buffer, input->block.data() + input->block_start, count);
+  input->block_start += count;
+
+  return count;
+}
+
+xmlTextReaderPtr srcml_block_input::create_reader() {
+  return xmlReaderForIO(&srcml_block_input::read, &close_input, this, nullptr, nullptr, 0);
+}
+
+std::size_t srcml_block_input::read_chunk(const char *& data) {
+
+  if(block_start == block_end) {
+    block_start = 0;
+    block_end = fill(block.data(), block.size());
+  }
+
+  data = block.data() + block_start;
+  std::size_t count = block_end - block_start;
+  block_start = block_end;
+
+  return count;
+}
+
+srcml_fd_input::srcml_fd_input(int fd, std::size_t block_size)
+  : srcml_block_input(block_size), fd(fd) {}
+
+std::size_t srcml_fd_input::fill(char * buffer, std::size_t size) {
+
+  while(true) {
+
+#ifdef _WIN32
+    int count = _read(fd, buffer, (unsigned int)std::min<std::size_t>(size, INT_MAX));
+#else
+    ssize_t count = ::read(fd, buffer, size);
+#endif
+
+    if(count >= 0) return count;
+    if(errno != EINTR) throw srcml_input_error("Error reading file descriptor");
+
+  }
+
+}
+
+srcml_stream_input::srcml_stream_input(std::istream & in, std::size_t block_size)
+  : srcml_block_input(block_size), in(in) {}
+
+std::size_t srcml_stream_input::fill(char * buffer, std::size_t size) {
+
+  in.read(buffer, size);
+  if(in.bad()) throw srcml_input_error("Error reading stream");
+
+  return in.gcount();
+}
+
+srcml_unit_input::srcml_unit_input(const char * prolog, std::size_t prolog_size,
+                                   const char * unit, std::size_t unit_size,
+                                   const std::string & epilog)
+  : epilog(epilog), piece_data{ prolog, unit, this->epilog.data() }, piece_size{ prolog_size, unit_size, this->epilog.size() },
+    piece(0), offset(0) {}
+
+int srcml_unit_input::read(void * context, char * buffer, int length) {
+
+  srcml_unit_input * input = (srcml_unit_input *)context;
+
+  int total = 0;
+  while(total < length && input->piece < PIECES) {
+
+    std::size_t count = std::min<std::size_t>(input->piece_size[input->piece] - input->offset, length - total);
+    std::memcpy(buffer + total, input->piece_data[input->piece] + input->offset, count);
+    total += count;
+    input->offset += count;
+
+    if(input->offset == input->piece_size[input->piece]) {
+      ++input->piece;
+      input->offset = 0;
+    }
+
+  }
+
+  return total;
+}
+
+xmlTextReaderPtr srcml_unit_input::create_reader() {
+
+  piece = 0;
+  offset = 0;
+  return xmlReaderForIO(&srcml_unit_input::read, &close_input, this, nullptr, nullptr, 0);
+}
+
+std::size_t srcml_unit_input::read_chunk(const char *& data) {
+
+  while(piece < PIECES && offset == piece_size[piece]) {
+    ++piece;
+    offset = 0;
+  }
+
+  if(piece == PIECES) return 0;
+
+  data = piece_data[piece] + offset;
+  std::size_t count = piece_size[piece] - offset;
+  offset = piece_size[piece];
+
+  return count;
+}
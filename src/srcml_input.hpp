@@ -0,0 +1,225 @@
+/*
+  srcml_input.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_INPUT_HPP
+#define INCLUDED_SRCML_INPUT_HPP
+
+#include <libxml/xmlreader.h>
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <cstddef>
+
+class srcml_input_error;
+
+/**
+ * srcml_input
+ *
+ * Source of srcML bytes for a srcml_reader.  The reader owns its input
+ * and keeps it alive for as long as the libxml2 reader created from it.
+ */
+class srcml_input {
+
+public:
+
+  /** default size of the blocks read by streaming inputs */
+  static const std::size_t DEFAULT_BLOCK_SIZE = 1 << 20;
+
+  virtual ~srcml_input() {}
+
+  /** create a libxml2 reader over this input */
+  virtual xmlTextReaderPtr create_reader() = 0;
+
+  /**
+   * read_chunk
+   * @param data set to the start of the next chunk of the input
+   *
+   * Next chunk of the input for a push parser, in place where the input
+   * allows.  The chunk stays valid until the next call.  Returns its
+   * size, 0 at the end.
+   */
+  virtual std::size_t read_chunk(const char *& data) = 0;
+
+};
+
+/**
+ * srcml_memory_input
+ *
+ * Input from a buffer in memory.  The buffer is not copied and must
+ * outlive the reader.
+ */
+class srcml_memory_input : public srcml_input {
+
+protected:
+
+  const char * buffer;
+  std::size_t buffer_size;
+  std::size_t position;
+
+  srcml_memory_input();
+
+  static int read(void * context, char * buffer, int length);
+
+public:
+
+  srcml_memory_input(const char * data, std::size_t size);
+
+  const char * data() const { return buffer; }
+  std::size_t size() const { return buffer_size; }
+
+  virtual xmlTextReaderPtr create_reader();
+  virtual std::size_t read_chunk(const char *& data);
+
+};
+
+/**
+ * srcml_mapped_input
+ *
+ * Input from a memory-mapped file, advised for sequential access.
+ */
+class srcml_mapped_input : public srcml_memory_input {
+
+private:
+
+  void * mapping;
+  std::size_t mapping_size;
+  std::string contents;
+
+public:
+
+  srcml_mapped_input(const std::string & filename);
+  virtual ~srcml_mapped_input();
+
+  srcml_mapped_input(const srcml_mapped_input &) = delete;
+  srcml_mapped_input & operator=(const srcml_mapped_input &) = delete;
+
+};
+
+/**
+ * srcml_block_input
+ *
+ * Input read in large blocks.  libxml2 asks for a few kilobytes at a
+ * time; serving those requests from a block keeps the number of reads
+ * from the underlying source low.
+ */
+class srcml_block_input : public srcml_input {
+
+private:
+
+  std::vector<char> block;
+  std::size_t block_start;
+  std::size_t block_end;
+
+  static int read(void * context, char * buffer, int length);
+
+protected:
+
+  /** read up to size bytes into buffer, returning the number read, 0 at the end */
+  virtual std::size_t fill(char * buffer, std::size_t size) = 0;
+
+public:
+
+  srcml_block_input(std::size_t block_size);
+
+  virtual xmlTextReaderPtr create_reader();
+  virtual std::size_t read_chunk(const char *& data);
+
+};
+
+/**
+ * srcml_fd_input
+ *
+ * Input from an open file descriptor.  The descriptor is not closed.
+ */
+class srcml_fd_input : public srcml_block_input {
+
+private:
+
+  int fd;
+
+protected:
+
+  virtual std::size_t fill(char * buffer, std::size_t size);
+
+public:
+
+  srcml_fd_input(int fd, std::size_t block_size = DEFAULT_BLOCK_SIZE);
+
+};
+
+/**
+ * srcml_stream_input
+ *
+ * Input from a std::istream, which must outlive the reader.
+ */
+class srcml_stream_input : public srcml_block_input {
+
+private:
+
+  std::istream & in;
+
+protected:
+
+  virtual std::size_t fill(char * buffer, std::size_t size);
+
+public:
+
+  srcml_stream_input(std::istream & in, std::size_t block_size = DEFAULT_BLOCK_SIZE);
+
+};
+
+/**
+ * srcml_unit_input
+ *
+ * Input presenting one unit of an archive as a document of its own:
+ * the archive prolog up to the end of the root start tag, the unit,
+ * and the root end tag.  The archive bytes are not copied and must
+ * outlive the reader.
+ */
+class srcml_unit_input : public srcml_input {
+
+private:
+
+  static const int PIECES = 3;
+
+  std::string epilog;
+  const char * piece_data[PIECES];
+  std::size_t piece_size[PIECES];
+  int piece;
+  std::size_t offset;
+
+  static int read(void * context, char * buffer, int length);
+
+public:
+
+  srcml_unit_input(const char * prolog, std::size_t prolog_size,
+                   const char * unit, std::size_t unit_size,
+                   const std::string & epilog);
+
+  virtual xmlTextReaderPtr create_reader();
+  virtual std::size_t read_chunk(const char *& data);
+
+};
+
+#endif
@@ -22,6 +22,8 @@
 */
 
 #include <srcml_node.hpp>
+#include <srcml_text_run.hpp>
+#include <srcml_xml_util.hpp>
 
 #include <srcml.h>
 
@@ -33,6 +35,7 @@
 #include <string>
 #include <algorithm>
 #include <unordered_map>
+#include <mutex>
 
 #ifdef __MINGW32__
 #include <mingw32.hpp>
@@ -44,10 +47,59 @@ std::shared_ptr<srcml_node::srcml_namespace> srcml_node::SRC_NAMESPACE
 std::shared_ptr<srcml_node::srcml_namespace> srcml_node::CPP_NAMESPACE
   = std::make_shared<srcml_node::srcml_namespace>("http://www.srcML.org/srcML/cpp", std::string("cpp"));
 
-std::unordered_map<std::string, std::shared_ptr<srcml_node::srcml_namespace>> srcml_node::namespaces = {};
+std::shared_ptr<srcml_node::srcml_namespace> srcml_node::POS_NAMESPACE
+  = std::make_shared<srcml_node::srcml_namespace>("http://www.srcML.org/srcML/position", std::string("pos"));
+
+namespace {
+
+/**
+ * namespace_registry
+ *
+ * Process-wide table of namespaces by URI, shared by every reader.
+ * The well-known srcML namespaces are registered up front; others are
+ * added the first time any reader sees them.  Readers only get here on
+ * a miss in their own srcml_libxml_cache.
+ */
+class namespace_registry {
+
+private:
+
+  std::mutex mutex;
+  std::unordered_map<std::string, std::shared_ptr<srcml_node::srcml_namespace>> namespaces;
+
+public:
+
+  namespace_registry() : mutex(), namespaces() {
+    namespaces.emplace(srcml_node::SRC_NAMESPACE->uri, srcml_node::SRC_NAMESPACE);
+    namespaces.emplace(srcml_node::CPP_NAMESPACE->uri, srcml_node::CPP_NAMESPACE);
+    namespaces.emplace(srcml_node::POS_NAMESPACE->uri, srcml_node::POS_NAMESPACE);
+  }
+
+  template<class make_namespace_type>
+  std::shared_ptr<srcml_node::srcml_namespace> get(const std::string & uri, make_namespace_type make_namespace) {
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::unordered_map<std::string, std::shared_ptr<srcml_node::srcml_namespace>>::const_iterator citr = namespaces.find(uri);
+    if(citr != namespaces.end()) return citr->second;
+
+    return namespaces.emplace(uri, make_namespace()).first->second;
+  }
+
+};
+
+namespace_registry & registry() {
+  static namespace_registry namespaces;
+  return namespaces;
+}
+
+}
 
 srcml_node::srcml_namespace::srcml_namespace(const std::string & uri, const boost::optional<std::string> & prefix)
-  : uri(uri), prefix(prefix) {}
+  : uri(uri), prefix() {
+
+    if(prefix) this->prefix = srcml_symbol(*prefix);
+}
 
 srcml_node::srcml_namespace::srcml_namespace(xmlNsPtr ns) 
   : uri(), prefix() {
@@ -55,28 +107,198 @@ srcml_node::srcml_namespace::srcml_namespace(xmlNsPtr ns)
     if(!ns) return;
 
     if(ns->href)   uri = std::string((const char *)ns->href);
-    if(ns->prefix) prefix = std::string((const char *)ns->prefix);
+    if(ns->prefix) prefix = srcml_symbol((const char *)ns->prefix);
 }
 
 srcml_node::srcml_namespace::srcml_namespace(const srcml_namespace & ns) 
   : uri(ns.uri), prefix(ns.prefix) {}
 
-srcml_node::srcml_attribute::srcml_attribute(xmlAttrPtr attribute)
-  : name((const char *)attribute->name),
-    value(attribute->children && attribute->children->content ? 
-          std::string((const char *)attribute->children->content) : boost::optional<std::string>()),
-    ns(get_namespace(attribute->ns)) {}
+srcml_node::srcml_libxml_cache::srcml_libxml_cache()
+  : symbols(), namespaces(), uri_namespaces() {}
+
+/** slot of a pointer in a namespace table, mixing out its alignment */
+std::size_t srcml_node::srcml_libxml_cache::slot_of(const void * key) {
+
+  std::uintptr_t bits = std::uintptr_t(key);
+  return std::size_t((bits >> 4) ^ (bits >> 10)) % NAMESPACE_SLOTS;
+
+}
+
+srcml_symbol srcml_node::srcml_libxml_cache::get_symbol(const xmlChar * name, const xmlDoc * doc) {
+  return get_symbol(name, doc ? doc->dict : nullptr);
+}
+
+srcml_symbol srcml_node::srcml_libxml_cache::get_symbol(const xmlChar * name, xmlDictPtr dict) {
+
+  std::unordered_map<const xmlChar *, srcml_symbol>::const_iterator citr = symbols.find(name);
+  if(citr != symbols.end()) return citr->second;
+
+  srcml_symbol symbol((const char *)name);
+  if(dict && xmlDictOwns(dict, name) == 1) {
+    symbols.emplace(name, symbol);
+  }
+
+  return symbol;
+}
+
+std::shared_ptr<srcml_node::srcml_namespace> srcml_node::srcml_libxml_cache::get_namespace(xmlNsPtr ns) {
+
+  if(!ns) return SRC_NAMESPACE;
+
+  namespace_slot & slot = namespaces[slot_of(ns)];
+  if(slot.key == ns) return slot.ns;
+
+  // a collision replaces the slot's entry
+  slot.key = ns;
+  slot.ns = srcml_node::get_namespace(ns);
+
+  return slot.ns;
+}
+
+/**
+ * get_namespace
+ * @param uri namespace URI as given to a SAX2 callback, or null for none
+ * @param prefix its prefix, or null for the default namespace
+ * @param dict dictionary of the parser
+ */
+std::shared_ptr<srcml_node::srcml_namespace> srcml_node::srcml_libxml_cache::get_namespace(const xmlChar * uri, const xmlChar * prefix, xmlDictPtr dict) {
+
+  if(!uri) return SRC_NAMESPACE;
+
+  namespace_slot & slot = uri_namespaces[slot_of(uri)];
+  if(slot.key == uri) return slot.ns;
+
+  std::shared_ptr<srcml_namespace> found
+    = srcml_node::get_namespace((const char *)uri, prefix ? boost::optional<std::string>((const char *)prefix) : boost::none);
+
+  if(dict && xmlDictOwns(dict, uri) == 1) {
+    slot.key = uri;
+    slot.ns = found;
+  }
+
+  return found;
+}
+
+/**
+ * forget_namespaces
+ * @param ns_definitions the namespace declarations of an element, its nsDef list
+ *
+ * Drop the cached namespaces of an element's declarations, which
+ * libxml2 frees with the element and may reuse for other namespaces.
+ */
+void srcml_node::srcml_libxml_cache::forget_namespaces(xmlNsPtr ns_definitions) {
+
+  for(xmlNsPtr ns = ns_definitions; ns; ns = ns->next) {
+
+    namespace_slot & slot = namespaces[slot_of(ns)];
+    if(slot.key == ns) {
+      slot.key = nullptr;
+      slot.ns.reset();
+    }
+
+  }
+
+}
+
+srcml_node::srcml_attribute::srcml_attribute(xmlAttrPtr attribute, srcml_libxml_cache * cache)
+  : name(), value(), ns() {
+
+  assign(attribute, cache);
+
+}
+
+/**
+ * assign
+ * @param attribute the libxml2 attribute
+ * @param cache optional per-reader cache of libxml2 lookups
+ *
+ * Overwrite this attribute, reusing the storage of its value.
+ */
+void srcml_node::srcml_attribute::assign(xmlAttrPtr attribute, srcml_libxml_cache * cache) {
+
+  name = cache ? cache->get_symbol(attribute->name, attribute->doc) : srcml_symbol((const char *)attribute->name);
+
+  if(attribute->children && attribute->children->content) {
+    if(value)
+      value->assign((const char *)attribute->children->content);
+    else
+      value = std::string((const char *)attribute->children->content);
+  } else {
+    value = boost::none;
+  }
+
+  ns = cache ? cache->get_namespace(attribute->ns) : get_namespace(attribute->ns);
+
+}
+
+/**
+ * assign_attribute_value
+ *
+ * An attribute value as the SAX2 parser reports it.  Without entity
+ * substitution the parser leaves '&' as the character reference
+ * "&#38;" for the tree builder to resolve, so character references are
+ * resolved here the same way.
+ */
+static void assign_attribute_value(std::string & value, const char * begin, const char * end) {
+
+  const char * amp = (const char *)std::memchr(begin, '&', end - begin);
+  if(!amp) {
+    value.assign(begin, end);
+    return;
+  }
+
+  value.assign(begin, amp);
+  for(const char * pos = amp; pos < end;) {
+
+    const char * semicolon = *pos == '&' && pos + 2 < end && pos[1] == '#'
+                           ? (const char *)std::memchr(pos, ';', end - pos) : nullptr;
+    if(!semicolon) {
+      value += *pos++;
+      continue;
+    }
+
+    bool hex = pos[2] == 'x';
+    srcml_xml_util::append_utf8(value, std::strtoul(std::string(pos + (hex ? 3 : 2), semicolon).c_str(), nullptr, hex ? 16 : 10));
+    pos = semicolon + 1;
+
+  }
+
+}
+
+/**
+ * assign
+ * @param attribute localname, prefix, URI, value and value end of an
+ *                  attribute as given to the SAX2 startElementNs callback
+ * @param cache per-reader cache of libxml2 lookups
+ * @param dict dictionary of the parser
+ *
+ * Overwrite this attribute, reusing the storage of its value.
+ */
+void srcml_node::srcml_attribute::assign(const xmlChar ** attribute, srcml_libxml_cache & cache, xmlDictPtr dict) {
+
+  name = cache.get_symbol(attribute[0], dict);
+
+  if(!value) value = std::string();
+  assign_attribute_value(*value, (const char *)attribute[3], (const char *)attribute[4]);
+
+  ns = attribute[2] ? cache.get_namespace(attribute[2], attribute[1], dict) : SRC_NAMESPACE;
+
+}
 
 srcml_node::srcml_attribute::srcml_attribute(
     const std::string & name,
     std::shared_ptr<srcml_namespace> ns,
     boost::optional<std::string> value) : name(name), ns(ns), value(value) {}
 
-std::string srcml_node::srcml_attribute::full_name() const {
-  if(ns && ns->prefix) return *ns->prefix + ":" + name;
+srcml_symbol srcml_node::srcml_attribute::qualified_name() const {
+  if(ns && ns->prefix) return srcml_symbol::qualify(*ns->prefix, name);
   return name;
 }
 
+const std::string & srcml_node::srcml_attribute::full_name() const {
+  return qualified_name().str();
+}
+
 bool srcml_node::srcml_attribute::operator==(const srcml_attribute & that) const {
   return ns == that.ns && name == that.name && value == that.value;
 }
@@ -85,89 +307,361 @@ bool srcml_node::srcml_attribute::operator!=(const srcml_attribute & that) const
   return !this->operator==(that);
 }
 
-srcml_node::srcml_node_type xml_type2srcml_type(xmlElementType type) {
-  static std::unordered_map<unsigned int, srcml_node::srcml_node_type> type_map = {
+srcml_node::srcml_attribute_map::srcml_attribute_map() : storage() {}
+
+srcml_node::srcml_attribute_map::srcml_attribute_map(const std::map<std::string, srcml_attribute> & attributes)
+  : storage() {
+
+  for(const std::pair<const std::string, srcml_attribute> & attribute : attributes) {
+    storage.emplace_back(srcml_symbol(attribute.first), attribute.second);
+  }
+
+}
+
+// moving never allocates: inline entries fit the inline storage of the target
+srcml_node::srcml_attribute_map::srcml_attribute_map(srcml_attribute_map && that) noexcept
+  : storage(std::move(that.storage)) {}
+
+srcml_node::srcml_attribute_map & srcml_node::srcml_attribute_map::operator=(srcml_attribute_map && that) noexcept {
+  storage = std::move(that.storage);
+  return *this;
+}
+
+srcml_node::srcml_attribute_map::iterator srcml_node::srcml_attribute_map::find(srcml_symbol key) {
+  return std::find_if(storage.begin(), storage.end(), [key](const value_type & attribute) { return attribute.first == key; });
+}
+
+srcml_node::srcml_attribute_map::const_iterator srcml_node::srcml_attribute_map::find(srcml_symbol key) const {
+  return std::find_if(storage.begin(), storage.end(), [key](const value_type & attribute) { return attribute.first == key; });
+}
+
+srcml_node::srcml_attribute_map::iterator srcml_node::srcml_attribute_map::find(const std::string & key) {
+  return std::find_if(storage.begin(), storage.end(), [&key](const value_type & attribute) { return attribute.first.str() == key; });
+}
+
+srcml_node::srcml_attribute_map::const_iterator srcml_node::srcml_attribute_map::find(const std::string & key) const {
+  return std::find_if(storage.begin(), storage.end(), [&key](const value_type & attribute) { return attribute.first.str() == key; });
+}
+
+srcml_node::srcml_attribute_map::iterator srcml_node::srcml_attribute_map::find(const char * key) {
+  return std::find_if(storage.begin(), storage.end(), [key](const value_type & attribute) { return attribute.first == key; });
+}
+
+srcml_node::srcml_attribute_map::const_iterator srcml_node::srcml_attribute_map::find(const char * key) const {
+  return std::find_if(storage.begin(), storage.end(), [key](const value_type & attribute) { return attribute.first == key; });
+}
+
+srcml_node::srcml_attribute_map::size_type srcml_node::srcml_attribute_map::count(const std::string & key) const {
+  return find(key) != end() ? 1 : 0;
+}
+
+std::pair<srcml_node::srcml_attribute_map::iterator, bool> srcml_node::srcml_attribute_map::insert(const value_type & attribute) {
+
+  iterator itr = find(attribute.first);
+  if(itr != end()) return std::make_pair(itr, false);
+
+  storage.push_back(attribute);
+  return std::make_pair(storage.end() - 1, true);
+}
+
+std::pair<srcml_node::srcml_attribute_map::iterator, bool> srcml_node::srcml_attribute_map::emplace(const value_type & attribute) {
+  return insert(attribute);
+}
+
+std::pair<srcml_node::srcml_attribute_map::iterator, bool> srcml_node::srcml_attribute_map::emplace(srcml_symbol key, const srcml_attribute & attribute) {
+  return insert(value_type(key, attribute));
+}
+
+srcml_node::srcml_attribute & srcml_node::srcml_attribute_map::operator[](const std::string & key) {
+
+  iterator itr = find(key);
+  if(itr != end()) return itr->second;
+
+  storage.emplace_back(srcml_symbol(key), srcml_attribute());
+  return storage.back().second;
+}
 
-    { XML_READER_TYPE_ELEMENT, srcml_node::srcml_node_type::START },
-    { XML_READER_TYPE_END_ELEMENT, srcml_node::srcml_node_type::END },
-    { XML_READER_TYPE_TEXT, srcml_node::srcml_node_type::TEXT },
-    { XML_READER_TYPE_SIGNIFICANT_WHITESPACE, srcml_node::srcml_node_type::TEXT },
+srcml_node::srcml_attribute & srcml_node::srcml_attribute_map::at(const std::string & key) {
 
-  };
+  iterator itr = find(key);
+  if(itr == end()) throw std::out_of_range("No attribute: " + key);
+  return itr->second;
+}
+
+const srcml_node::srcml_attribute & srcml_node::srcml_attribute_map::at(const std::string & key) const {
+
+  const_iterator citr = find(key);
+  if(citr == end()) throw std::out_of_range("No attribute: " + key);
+  return citr->second;
+}
+
+srcml_node::srcml_attribute_map::iterator srcml_node::srcml_attribute_map::erase(const_iterator position) {
+  return storage.erase(position);
+}
+
+srcml_node::srcml_attribute_map::size_type srcml_node::srcml_attribute_map::erase(const std::string & key) {
+
+  iterator itr = find(key);
+  if(itr == end()) return 0;
+
+  storage.erase(itr);
+  return 1;
+}
+
+/**
+ * assign
+ * @param attribute first of a list of libxml2 attributes
+ * @param cache optional per-reader cache of libxml2 lookups
+ *
+ * Replace the attributes with the list starting at attribute.
+ * Existing entries are overwritten in place so their storage is reused.
+ */
+void srcml_node::srcml_attribute_map::assign(xmlAttrPtr attribute, srcml_libxml_cache * cache) {
+
+  size_type size = 0;
+  for(; attribute; attribute = attribute->next, ++size) {
+
+    if(size == storage.size()) storage.emplace_back();
+
+    value_type & entry = storage[size];
+    entry.second.assign(attribute, cache);
+    entry.first = entry.second.qualified_name();
 
-  try {
-    return type_map.at((unsigned int)type);
-  } catch(const std::out_of_range & error) {
-    return srcml_node::srcml_node_type::OTHER;
   }
 
+  storage.erase(storage.begin() + size, storage.end());
+
 }
 
-std::shared_ptr<srcml_node::srcml_namespace> srcml_node::get_namespace(xmlNsPtr ns) {
+/**
+ * assign
+ * @param attributes attributes as given to the SAX2 startElementNs
+ *                   callback, five pointers each
+ * @param count number of attributes
+ * @param cache per-reader cache of libxml2 lookups
+ * @param dict dictionary of the parser
+ *
+ * Replace the attributes, reusing the storage of existing entries.
+ */
+void srcml_node::srcml_attribute_map::assign(const xmlChar ** attributes, int count, srcml_libxml_cache & cache, xmlDictPtr dict) {
+
+  size_type size = 0;
+  for(; size < size_type(count); ++size) {
+
+    if(size == storage.size()) storage.emplace_back();
+
+    value_type & entry = storage[size];
+    entry.second.assign(attributes + 5 * size, cache, dict);
+    entry.first = entry.second.qualified_name();
+
+  }
+
+  storage.erase(storage.begin() + size, storage.end());
+
+}
+
+std::map<std::string, srcml_node::srcml_attribute> srcml_node::srcml_attribute_map::to_map() const {
+
+  std::map<std::string, srcml_attribute> attributes;
+  for(const value_type & attribute : storage) {
+    attributes.emplace(attribute.first.str(), attribute.second);
+  }
+
+  return attributes;
+}
 
-  static bool init_namespace = true;
+bool srcml_node::srcml_attribute_map::operator==(const srcml_attribute_map & that) const {
 
-  if(init_namespace) {
-      namespaces.emplace(std::make_pair("http://www.srcML.org/srcML/src", SRC_NAMESPACE));
-      namespaces.emplace(std::make_pair("http://www.srcML.org/srcML/cpp", CPP_NAMESPACE));
-      init_namespace = false;
+  if(size() != that.size()) return false;
+
+  for(const value_type & attribute : storage) {
+    const_iterator citr = that.find(attribute.first);
+    if(citr == that.end() || citr->second != attribute.second) return false;
   }
 
+  return true;
+}
+
+bool srcml_node::srcml_attribute_map::operator!=(const srcml_attribute_map & that) const {
+  return !operator==(that);
+}
+
+srcml_node::srcml_node_type xml_type2srcml_type(xmlElementType type) {
+
+  switch((unsigned int)type) {
+
+    case XML_READER_TYPE_ELEMENT:                 return srcml_node::srcml_node_type::START;
+    case XML_READER_TYPE_END_ELEMENT:             return srcml_node::srcml_node_type::END;
+    case XML_READER_TYPE_TEXT:                    return srcml_node::srcml_node_type::TEXT;
+    case XML_READER_TYPE_SIGNIFICANT_WHITESPACE:  return srcml_node::srcml_node_type::TEXT;
+    default:                                      return srcml_node::srcml_node_type::OTHER;
+
+  }
+
+}
+
+std::shared_ptr<srcml_node::srcml_namespace> srcml_node::get_namespace(xmlNsPtr ns) {
+
   if(!ns) return SRC_NAMESPACE;
 
-  typedef std::unordered_map<std::string, std::shared_ptr<srcml_namespace>>::const_iterator namespaces_citr;
-  namespaces_citr citr = namespaces.find((const char *)ns->href);
-  if(citr != namespaces.end()) return citr->second;
+  return registry().get((const char *)ns->href, [ns]() { return std::make_shared<srcml_namespace>(ns); });
+}
 
-  namespaces_citr added_citr = namespaces.emplace(std::make_pair((const char *)ns->href, std::make_shared<srcml_namespace>(ns))).first;
-  return added_citr->second;
+std::shared_ptr<srcml_node::srcml_namespace> srcml_node::get_namespace(const std::string & uri,
+                                                                       const boost::optional<std::string> & prefix) {
+  return registry().get(uri, [&uri, &prefix]() { return std::make_shared<srcml_namespace>(uri, prefix); });
 }
 
 
 srcml_node::srcml_node()
   : type(srcml_node_type::OTHER), name(), ns(SRC_NAMESPACE), content(),
-    ns_definition(), attributes(), empty(false), user_data(), extra(0) {}
+    ns_definition(), attributes(), empty(false), user_data(), extra(0), line_delta(0), column_delta(0) {}
+
+srcml_node::srcml_node(const xmlNode & node, xmlElementType xml_type, srcml_libxml_cache * cache) 
+  : type(srcml_node_type::OTHER), name(), ns(), content(),
+    ns_definition(), attributes(), empty(false), user_data(), extra(0), line_delta(0), column_delta(0) {
 
-srcml_node::srcml_node(const xmlNode & node, xmlElementType xml_type) 
-  : type(xml_type2srcml_type(xml_type)), name(), ns(), content(),
-    ns_definition(), attributes(), empty(node.extra), user_data(), extra(node.extra) {
+  assign(node, xml_type, cache);
 
-  name = std::string((const char *)node.name);
+}
+
+/**
+ * assign
+ * @param node the libxml2 node
+ * @param xml_type reader type of the node
+ * @param cache optional per-reader cache of libxml2 lookups
+ *
+ * Overwrite this node with the contents of node.  Storage already held
+ * by this node is reused where possible, so a reader can recycle one
+ * node across events instead of allocating a new one each time.
+ */
+void srcml_node::assign(const xmlNode & node, xmlElementType xml_type, srcml_libxml_cache * cache) {
+
+  type = xml_type2srcml_type(xml_type);
+  name = cache ? cache->get_symbol(node.name, node.doc) : srcml_symbol((const char *)node.name);
 
   if(node.content)
-    content = std::string((const char *)node.content);
+    content = (const char *)node.content;
+  else
+    content.reset();
 
-  ns = get_namespace(node.ns);
+  ns = cache ? cache->get_namespace(node.ns) : get_namespace(node.ns);
 
+  ns_definition.clear();
   xmlNsPtr node_ns = node.nsDef;
   while(node_ns) {
-    ns_definition.emplace_back(get_namespace(node_ns));
+    ns_definition.emplace_back(cache ? cache->get_namespace(node_ns) : get_namespace(node_ns));
     node_ns = node_ns->next;
   }
 
-  xmlAttrPtr attribute = node.properties;
-  while (attribute) {
-    srcml_attribute new_attribute = srcml_attribute(attribute);
-    attributes.emplace(std::make_pair(new_attribute.full_name(), new_attribute));
-    attribute = attribute->next;
-  }
+  attributes.assign(node.properties, cache);
+
+  empty = node.extra;
+  if(!user_data.empty()) user_data = boost::any();
+  extra = node.extra;
+
+  line_delta = 0;
+  column_delta = 0;
+  if(type == srcml_node_type::TEXT) srcml_text_run::count_lines(content.data(), content.size(), line_delta, column_delta);
+
+}
+
+/**
+ * clear
+ *
+ * Return this node to the default (OTHER) state while keeping any
+ * storage it holds.
+ */
+void srcml_node::clear() {
+
+  type = srcml_node_type::OTHER;
+  name = srcml_symbol();
+  if(ns != SRC_NAMESPACE) ns = SRC_NAMESPACE;
+  content.reset();
+  ns_definition.clear();
+  attributes.clear();
+  empty = false;
+  if(!user_data.empty()) user_data = boost::any();
+  extra = 0;
+  line_delta = 0;
+  column_delta = 0;
 
 }
 
 srcml_node::srcml_node(const std::string & text)
-  : type(srcml_node_type::TEXT), name("text"), ns(SRC_NAMESPACE), content(text), ns_definition(), attributes(), empty(false), extra(0) {}
+  : type(srcml_node_type::TEXT), name("text"), ns(SRC_NAMESPACE), content(text), ns_definition(), attributes(), empty(false), extra(0),
+    line_delta(0), column_delta(0) {
+
+  srcml_text_run::count_lines(content.data(), content.size(), line_delta, column_delta);
+
+}
+
+srcml_node::srcml_node(std::string && text)
+  : type(srcml_node_type::TEXT), name("text"), ns(SRC_NAMESPACE), content(std::move(text)), ns_definition(), attributes(), empty(false), extra(0),
+    line_delta(0), column_delta(0) {
+
+  srcml_text_run::count_lines(content.data(), content.size(), line_delta, column_delta);
+
+}
 
 srcml_node::srcml_node(const srcml_node & node) : type(node.type), name(node.name), ns(node.ns),
   content(node.content), ns_definition(node.ns_definition), attributes(node.attributes), empty(node.empty),
-  user_data(node.user_data) {}
+  user_data(node.user_data), extra(node.extra), line_delta(node.line_delta), column_delta(node.column_delta) {}
+
+srcml_node::srcml_node(srcml_node && node) noexcept : type(node.type), name(node.name), ns(std::move(node.ns)),
+  content(std::move(node.content)), ns_definition(std::move(node.ns_definition)), attributes(std::move(node.attributes)),
+  empty(node.empty), user_data(std::move(node.user_data)), extra(node.extra), line_delta(node.line_delta),
+  column_delta(node.column_delta) {}
+
+srcml_node & srcml_node::operator=(const srcml_node & node) {
+
+  if(this == &node) return *this;
+
+  type = node.type;
+  name = node.name;
+  ns = node.ns;
+  content = node.content;
+  ns_definition = node.ns_definition;
+  attributes = node.attributes;
+  empty = node.empty;
+  user_data = node.user_data;
+  extra = node.extra;
+  line_delta = node.line_delta;
+  column_delta = node.column_delta;
+
+  return *this;
+}
+
+srcml_node & srcml_node::operator=(srcml_node && node) noexcept {
+
+  if(this == &node) return *this;
+
+  type = node.type;
+  name = node.name;
+  ns = std::move(node.ns);
+  content = std::move(node.content);
+  ns_definition = std::move(node.ns_definition);
+  attributes = std::move(node.attributes);
+  empty = node.empty;
+  user_data = std::move(node.user_data);
+  extra = node.extra;
+  line_delta = node.line_delta;
+  column_delta = node.column_delta;
+
+  return *this;
+}
 
 srcml_node::~srcml_node() {}
 
-std::string srcml_node::full_name() const {
+srcml_symbol srcml_node::qualified_name() const {
 
-  if(ns->prefix) return *ns->prefix + ":" + name;
+  if(ns && ns->prefix) return srcml_symbol::qualify(*ns->prefix, name);
 
   return name;
+}
+
+const std::string & srcml_node::full_name() const {
+  return qualified_name().str();
 } 
 
 const srcml_node::srcml_attribute * srcml_node::get_attribute(const std::string & attribute) const {
@@ -228,7 +722,7 @@ bool srcml_node::is_text() const {
 }
 
 bool srcml_node::is_whitespace() const {
-  return is_text() && std::isspace((*content)[0]);
+  return is_text() && content.size() && srcml_text_run::is_whitespace(content.data()[0]);
 }
 
 std::ostream & operator<<(std::ostream & out, const srcml_node & node) {
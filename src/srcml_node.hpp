@@ -24,16 +24,22 @@
 #ifndef INCLUDED_SRCML_NODE_HPP
 #define INCLUDED_SRCML_NODE_HPP
 
+#include <srcml_symbol.hpp>
+#include <srcml_content.hpp>
+
 #include <srcml.h>
 
 #include <string>
 #include <list>
 #include <map>
+#include <vector>
 #include <unordered_map>
 #include <memory>
+#include <cstdint>
 
 #include <boost/optional.hpp>
 #include <boost/any.hpp>
+#include <boost/container/small_vector.hpp>
 
 #include <libxml/xmlreader.h>
 #include <libxml/xmlwriter.h>
@@ -47,7 +53,7 @@ public:
   public:
 
     std::string uri;
-    boost::optional<std::string> prefix;
+    boost::optional<srcml_symbol> prefix;
 
     srcml_namespace(const std::string & uri = std::string(),
                     const boost::optional<std::string> & prefix = boost::optional<std::string>());
@@ -58,22 +64,72 @@ public:
 
   static std::shared_ptr<srcml_namespace> SRC_NAMESPACE;
   static std::shared_ptr<srcml_namespace> CPP_NAMESPACE;
-  static std::unordered_map<std::string, std::shared_ptr<srcml_namespace>> namespaces;
+  static std::shared_ptr<srcml_namespace> POS_NAMESPACE;
+
+  /**
+   * srcml_libxml_cache
+   *
+   * Per-reader cache from libxml2 pointers to interned srcReader values.
+   * Element and attribute names handed out by an xmlTextReader live in
+   * the document's dictionary, so after the first lookup a name resolves
+   * to its symbol by pointer alone.  Only dictionary-owned pointers are
+   * cached since anything else may be freed and reused.
+   *
+   * Namespaces are cached by xmlNsPtr in a direct-mapped table, so a
+   * lookup is one slot and a pointer compare.  An xmlNs is not
+   * dictionary-owned: it is freed with the element that declares it, so
+   * the reader forgets an element's namespace declarations before
+   * libxml2 may free them.  The SAX2 callbacks name namespaces by URI and
+   * prefix instead, and those are cached by URI when the parser's
+   * dictionary owns it.  A reader owns its cache, so no locking is needed.
+   */
+  class srcml_libxml_cache {
+
+  private:
+
+    static const std::size_t NAMESPACE_SLOTS = 64;
+
+    struct namespace_slot {
+      const void * key;
+      std::shared_ptr<srcml_namespace> ns;
+    };
+
+    static std::size_t slot_of(const void * key);
+
+    std::unordered_map<const xmlChar *, srcml_symbol> symbols;
+    namespace_slot namespaces[NAMESPACE_SLOTS];
+    namespace_slot uri_namespaces[NAMESPACE_SLOTS];
+
+  public:
+
+    srcml_libxml_cache();
+
+    srcml_symbol get_symbol(const xmlChar * name, const xmlDoc * doc);
+    srcml_symbol get_symbol(const xmlChar * name, xmlDictPtr dict);
+    std::shared_ptr<srcml_namespace> get_namespace(xmlNsPtr ns);
+    std::shared_ptr<srcml_namespace> get_namespace(const xmlChar * uri, const xmlChar * prefix, xmlDictPtr dict);
+    void forget_namespaces(xmlNsPtr ns_definitions);
+
+  };
 
   class srcml_attribute {
 
   public:
 
-    std::string name;
+    srcml_symbol name;
     boost::optional<std::string> value;
     std::shared_ptr<srcml_namespace> ns;
 
-    srcml_attribute(xmlAttrPtr attribute);
+    srcml_attribute(xmlAttrPtr attribute, srcml_libxml_cache * cache = nullptr);
     srcml_attribute(const std::string & name = std::string(),
                     std::shared_ptr<srcml_namespace> ns = SRC_NAMESPACE,
                     boost::optional<std::string> value = boost::optional<std::string>());
 
-    std::string full_name() const;
+    void assign(xmlAttrPtr attribute, srcml_libxml_cache * cache = nullptr);
+    void assign(const xmlChar ** attribute, srcml_libxml_cache & cache, xmlDictPtr dict);
+
+    srcml_symbol qualified_name() const;
+    const std::string & full_name() const;
 
     bool operator==(const srcml_attribute & that) const;
     bool operator!=(const srcml_attribute & that) const;
@@ -82,15 +138,85 @@ public:
 
   enum srcml_node_type : unsigned int  { OTHER = 0, START = 1, END = 2, TEXT = 3 };
 
-  typedef std::map<std::string, srcml_attribute> srcml_attribute_map;
-  typedef std::pair<std::string, srcml_attribute> srcml_attribute_map_pair;
-  typedef std::map<std::string, srcml_attribute>::const_iterator srcml_attribute_map_citr;
-  typedef std::map<std::string, srcml_attribute>::iterator srcml_attribute_map_itr;
+  /**
+   * srcml_attribute_map
+   *
+   * Attributes of a node, keyed by interned full name and stored
+   * contiguously in document order.  Nodes rarely have more than a
+   * couple of attributes, so the first few are stored inline and
+   * lookup is a linear scan.  The interface follows the std::map it
+   * replaces, and to_map() converts for code that needs a real map.
+   */
+  class srcml_attribute_map {
+
+  public:
+
+    typedef std::pair<srcml_symbol, srcml_attribute> value_type;
+    typedef boost::container::small_vector<value_type, 2> storage_type;
+    typedef storage_type::iterator iterator;
+    typedef storage_type::const_iterator const_iterator;
+    typedef storage_type::size_type size_type;
+
+  private:
+
+    storage_type storage;
+
+  public:
+
+    srcml_attribute_map();
+    srcml_attribute_map(const std::map<std::string, srcml_attribute> & attributes);
+    srcml_attribute_map(const srcml_attribute_map & that) = default;
+    srcml_attribute_map(srcml_attribute_map && that) noexcept;
+
+    srcml_attribute_map & operator=(const srcml_attribute_map & that) = default;
+    srcml_attribute_map & operator=(srcml_attribute_map && that) noexcept;
+
+    iterator begin() { return storage.begin(); }
+    iterator end() { return storage.end(); }
+    const_iterator begin() const { return storage.begin(); }
+    const_iterator end() const { return storage.end(); }
+
+    size_type size() const { return storage.size(); }
+    bool empty() const { return storage.empty(); }
+    void clear() { storage.clear(); }
+    void resize(size_type count) { storage.resize(count); }
+
+    iterator find(srcml_symbol key);
+    const_iterator find(srcml_symbol key) const;
+    iterator find(const std::string & key);
+    const_iterator find(const std::string & key) const;
+    iterator find(const char * key);
+    const_iterator find(const char * key) const;
+    size_type count(const std::string & key) const;
+
+    std::pair<iterator, bool> insert(const value_type & attribute);
+    std::pair<iterator, bool> emplace(const value_type & attribute);
+    std::pair<iterator, bool> emplace(srcml_symbol key, const srcml_attribute & attribute);
+    srcml_attribute & operator[](const std::string & key);
+    srcml_attribute & at(const std::string & key);
+    const srcml_attribute & at(const std::string & key) const;
+
+    iterator erase(const_iterator position);
+    size_type erase(const std::string & key);
+
+    void assign(xmlAttrPtr attribute, srcml_libxml_cache * cache = nullptr);
+    void assign(const xmlChar ** attributes, int count, srcml_libxml_cache & cache, xmlDictPtr dict);
+
+    std::map<std::string, srcml_attribute> to_map() const;
+
+    bool operator==(const srcml_attribute_map & that) const;
+    bool operator!=(const srcml_attribute_map & that) const;
+
+  };
+
+  typedef srcml_attribute_map::value_type srcml_attribute_map_pair;
+  typedef srcml_attribute_map::const_iterator srcml_attribute_map_citr;
+  typedef srcml_attribute_map::iterator srcml_attribute_map_itr;
 
   srcml_node_type type;
-  std::string name;
+  srcml_symbol name;
   std::shared_ptr<srcml_namespace> ns;
-  boost::optional<std::string> content;
+  srcml_content content;
   std::list<std::shared_ptr<srcml_namespace>> ns_definition;
   srcml_attribute_map attributes;
   bool empty;
@@ -98,18 +224,33 @@ public:
 
   unsigned short extra;
 
+  /** for a text node, srcml_text_run deltas of reading over its content as it was read */
+  std::uint32_t line_delta;
+  std::uint32_t column_delta;
+
   static std::shared_ptr<srcml_namespace> get_namespace(xmlNsPtr ns);
+  static std::shared_ptr<srcml_namespace> get_namespace(const std::string & uri,
+                                                        const boost::optional<std::string> & prefix = boost::optional<std::string>());
 
 public:
 
   srcml_node();
-  srcml_node(const xmlNode & node, xmlElementType xml_type);
+  srcml_node(const xmlNode & node, xmlElementType xml_type, srcml_libxml_cache * cache = nullptr);
   srcml_node(const std::string & text);
+  srcml_node(std::string && text);
   srcml_node(const srcml_node & node);
+  srcml_node(srcml_node && node) noexcept;
 
   ~srcml_node();
 
-  std::string full_name() const;
+  srcml_node & operator=(const srcml_node & node);
+  srcml_node & operator=(srcml_node && node) noexcept;
+
+  void assign(const xmlNode & node, xmlElementType xml_type, srcml_libxml_cache * cache = nullptr);
+  void clear();
+
+  srcml_symbol qualified_name() const;
+  const std::string & full_name() const;
   const srcml_node::srcml_attribute * get_attribute(const std::string & attribute) const;
   srcml_node::srcml_attribute * get_attribute(const std::string & attribute);
   const std::string * get_attribute_value(const std::string & attribute) const;
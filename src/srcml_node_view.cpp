@@ -0,0 +1,195 @@
+/*
+  srcml_node_view.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_node_view.hpp>
+
+#include <cstring>
+
+static boost::string_view view_of(const xmlChar * str) {
+  return str ? boost::string_view((const char *)str) : boost::string_view();
+}
+
+srcml_node_view::srcml_node_view()
+  : node_type(srcml_node::srcml_node_type::OTHER), node(nullptr), event(nullptr), empty(false), with_attributes(false) {}
+
+/**
+ * srcml_node_view
+ * @param node the libxml2 node
+ * @param type its type as srcml_reader reports it
+ * @param empty whether it is reported as an empty element
+ * @param with_attributes false for the end node srcml_reader issues
+ *                        for an empty element, which has none
+ */
+srcml_node_view::srcml_node_view(const xmlNode * node, srcml_node::srcml_node_type type, bool empty, bool with_attributes)
+  : node_type(type), node(node), event(nullptr), empty(empty), with_attributes(with_attributes) {}
+
+srcml_node_view::srcml_node_view(const srcml_node * event)
+  : node_type(event->type), node(nullptr), event(event), empty(false), with_attributes(true) {}
+
+/** local name */
+boost::string_view srcml_node_view::name() const {
+
+  if(event) return event->name.str();
+  if(node) return view_of(node->name);
+
+  return boost::string_view();
+}
+
+/** namespace prefix, empty for none */
+boost::string_view srcml_node_view::prefix() const {
+
+  if(event) return event->ns && event->ns->prefix ? boost::string_view(event->ns->prefix->str()) : boost::string_view();
+  if(node && node->ns) return view_of(node->ns->prefix);
+
+  return boost::string_view();
+}
+
+boost::string_view srcml_node_view::uri() const {
+
+  if(event) return event->ns ? boost::string_view(event->ns->uri) : boost::string_view();
+  if(node && node->ns) return view_of(node->ns->href);
+
+  return srcml_node::SRC_NAMESPACE->uri;
+}
+
+bool srcml_node_view::has_content() const {
+
+  if(event) return bool(event->content);
+
+  return node && node->content;
+}
+
+boost::string_view srcml_node_view::content() const {
+
+  if(event) return event->content ? boost::string_view(event->content.data(), event->content.size()) : boost::string_view();
+  if(node) return view_of(node->content);
+
+  return boost::string_view();
+}
+
+std::size_t srcml_node_view::attribute_count() const {
+
+  if(event) return event->attributes.size();
+  if(!node || !with_attributes || node->type != XML_ELEMENT_NODE) return 0;
+
+  std::size_t count = 0;
+  for(const xmlAttr * attribute = node->properties; attribute; attribute = attribute->next) {
+    ++count;
+  }
+
+  return count;
+}
+
+/**
+ * attribute
+ * @param index position of the attribute in the start tag, less than attribute_count()
+ */
+srcml_node_view::srcml_attribute_view srcml_node_view::attribute(std::size_t index) const {
+
+  srcml_attribute_view view;
+
+  if(event) {
+
+    const srcml_node::srcml_attribute & attribute = (event->attributes.begin() + index)->second;
+    view.name = attribute.name.str();
+    view.prefix = attribute.ns && attribute.ns->prefix ? boost::string_view(attribute.ns->prefix->str()) : boost::string_view();
+    view.uri = attribute.ns ? boost::string_view(attribute.ns->uri) : boost::string_view();
+    view.has_value = bool(attribute.value);
+    view.value = attribute.value ? boost::string_view(*attribute.value) : boost::string_view();
+    return view;
+
+  }
+
+  const xmlAttr * attribute = node->properties;
+  for(; index; --index) {
+    attribute = attribute->next;
+  }
+
+  view.name = view_of(attribute->name);
+  view.prefix = attribute->ns ? view_of(attribute->ns->prefix) : boost::string_view();
+  view.uri = attribute->ns ? view_of(attribute->ns->href) : boost::string_view(srcml_node::SRC_NAMESPACE->uri);
+  view.has_value = attribute->children && attribute->children->content;
+  view.value = view.has_value ? view_of(attribute->children->content) : boost::string_view();
+  return view;
+}
+
+/**
+ * find_attribute
+ * @param qualified_name attribute name with its prefix, if any, e.g., "pos:start"
+ * @param value the value if it is found
+ */
+bool srcml_node_view::find_attribute(boost::string_view qualified_name, boost::string_view & value) const {
+
+  const std::size_t count = attribute_count();
+  for(std::size_t index = 0; index < count; ++index) {
+
+    srcml_attribute_view found = attribute(index);
+    bool matches = found.prefix.empty() ? qualified_name == found.name
+      : qualified_name.size() == found.prefix.size() + 1 + found.name.size()
+        && qualified_name.starts_with(found.prefix) && qualified_name[found.prefix.size()] == ':'
+        && qualified_name.ends_with(found.name);
+    if(!matches) continue;
+
+    value = found.value;
+    return true;
+
+  }
+
+  return false;
+}
+
+srcml_node srcml_node_view::materialize() const {
+
+  srcml_node materialized;
+  materialize(materialized);
+  return materialized;
+}
+
+/**
+ * materialize
+ * @param materialized node to overwrite, reusing its storage
+ * @param cache optional per-reader cache of libxml2 lookups
+ */
+void srcml_node_view::materialize(srcml_node & materialized, srcml_node::srcml_libxml_cache * cache) const {
+
+  if(event) {
+    if(&materialized != event) materialized = *event;
+    return;
+  }
+
+  if(!node) {
+    materialized.clear();
+    return;
+  }
+
+  // node types and reader types agree for elements, text and the rest, which are OTHER
+  materialized.assign(*node, (xmlElementType)node->type, cache);
+  materialized.type = node_type;
+  materialized.empty = empty;
+
+  if(!with_attributes) {
+    materialized.attributes.clear();
+    materialized.ns_definition.clear();
+  }
+
+}
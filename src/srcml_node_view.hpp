@@ -0,0 +1,102 @@
+/*
+  srcml_node_view.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_NODE_VIEW_HPP
+#define INCLUDED_SRCML_NODE_VIEW_HPP
+
+#include <srcml_node.hpp>
+
+#include <libxml/tree.h>
+
+#include <boost/utility/string_view.hpp>
+
+#include <cstddef>
+
+/**
+ * srcml_node_view
+ *
+ * Read-only access to the node a srcml_reader is on without building a
+ * srcml_node.  With the xmlTextReader backend names, content and
+ * attributes are read from the current libxml2 node; otherwise the view
+ * wraps the node the reader already has.  A view is only valid until
+ * the reader advances.  materialize() builds the srcml_node the
+ * reader's iterator would give.
+ *
+ * A node without a namespace is in srcml_node::SRC_NAMESPACE, as in
+ * srcml_node.  Prefixes from libxml2 are those of the document.
+ */
+class srcml_node_view {
+
+public:
+
+  class srcml_attribute_view {
+
+  public:
+
+    boost::string_view name;
+    boost::string_view prefix;
+    boost::string_view uri;
+    boost::string_view value;
+    bool has_value;
+
+  };
+
+private:
+
+  srcml_node::srcml_node_type node_type;
+  const xmlNode * node;
+  const srcml_node * event;
+  bool empty;
+  bool with_attributes;
+
+public:
+
+  srcml_node_view();
+  srcml_node_view(const xmlNode * node, srcml_node::srcml_node_type type, bool empty, bool with_attributes = true);
+  explicit srcml_node_view(const srcml_node * event);
+
+  srcml_node::srcml_node_type type() const { return event ? event->type : node_type; }
+  bool is_start() const { return type() == srcml_node::srcml_node_type::START; }
+  bool is_end() const { return type() == srcml_node::srcml_node_type::END; }
+  bool is_text() const { return type() == srcml_node::srcml_node_type::TEXT; }
+  bool is_empty() const { return event ? event->empty : empty; }
+
+  boost::string_view name() const;
+  boost::string_view prefix() const;
+  boost::string_view uri() const;
+
+  bool has_content() const;
+  boost::string_view content() const;
+
+  std::size_t attribute_count() const;
+  srcml_attribute_view attribute(std::size_t index) const;
+  bool find_attribute(boost::string_view qualified_name, boost::string_view & value) const;
+
+  srcml_node materialize() const;
+  void materialize(srcml_node & node, srcml_node::srcml_libxml_cache * cache = nullptr) const;
+
+  friend class srcml_reader;
+
+};
+
+#endif
@@ -0,0 +1,198 @@
+/*
+  srcml_parallel_reader.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_parallel_reader.hpp>
+#include <srcml_reader.hpp>
+
+#include <libxml/xmlreader.h>
+
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <map>
+
+srcml_parallel_reader::srcml_parallel_reader(const std::string & filename, std::size_t threads)
+  : input(new srcml_mapped_input(filename)), locator(new srcml_unit_locator(input->data(), input->size())),
+    threads(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+
+  // libxml2 must be initialized before readers are created on the worker threads
+  xmlInitParser();
+
+}
+
+srcml_parallel_reader::~srcml_parallel_reader() {}
+
+std::size_t srcml_parallel_reader::size() const {
+  return locator->get_units().size();
+}
+
+void srcml_parallel_reader::read_unit(std::size_t unit_number, std::vector<srcml_node> & nodes) const {
+
+  const srcml_unit_locator::srcml_unit_range & range = locator->get_units()[unit_number];
+
+  std::unique_ptr<srcml_input> unit(new srcml_unit_input(input->data(), locator->is_archive() ? locator->get_prolog_size() : 0,
+                                                         input->data() + range.offset, range.length,
+                                                         locator->is_archive() ? locator->get_root_end_tag() : std::string()));
+
+  srcml_reader reader(std::move(unit), locator->is_archive(), srcml_reader::srcml_backend::PUSH_PARSER);
+  for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end();) {
+    nodes.push_back(itr++);
+  }
+
+}
+
+/**
+ * read
+ * @param callback receives each unit
+ * @param order ARCHIVE_ORDER or COMPLETION_ORDER
+ *
+ * In ARCHIVE_ORDER the callback runs on the calling thread, one unit at
+ * a time in archive order, and workers stay at most a few units ahead
+ * of it.  In COMPLETION_ORDER the callback runs on the worker threads
+ * as soon as a unit is parsed, so it must be thread-safe.  The first
+ * exception thrown by a worker or the callback stops reading and is
+ * rethrown here.
+ */
+void srcml_parallel_reader::read(const unit_callback & callback, srcml_delivery_order order) {
+
+  const std::size_t count = size();
+  const std::size_t workers = std::min(threads, count);
+  const std::size_t window = 4 * workers;
+  if(!count) return;
+
+  std::mutex mutex;
+  std::condition_variable ready;
+  std::condition_variable space;
+  std::size_t next_unit = 0;
+  std::size_t next_delivery = 0;
+  std::map<std::size_t, std::vector<srcml_node>> completed;
+  std::exception_ptr error;
+  bool stop = false;
+
+  auto fail = [&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if(!error) error = std::current_exception();
+    stop = true;
+    ready.notify_all();
+    space.notify_all();
+  };
+
+  auto work = [&]() {
+
+    std::vector<srcml_node> nodes;
+    while(true) {
+
+      std::size_t unit_number = 0;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        if(order == ARCHIVE_ORDER) space.wait(lock, [&]() { return stop || next_unit < next_delivery + window; });
+        if(stop || next_unit >= count) return;
+        unit_number = next_unit++;
+      }
+
+      try {
+
+        nodes.clear();
+        read_unit(unit_number, nodes);
+
+        if(order == COMPLETION_ORDER) {
+          callback(unit_number, nodes);
+          continue;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        completed.emplace(unit_number, std::move(nodes));
+        ready.notify_all();
+
+      } catch(...) {
+        fail();
+        return;
+      }
+
+    }
+
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(workers);
+  try {
+
+    for(std::size_t i = 0; i < workers; ++i) {
+      pool.emplace_back(work);
+    }
+
+  } catch(...) {
+
+    // joinable threads must not be destroyed, so stop and join those started
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+      space.notify_all();
+    }
+
+    for(std::thread & worker : pool) {
+      worker.join();
+    }
+
+    throw;
+  }
+
+  if(order == ARCHIVE_ORDER) {
+
+    while(true) {
+
+      std::vector<srcml_node> nodes;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [&]() { return stop || next_delivery == count || completed.count(next_delivery); });
+        if(stop || next_delivery == count) break;
+
+        std::map<std::size_t, std::vector<srcml_node>>::iterator itr = completed.find(next_delivery);
+        nodes = std::move(itr->second);
+        completed.erase(itr);
+      }
+
+      try {
+        callback(next_delivery, nodes);
+      } catch(...) {
+        fail();
+        break;
+      }
+
+      std::lock_guard<std::mutex> lock(mutex);
+      ++next_delivery;
+      space.notify_all();
+
+    }
+
+  }
+
+  for(std::thread & worker : pool) {
+    worker.join();
+  }
+
+  if(error) std::rethrow_exception(error);
+
+}
@@ -0,0 +1,77 @@
+/*
+  srcml_parallel_reader.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_PARALLEL_READER_HPP
+#define INCLUDED_SRCML_PARALLEL_READER_HPP
+
+#include <srcml_node.hpp>
+#include <srcml_unit_locator.hpp>
+#include <srcml_input.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+
+/**
+ * srcml_parallel_reader
+ *
+ * Reads the units of a memory-mapped srcML archive on several threads.  Unit
+ * boundaries are located up front, then each worker parses whole units
+ * with its own srcml_reader, using the push parser backend.  A unit is
+ * parsed together with a copy of the archive's root start tag, so its
+ * namespaces and element stack are the same as when reading the
+ * archive sequentially.
+ */
+class srcml_parallel_reader {
+
+public:
+
+  enum srcml_delivery_order : unsigned int { ARCHIVE_ORDER = 0, COMPLETION_ORDER = 1 };
+
+  /**
+   * Receives the zero-based position of a unit in the archive and all of
+   * its nodes, from its start tag to its end tag.
+   */
+  typedef std::function<void (std::size_t unit_number, std::vector<srcml_node> & unit)> unit_callback;
+
+private:
+
+  std::unique_ptr<srcml_mapped_input> input;
+  std::unique_ptr<srcml_unit_locator> locator;
+  std::size_t threads;
+
+  void read_unit(std::size_t unit_number, std::vector<srcml_node> & nodes) const;
+
+public:
+
+  srcml_parallel_reader(const std::string & filename, std::size_t threads = 0);
+  ~srcml_parallel_reader();
+
+  std::size_t size() const;
+
+  void read(const unit_callback & callback, srcml_delivery_order order = ARCHIVE_ORDER);
+
+};
+
+#endif
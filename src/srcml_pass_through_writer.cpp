@@ -0,0 +1,302 @@
+/*
+  srcml_pass_through_writer.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_pass_through_writer.hpp>
+#include <srcml_input.hpp>
+
+#include <stdexcept>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+class srcml_pass_through_writer_error : public std::runtime_error {
+public:
+  srcml_pass_through_writer_error(const std::string & what_arg) : std::runtime_error(what_arg) {}
+
+};
+
+static const std::size_t npos = srcml_reader::npos;
+
+static const srcml_unit_locator & tracked_units(const srcml_reader & reader) {
+
+  if(!reader.get_unit_locator()) throw srcml_pass_through_writer_error("Reader does not track units");
+  return *reader.get_unit_locator();
+
+}
+
+srcml_pass_through_writer::srcml_pass_through_writer(const std::string & filename, srcml_reader & reader)
+  : reader(reader), locator(tracked_units(reader)), source(nullptr), source_size(0),
+    out(filename, std::ios::out | std::ios::binary | std::ios::trunc), buffer(),
+    copied(0), unit(npos), next_unit(0), modified(false), depth(0), passed(0), last_position(0) {
+
+  // a reader only tracks units of a document in memory
+  const srcml_memory_input & input = dynamic_cast<const srcml_memory_input &>(*reader.input);
+  source = input.data();
+  source_size = input.size();
+
+  if(!out) throw srcml_pass_through_writer_error("Error opening: " + filename);
+
+  buffer.reserve(FLUSH_SIZE + 1024);
+
+}
+
+srcml_pass_through_writer::~srcml_pass_through_writer() {
+  try {
+    finish();
+    flush();
+  } catch(const std::exception &) {}
+}
+
+/**
+ * write
+ * @param node the next node of the document
+ *
+ * A node is the reader's if it is the node the reader is on, and in
+ * sequence if nothing was left out since the last of the reader's
+ * nodes written.  Only those keep a unit unmodified.  Nodes between
+ * units may be left out.
+ */
+bool srcml_pass_through_writer::write(const srcml_node & node) {
+
+  const bool from_reader = &node == reader.current_node;
+  bool in_sequence = from_reader && reader.position == last_position + 1;
+  if(from_reader) last_position = reader.position;
+
+  if(from_reader && reader.unit_number != npos && reader.unit_number >= next_unit) {
+    start_unit(node);
+    in_sequence = true;
+  }
+
+  if(unit == npos) {
+    if(!from_reader) {
+      if(locator.is_archive()) copy(locator.get_prolog_size());
+      write_node(node);
+    }
+    return true;
+  }
+
+  if(!modified && (!in_sequence || reader.unit_modified)) modify_unit();
+
+  if(modified) {
+    write_node(node);
+  } else {
+    ++passed;
+  }
+
+  if(node.is_start() && !node.is_empty()) {
+    ++depth;
+  } else if(node.is_end() && depth && !--depth) {
+
+    const srcml_unit_locator::srcml_unit_range & range = locator.get_units()[unit];
+    if(modified) {
+      copied = range.offset + range.length;
+    } else {
+      copy(range.offset + range.length);
+    }
+    unit = npos;
+
+  }
+
+  return true;
+}
+
+/**
+ * write
+ * @param itr an iterator of the reader
+ *
+ * Write the iterator's node without taking it as modified.
+ */
+bool srcml_pass_through_writer::write(const srcml_reader::srcml_reader_iterator & itr) {
+  return write(*itr);
+}
+
+/**
+ * start_unit
+ * @param node the reader's first node of a unit
+ *
+ * Copy the source up to the unit, leaving out any units that were not
+ * written.  A unit is only passed through from its start tag.
+ */
+void srcml_pass_through_writer::start_unit(const srcml_node & node) {
+
+  // a unit whose end tag was never written ends here
+  if(unit != npos && !modified) modify_unit();
+
+  const std::vector<srcml_unit_locator::srcml_unit_range> & units = locator.get_units();
+  unit = reader.unit_number;
+  next_unit = unit + 1;
+
+  if(locator.is_archive()) copy(locator.get_prolog_size());
+  if(unit) copied = std::max(copied, units[unit - 1].offset + units[unit - 1].length);
+  copy(units[unit].offset);
+
+  modified = !node.is_start();
+  depth = 0;
+  passed = 0;
+
+}
+
+/**
+ * modify_unit
+ *
+ * Switch the current unit to being written node by node, writing the
+ * nodes passed over so far from a reader of the unit in the source.
+ */
+void srcml_pass_through_writer::modify_unit() {
+
+  modified = true;
+  if(!passed) return;
+
+  const srcml_unit_locator::srcml_unit_range & range = locator.get_units()[unit];
+  const bool archive = locator.is_archive();
+  std::unique_ptr<srcml_input> input(new srcml_unit_input(source, archive ? locator.get_prolog_size() : 0,
+                                                          source + range.offset, range.length,
+                                                          archive ? locator.get_root_end_tag() : std::string()));
+
+  srcml_reader unit_reader(std::move(input), archive, srcml_reader::srcml_backend::PUSH_PARSER);
+  unit_reader.set_split_text(reader.split_text);
+  std::size_t count = 0;
+  for(srcml_reader::srcml_reader_iterator itr = unit_reader.begin(); count < passed && itr != unit_reader.end(); ++itr, ++count) {
+    write_node(*itr);
+  }
+
+}
+
+/**
+ * finish
+ *
+ * Copy what follows the last unit in the source.
+ */
+void srcml_pass_through_writer::finish() {
+
+  if(unit != npos && !modified) modify_unit();
+
+  const std::vector<srcml_unit_locator::srcml_unit_range> & units = locator.get_units();
+  if(locator.is_archive()) copy(locator.get_prolog_size());
+  if(!units.empty()) copied = std::max(copied, units.back().offset + units.back().length);
+  copy(source_size);
+
+}
+
+/**
+ * copy
+ * @param end offset in the source
+ *
+ * Write the source from where copying left off up to end.  Large
+ * ranges bypass the buffer.
+ */
+void srcml_pass_through_writer::copy(std::size_t end) {
+
+  if(end <= copied) return;
+
+  const std::size_t size = end - copied;
+  if(size < FLUSH_SIZE) {
+    buffer.append(source + copied, size);
+    if(buffer.size() >= FLUSH_SIZE) flush();
+  } else {
+    flush();
+    out.write(source + copied, size);
+    if(!out) throw srcml_pass_through_writer_error("Error writing srcML");
+  }
+  copied = end;
+
+}
+
+void srcml_pass_through_writer::write_node(const srcml_node & node) {
+
+  switch(node.type) {
+
+    case srcml_node::srcml_node_type::START:
+      buffer += '<';
+      buffer += node.full_name();
+      for(const std::shared_ptr<srcml_node::srcml_namespace> & ns : node.ns_definition) {
+        buffer += " xmlns";
+        if(ns->prefix) {
+          buffer += ':';
+          buffer += ns->prefix->str();
+        }
+        buffer += "=\"";
+        write_escaped(ns->uri, true);
+        buffer += '"';
+      }
+      for(const srcml_node::srcml_attribute_map_pair & attr : node.attributes) {
+        buffer += ' ';
+        buffer += attr.second.full_name();
+        buffer += "=\"";
+        if(attr.second.value) write_escaped(*attr.second.value, true);
+        buffer += '"';
+      }
+      buffer += node.is_empty() ? "/>" : ">";
+      break;
+
+    case srcml_node::srcml_node_type::END:
+      buffer += "</";
+      buffer += node.full_name();
+      buffer += '>';
+      break;
+
+    case srcml_node::srcml_node_type::TEXT:
+      if(node.content) write_escaped(node.content.view(), false);
+      break;
+
+    default:
+      throw srcml_pass_through_writer_error("Invalid srcml_node type: " + std::to_string(node.type));
+
+  }
+
+  if(buffer.size() >= FLUSH_SIZE) flush();
+
+}
+
+/** '>' is escaped as srcML does, and '"' only in attribute values */
+void srcml_pass_through_writer::write_escaped(boost::string_view text, bool attribute) {
+
+  std::size_t start = 0;
+  for(std::size_t pos = 0; pos < text.size(); ++pos) {
+
+    const char * entity = nullptr;
+    switch(text[pos]) {
+      case '&': entity = "&amp;"; break;
+      case '<': entity = "&lt;"; break;
+      case '>': entity = "&gt;"; break;
+      case '"': if(!attribute) continue; entity = "&quot;"; break;
+      default: continue;
+    }
+
+    buffer.append(text.data() + start, pos - start);
+    buffer += entity;
+    start = pos + 1;
+
+  }
+  buffer.append(text.data() + start, text.size() - start);
+
+}
+
+void srcml_pass_through_writer::flush() {
+
+  out.write(buffer.data(), buffer.size());
+  buffer.clear();
+
+  if(!out) throw srcml_pass_through_writer_error("Error writing srcML");
+
+}
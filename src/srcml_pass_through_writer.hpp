@@ -0,0 +1,100 @@
+/*
+  srcml_pass_through_writer.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_PASS_THROUGH_WRITER_HPP
+#define INCLUDED_SRCML_PASS_THROUGH_WRITER_HPP
+
+#include <srcml_node.hpp>
+#include <srcml_reader.hpp>
+#include <srcml_unit_locator.hpp>
+
+#include <string>
+#include <fstream>
+#include <cstddef>
+
+#include <boost/utility/string_view.hpp>
+
+class srcml_pass_through_writer_error;
+
+/**
+ * srcml_pass_through_writer
+ *
+ * Writes back a document as it is read by a srcml_reader that tracks
+ * its units, copying every unit that was not modified byte for byte
+ * from the source.  Nodes are written from the reader's iterator as
+ * they are read.  A unit is written node by node as XML once it is
+ * modified: the reader marks it, or a node is written that is not the
+ * reader's current node, or nodes are left out.  Nodes of the unit
+ * passed over before that are read again from the source.
+ *
+ * Taking a node through a non-const iterator marks its unit as
+ * modified, so unchanged nodes are written by passing the iterator,
+ * which only reads the node, e.g., write(itr) rather than write(*itr).
+ *
+ * Outside of units, e.g., the root start tag of an archive, the source
+ * is copied and the reader's nodes are not written; other nodes are
+ * written as XML where they occur.  Whatever follows the last unit is
+ * copied when the writer is destroyed.
+ */
+class srcml_pass_through_writer {
+
+private:
+
+  static const std::size_t FLUSH_SIZE = 1 << 16;
+
+  srcml_reader & reader;
+  const srcml_unit_locator & locator;
+  const char * source;
+  std::size_t source_size;
+
+  std::ofstream out;
+  std::string buffer;
+
+  std::size_t copied;
+  std::size_t unit;
+  std::size_t next_unit;
+  bool modified;
+  std::size_t depth;
+  std::size_t passed;
+  std::size_t last_position;
+
+  void start_unit(const srcml_node & node);
+  void modify_unit();
+  void finish();
+
+  void copy(std::size_t end);
+  void write_node(const srcml_node & node);
+  void write_escaped(boost::string_view text, bool attribute);
+  void flush();
+
+public:
+
+  srcml_pass_through_writer(const std::string & filename, srcml_reader & reader);
+  ~srcml_pass_through_writer();
+
+  bool write(const srcml_node & node);
+  bool write(const srcml_reader::srcml_reader_iterator & itr);
+
+};
+
+#endif
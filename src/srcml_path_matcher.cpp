@@ -0,0 +1,351 @@
+/*
+  srcml_path_matcher.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_path_matcher.hpp>
+
+#include <stdexcept>
+#include <algorithm>
+#include <cctype>
+
+class srcml_path_matcher_error : public std::runtime_error {
+public:
+  srcml_path_matcher_error(const std::string & what_arg) : std::runtime_error(what_arg) {}
+
+};
+
+static const std::size_t MAX_CACHED_PREDICATES = 64;
+
+bool srcml_path_matcher::srcml_predicate::matches(const srcml_node & node) const {
+
+  srcml_node::srcml_attribute_map_citr itr = node.attributes.find(attribute);
+  if(itr == node.attributes.end()) return false;
+  if(!value) return true;
+
+  bool equal = itr->second.value && *itr->second.value == *value;
+  return equal != negated;
+}
+
+bool srcml_path_matcher::srcml_predicate::operator==(const srcml_predicate & that) const {
+  return attribute == that.attribute && value == that.value && negated == that.negated;
+}
+
+/** true if a node satisfies every predicate of the edge */
+bool srcml_path_matcher::srcml_edge::matches(const srcml_node & node) const {
+  return std::all_of(predicates.begin(), predicates.end(),
+                     [&node](const srcml_predicate & predicate) { return predicate.matches(node); });
+}
+
+/**
+ * query_parser
+ *
+ * Recursive descent over the query subset, one step at a time.
+ */
+class query_parser {
+
+private:
+
+  const std::string & query;
+  std::size_t pos;
+
+  bool is_name_char(char ch) const {
+    return std::isalnum((unsigned char)ch) || ch == '_' || ch == '-' || ch == '.' || ch == ':';
+  }
+
+  [[noreturn]] void error(const std::string & message) const {
+    throw srcml_path_matcher_error(message + " at position " + std::to_string(pos) + " in query: " + query);
+  }
+
+public:
+
+  query_parser(const std::string & query) : query(query), pos(0) {}
+
+  bool at_end() const { return pos == query.size(); }
+
+  bool accept(const char * token) {
+    std::size_t length = std::char_traits<char>::length(token);
+    if(query.compare(pos, length, token) != 0) return false;
+    pos += length;
+    return true;
+  }
+
+  void expect(const char * token) {
+    if(!accept(token)) error(std::string("Expected '") + token + "'");
+  }
+
+  std::string name() {
+
+    if(accept("*")) return std::string();
+
+    std::size_t start = pos;
+    while(pos < query.size() && is_name_char(query[pos])) ++pos;
+    if(start == pos) error("Expected a name");
+
+    return query.substr(start, pos - start);
+  }
+
+  std::string literal() {
+
+    if(pos == query.size() || (query[pos] != '\'' && query[pos] != '"')) error("Expected a quoted value");
+
+    char quote = query[pos++];
+    std::size_t end = query.find(quote, pos);
+    if(end == std::string::npos) error("Unterminated value");
+
+    std::string value = query.substr(pos, end - pos);
+    pos = end + 1;
+    return value;
+  }
+
+};
+
+srcml_path_matcher::srcml_path_matcher()
+  : nfa(), query_count(0), dfa(), dfa_ids(), transitions(), stack(), open(), started_queries(), ended_queries() {
+
+  add_state(false);
+  reset();
+
+}
+
+std::uint32_t srcml_path_matcher::add_state(bool self_loop) {
+  nfa.emplace_back(self_loop);
+  return nfa.size() - 1;
+}
+
+std::size_t srcml_path_matcher::add(const std::string & query) {
+
+  query_parser parser(query);
+
+  bool descendant = !parser.accept("/") || parser.accept("/");
+  std::uint32_t state = 0;
+
+  while(true) {
+
+    if(descendant) {
+      if(nfa[state].descendant == NONE) {
+        std::uint32_t loop = add_state(true);
+        nfa[state].descendant = loop;
+      }
+      state = nfa[state].descendant;
+    }
+
+    srcml_edge step;
+    std::string name = parser.name();
+    if(!name.empty()) step.name = srcml_symbol(name);
+
+    while(parser.accept("[")) {
+
+      srcml_predicate predicate;
+      parser.expect("@");
+      predicate.attribute = srcml_symbol(parser.name());
+      predicate.negated = false;
+
+      if(parser.accept("!=")) {
+        predicate.negated = true;
+        predicate.value = parser.literal();
+      } else if(parser.accept("=")) {
+        predicate.value = parser.literal();
+      }
+
+      parser.expect("]");
+      step.predicates.push_back(predicate);
+    }
+
+    // steps shared with an earlier query share states
+    std::vector<srcml_edge>::const_iterator itr = std::find_if(nfa[state].edges.begin(), nfa[state].edges.end(),
+      [&step](const srcml_edge & edge) { return edge.name == step.name && edge.predicates == step.predicates; });
+
+    if(itr != nfa[state].edges.end()) {
+      state = itr->target;
+    } else {
+      step.target = add_state(false);
+      nfa[state].edges.push_back(step);
+      state = step.target;
+    }
+
+    if(parser.at_end()) break;
+
+    parser.expect("/");
+    descendant = parser.accept("/");
+
+  }
+
+  std::size_t number = query_count++;
+  nfa[state].queries.push_back(number);
+  reset();
+
+  return number;
+}
+
+/**
+ * reset
+ *
+ * Forget the automaton built so far and any open matches.
+ */
+void srcml_path_matcher::reset() {
+
+  dfa.clear();
+  dfa_ids.clear();
+  transitions.clear();
+
+  stack.clear();
+  stack.push_back(intern(std::vector<std::uint32_t>(1, 0)));
+
+  open.assign(query_count, 0);
+  started_queries.clear();
+  ended_queries.clear();
+
+}
+
+/** state of the automaton for a set of NFA states, with descendant loops added */
+std::uint32_t srcml_path_matcher::intern(std::vector<std::uint32_t> states) {
+
+  std::size_t size = states.size();
+  for(std::size_t i = 0; i < size; ++i) {
+    if(nfa[states[i]].descendant != NONE) states.push_back(nfa[states[i]].descendant);
+  }
+
+  std::sort(states.begin(), states.end());
+  states.erase(std::unique(states.begin(), states.end()), states.end());
+
+  std::map<std::vector<std::uint32_t>, std::uint32_t>::const_iterator itr = dfa_ids.find(states);
+  if(itr != dfa_ids.end()) return itr->second;
+
+  srcml_dfa_state state;
+  for(std::uint32_t nfa_state : states) {
+    state.queries.insert(state.queries.end(), nfa[nfa_state].queries.begin(), nfa[nfa_state].queries.end());
+  }
+  std::sort(state.queries.begin(), state.queries.end());
+  state.states = states;
+
+  std::uint32_t id = dfa.size();
+  dfa.push_back(std::move(state));
+  dfa_ids.emplace(std::move(states), id);
+
+  return id;
+}
+
+/**
+ * get_transition
+ *
+ * Transition out of a state on an element name, computed on first use.
+ * Edges with predicates are kept aside to be checked per node.
+ */
+srcml_path_matcher::srcml_transition & srcml_path_matcher::get_transition(std::uint32_t state, srcml_symbol name) {
+
+  std::uint64_t key = (std::uint64_t(state) << 32) | name.id();
+  std::unordered_map<std::uint64_t, srcml_transition>::iterator itr = transitions.find(key);
+  if(itr != transitions.end()) return itr->second;
+
+  srcml_transition transition;
+  for(std::uint32_t nfa_state : dfa[state].states) {
+
+    if(nfa[nfa_state].self_loop) transition.base.push_back(nfa_state);
+
+    for(const srcml_edge & edge : nfa[nfa_state].edges) {
+
+      if(!edge.name.empty() && edge.name != name) continue;
+
+      if(edge.predicates.empty())
+        transition.base.push_back(edge.target);
+      else
+        transition.predicated.push_back(&edge);
+
+    }
+
+  }
+
+  transition.target = transition.predicated.empty() ? intern(transition.base) : NONE;
+
+  return transitions.emplace(key, std::move(transition)).first->second;
+}
+
+/**
+ * next_state
+ *
+ * The state after a start tag.  Which predicated edges a node takes is
+ * a bit set, so the usual case is a lookup of a state built before;
+ * the set of states is only built for a new outcome.
+ */
+std::uint32_t srcml_path_matcher::next_state(std::uint32_t state, const srcml_node & node) {
+
+  srcml_transition & transition = get_transition(state, node.qualified_name());
+  if(transition.target != NONE) return transition.target;
+
+  const bool cached = transition.predicated.size() <= MAX_CACHED_PREDICATES;
+  std::uint64_t outcome = 0;
+  if(cached) {
+
+    for(std::size_t i = 0; i < transition.predicated.size(); ++i) {
+      if(transition.predicated[i]->matches(node)) outcome |= std::uint64_t(1) << i;
+    }
+
+    std::unordered_map<std::uint64_t, std::uint32_t>::const_iterator itr = transition.outcomes.find(outcome);
+    if(itr != transition.outcomes.end()) return itr->second;
+
+  }
+
+  std::vector<std::uint32_t> states = transition.base;
+  for(std::size_t i = 0; i < transition.predicated.size(); ++i) {
+    if(cached ? (outcome >> i) & 1 : transition.predicated[i]->matches(node)) states.push_back(transition.predicated[i]->target);
+  }
+
+  std::uint32_t target = intern(states);
+  if(cached) transition.outcomes.emplace(outcome, target);
+
+  return target;
+}
+
+/**
+ * process
+ * @param node the next node from the reader
+ *
+ * Start tags advance the automaton and end tags return it to the state
+ * of the enclosing element.  Other nodes do not affect matching.
+ */
+void srcml_path_matcher::process(const srcml_node & node) {
+
+  started_queries.clear();
+  ended_queries.clear();
+
+  if(node.is_start()) {
+
+    std::uint32_t state = next_state(stack.back(), node);
+    stack.push_back(state);
+
+    for(std::size_t query : dfa[state].queries) {
+      started_queries.push_back(query);
+      ++open[query];
+    }
+
+  } else if(node.is_end() && stack.size() > 1) {
+
+    for(std::size_t query : dfa[stack.back()].queries) {
+      ended_queries.push_back(query);
+      --open[query];
+    }
+
+    stack.pop_back();
+
+  }
+
+}
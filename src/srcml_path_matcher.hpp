@@ -0,0 +1,161 @@
+/*
+  srcml_path_matcher.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_PATH_MATCHER_HPP
+#define INCLUDED_SRCML_PATH_MATCHER_HPP
+
+#include <srcml_node.hpp>
+#include <srcml_symbol.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <cstdint>
+
+#include <boost/optional.hpp>
+
+class srcml_path_matcher_error;
+
+/**
+ * srcml_path_matcher
+ *
+ * Streaming matcher for a subset of XPath over the nodes of a reader.
+ * A query is a path of child (/) and descendant (//) steps, each a
+ * qualified name or *, with optional attribute predicates [@name],
+ * [@name='value'] or [@name!='value'].  A query without a leading
+ * slash may start anywhere, as if it began with //.
+ *
+ *   //function//decl_stmt
+ *   /unit/unit[@language='C++']//cpp:include
+ *
+ * All queries are compiled into one automaton whose states are built
+ * lazily and cached, so the cost of a node does not depend on the
+ * number of queries.  Feed every node to process(); after each start
+ * tag started() lists the queries it matches and after each end tag
+ * ended() lists the matches it closes.
+ */
+class srcml_path_matcher {
+
+private:
+
+  static const std::uint32_t NONE = std::uint32_t(-1);
+
+  class srcml_predicate {
+
+  public:
+
+    srcml_symbol attribute;
+    boost::optional<std::string> value;
+    bool negated;
+
+    bool matches(const srcml_node & node) const;
+    bool operator==(const srcml_predicate & that) const;
+
+  };
+
+  class srcml_edge {
+
+  public:
+
+    srcml_symbol name;
+    std::vector<srcml_predicate> predicates;
+    std::uint32_t target;
+
+    bool matches(const srcml_node & node) const;
+
+  };
+
+  class srcml_nfa_state {
+
+  public:
+
+    std::vector<srcml_edge> edges;
+    std::uint32_t descendant;
+    bool self_loop;
+    std::vector<std::size_t> queries;
+
+    srcml_nfa_state(bool self_loop = false) : edges(), descendant(NONE), self_loop(self_loop), queries() {}
+
+  };
+
+  class srcml_dfa_state {
+
+  public:
+
+    std::vector<std::uint32_t> states;
+    std::vector<std::size_t> queries;
+
+  };
+
+  class srcml_transition {
+
+  public:
+
+    std::uint32_t target;
+    std::vector<std::uint32_t> base;
+    std::vector<const srcml_edge *> predicated;
+    std::unordered_map<std::uint64_t, std::uint32_t> outcomes;
+
+  };
+
+  std::vector<srcml_nfa_state> nfa;
+  std::size_t query_count;
+
+  std::vector<srcml_dfa_state> dfa;
+  std::map<std::vector<std::uint32_t>, std::uint32_t> dfa_ids;
+  std::unordered_map<std::uint64_t, srcml_transition> transitions;
+
+  std::vector<std::uint32_t> stack;
+  std::vector<std::size_t> open;
+  std::vector<std::size_t> started_queries;
+  std::vector<std::size_t> ended_queries;
+
+  std::uint32_t add_state(bool self_loop);
+  std::uint32_t intern(std::vector<std::uint32_t> states);
+  srcml_transition & get_transition(std::uint32_t state, srcml_symbol name);
+  std::uint32_t next_state(std::uint32_t state, const srcml_node & node);
+
+public:
+
+  srcml_path_matcher();
+
+  /** compile a query, returning its number; the matcher is reset */
+  std::size_t add(const std::string & query);
+  std::size_t size() const { return query_count; }
+
+  void process(const srcml_node & node);
+  void reset();
+
+  /** queries matched by the last node, if it was a start tag */
+  const std::vector<std::size_t> & started() const { return started_queries; }
+
+  /** queries whose matches the last node closed, if it was an end tag */
+  const std::vector<std::size_t> & ended() const { return ended_queries; }
+
+  /** true if the current position is inside a match of the query */
+  bool is_inside(std::size_t query) const { return open[query] != 0; }
+
+};
+
+#endif
@@ -0,0 +1,257 @@
+/*
+  srcml_pipelined_reader.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_pipelined_reader.hpp>
+#include <srcml_back_off.hpp>
+
+#include <algorithm>
+
+const std::size_t srcml_pipelined_reader::DEFAULT_BATCH_SIZE;
+const std::size_t srcml_pipelined_reader::DEFAULT_BATCHES;
+
+/**
+ * srcml_pipelined_reader
+ * @param filename srcML document to read
+ * @param backend parser of the background reader
+ * @param batch_size nodes handed over at a time
+ * @param batches batches in flight, which bounds memory
+ */
+srcml_pipelined_reader::srcml_pipelined_reader(const std::string & filename, srcml_reader::srcml_backend backend,
+                                               std::size_t batch_size, std::size_t batches)
+  : srcml_pipelined_reader(std::unique_ptr<srcml_reader>(new srcml_reader(filename, backend)), batch_size, batches) {}
+
+/**
+ * srcml_pipelined_reader
+ * @param reader reader to run on the background thread, e.g., with an
+ * element filter set; it must not have been advanced
+ * @param batch_size nodes handed over at a time
+ * @param batches batches in flight, which bounds memory
+ */
+srcml_pipelined_reader::srcml_pipelined_reader(std::unique_ptr<srcml_reader> reader, std::size_t batch_size, std::size_t batches)
+  : reader(std::move(reader)), batch_size(std::max<std::size_t>(batch_size, 1)), batch_pool(),
+    full(std::max<std::size_t>(batches, 1)), empty(std::max<std::size_t>(batches, 1)), stop(false), producer(),
+    batch(nullptr), position(0), is_eof(false), end_node(), element_path(), iterator() {
+
+  start(std::max<std::size_t>(batches, 1));
+
+}
+
+srcml_pipelined_reader::~srcml_pipelined_reader() {
+
+  stop = true;
+  if(producer.joinable()) producer.join();
+
+}
+
+void srcml_pipelined_reader::start(std::size_t batch_count) {
+
+  for(std::size_t i = 0; i < batch_count; ++i) {
+    batch_pool.emplace_back(new srcml_batch());
+    empty.push(batch_pool.back().get());
+  }
+
+  producer = std::thread(&srcml_pipelined_reader::produce, this);
+
+}
+
+/**
+ * produce
+ *
+ * Body of the background thread.  Fills free batches from the reader
+ * until the end of the document, an error, or the pipelined reader is
+ * destroyed.  The last batch is flagged, and carries the error if
+ * there was one.
+ */
+void srcml_pipelined_reader::produce() {
+
+  srcml_batch * current = nullptr;
+
+  auto acquire = [this]() -> srcml_batch * {
+
+    srcml_batch * free_batch = nullptr;
+    srcml_back_off back_off;
+    while(!empty.pop(free_batch)) {
+      if(stop) return nullptr;
+      back_off.wait();
+    }
+
+    free_batch->size = 0;
+    free_batch->error = nullptr;
+    free_batch->last = false;
+    return free_batch;
+
+  };
+
+  try {
+
+    srcml_reader::srcml_reader_iterator itr = reader->begin();
+    bool more = itr != reader->end();
+    while(true) {
+
+      current = acquire();
+      if(!current) return;
+
+      while(more && current->size < batch_size) {
+        if(current->size == current->nodes.size()) current->nodes.emplace_back();
+        current->nodes[current->size++] = *itr;
+        ++itr;
+        more = itr != reader->end();
+      }
+
+      current->last = !more;
+      full.push(current);
+      if(!more) return;
+      current = nullptr;
+
+    }
+
+  } catch(...) {
+
+    if(!current) current = acquire();
+    if(!current) return;
+
+    current->error = std::current_exception();
+    current->last = true;
+    full.push(current);
+
+  }
+
+}
+
+/**
+ * read
+ *
+ * Move to the next node, returning a finished batch and waiting for the
+ * next one when the current batch runs out.
+ */
+bool srcml_pipelined_reader::read() {
+
+  if(is_eof) return false;
+
+  ++position;
+  while(!batch || position >= batch->size) {
+
+    if(batch) {
+
+      if(batch->last) {
+        is_eof = true;
+        if(batch->error) {
+          std::exception_ptr error = batch->error;
+          batch->error = nullptr;
+          std::rethrow_exception(error);
+        }
+        return false;
+      }
+
+      empty.push(batch);
+      batch = nullptr;
+
+    }
+
+    srcml_back_off back_off;
+    while(!full.pop(batch)) {
+      back_off.wait();
+    }
+    position = 0;
+
+  }
+
+  const srcml_node & node = batch->nodes[position];
+  if(node.is_start()) {
+    element_path.push(node.qualified_name());
+  } else if(node.is_end()) {
+    element_path.pop();
+  }
+
+  return true;
+}
+
+/**
+ * current
+ *
+ * The current node, or an empty node at the end.
+ */
+srcml_node & srcml_pipelined_reader::current() {
+  return *this ? batch->nodes[position] : end_node;
+}
+
+srcml_pipelined_reader::srcml_pipelined_reader_iterator srcml_pipelined_reader::begin() {
+
+  if(!iterator.reader) {
+    iterator.reader = this;
+    read();
+  }
+
+  return iterator;
+}
+
+srcml_pipelined_reader::srcml_pipelined_reader_iterator srcml_pipelined_reader::end() {
+  return srcml_pipelined_reader_iterator();
+}
+
+srcml_pipelined_reader::operator bool() const {
+  return batch && !is_eof;
+}
+
+srcml_pipelined_reader::srcml_pipelined_reader_iterator::srcml_pipelined_reader_iterator(srcml_pipelined_reader * reader)
+  : reader(reader) {}
+
+const srcml_node & srcml_pipelined_reader::srcml_pipelined_reader_iterator::operator*() const {
+  return reader->current();
+}
+
+srcml_node & srcml_pipelined_reader::srcml_pipelined_reader_iterator::operator*() {
+  return reader->current();
+}
+
+const srcml_node * srcml_pipelined_reader::srcml_pipelined_reader_iterator::operator->() const {
+  return &reader->current();
+}
+
+srcml_node * srcml_pipelined_reader::srcml_pipelined_reader_iterator::operator->() {
+  return &reader->current();
+}
+
+const srcml_node & srcml_pipelined_reader::srcml_pipelined_reader_iterator::operator++() {
+
+  reader->read();
+  return reader->current();
+
+}
+
+/**
+ * operator++(int)
+ *
+ * The current node is moved out of its batch rather than copied.
+ */
+srcml_node srcml_pipelined_reader::srcml_pipelined_reader_iterator::operator++(int) {
+
+  srcml_node node = std::move(reader->current());
+  reader->read();
+  return node;
+
+}
+
+bool srcml_pipelined_reader::srcml_pipelined_reader_iterator::operator!=(const srcml_pipelined_reader_iterator &) const {
+  return *reader;
+}
@@ -0,0 +1,148 @@
+/*
+  srcml_pipelined_reader.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_PIPELINED_READER_HPP
+#define INCLUDED_SRCML_PIPELINED_READER_HPP
+
+#include <srcml_reader.hpp>
+#include <srcml_element_path.hpp>
+
+#include <boost/lockfree/spsc_queue.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <exception>
+
+/**
+ * srcml_pipelined_reader
+ *
+ * Runs a srcml_reader on a background thread, so parsing overlaps with
+ * whatever the caller does with each node.  The reader hands batches of
+ * nodes to the caller through a single-producer/single-consumer
+ * lock-free queue, and the caller returns the batches through a second
+ * queue once it has read them.  A fixed number of batches are used.
+ * When they are all full, the reader waits, which bounds memory to
+ * batch_size * batches nodes.
+ *
+ * Nodes are read with the same begin()/end() iteration as srcml_reader.
+ * The element path follows the nodes as the caller reads them, and the
+ * background reader is not otherwise accessible once started.  If the
+ * reader throws, the nodes read before the error are delivered first,
+ * and then the exception is rethrown by the caller's advance.
+ */
+class srcml_pipelined_reader {
+
+public:
+
+  class srcml_pipelined_reader_iterator {
+
+  private:
+
+    srcml_pipelined_reader * reader;
+    srcml_pipelined_reader_iterator(srcml_pipelined_reader * reader = nullptr);
+
+  public:
+
+    const srcml_node & operator*() const;
+    srcml_node & operator*();
+    const srcml_node * operator->() const;
+    srcml_node * operator->();
+    const srcml_node & operator++();
+    srcml_node operator++(int);
+    bool operator!=(const srcml_pipelined_reader_iterator & that) const;
+
+    friend class srcml_pipelined_reader;
+
+  };
+
+  static const std::size_t DEFAULT_BATCH_SIZE = 512;
+  static const std::size_t DEFAULT_BATCHES = 8;
+
+private:
+
+  /**
+   * srcml_batch
+   *
+   * The first size nodes are in use.  Nodes are copied into the slots
+   * of earlier rounds, so their storage is reused.
+   */
+  class srcml_batch {
+
+  public:
+
+    std::vector<srcml_node> nodes;
+    std::size_t size;
+    std::exception_ptr error;
+    bool last;
+
+    srcml_batch() : nodes(), size(0), error(), last(false) {}
+
+  };
+
+  std::unique_ptr<srcml_reader> reader;
+  std::size_t batch_size;
+
+  std::vector<std::unique_ptr<srcml_batch>> batch_pool;
+  boost::lockfree::spsc_queue<srcml_batch *> full;
+  boost::lockfree::spsc_queue<srcml_batch *> empty;
+  std::atomic<bool> stop;
+  std::thread producer;
+
+  srcml_batch * batch;
+  std::size_t position;
+  bool is_eof;
+  srcml_node end_node;
+  srcml_element_path element_path;
+
+  srcml_pipelined_reader_iterator iterator;
+
+  void start(std::size_t batch_count);
+  void produce();
+  bool read();
+  srcml_node & current();
+
+public:
+
+  srcml_pipelined_reader(const std::string & filename,
+                         srcml_reader::srcml_backend backend = srcml_reader::srcml_backend::TEXT_READER,
+                         std::size_t batch_size = DEFAULT_BATCH_SIZE, std::size_t batches = DEFAULT_BATCHES);
+  srcml_pipelined_reader(std::unique_ptr<srcml_reader> reader,
+                         std::size_t batch_size = DEFAULT_BATCH_SIZE, std::size_t batches = DEFAULT_BATCHES);
+  ~srcml_pipelined_reader();
+
+  srcml_pipelined_reader(const srcml_pipelined_reader &) = delete;
+  srcml_pipelined_reader & operator=(const srcml_pipelined_reader &) = delete;
+
+  const srcml_element_path & get_element_path() const { return element_path; }
+
+  srcml_pipelined_reader_iterator begin();
+  srcml_pipelined_reader_iterator end();
+
+  operator bool() const;
+
+};
+
+#endif
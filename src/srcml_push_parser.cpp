@@ -0,0 +1,289 @@
+/*
+  srcml_push_parser.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_push_parser.hpp>
+
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+#include <cstring>
+
+class srcml_push_parser_error : public std::runtime_error {
+public:
+  srcml_push_parser_error(const std::string & what_arg) : std::runtime_error(what_arg) {}
+
+};
+
+static const srcml_symbol TEXT_SYMBOL("text");
+static const srcml_symbol COMMENT_SYMBOL("comment");
+
+const std::size_t srcml_push_parser::SLICE_SIZE;
+
+srcml_push_parser::srcml_push_parser(srcml_input & input)
+  : input(input), context(nullptr), libxml_cache(), chunk_data(nullptr), chunk_size(0), finished(false), failed(false),
+    events(), depths(), event_count(0), ready(0), position(0), open_elements(), depth(0), empty_open(false), open_run(0) {
+
+  xmlSAXHandler handler;
+  std::memset(&handler, 0, sizeof(handler));
+  handler.initialized = XML_SAX2_MAGIC;
+  handler.startElementNs = &srcml_push_parser::start_element;
+  handler.endElementNs = &srcml_push_parser::end_element;
+  handler.characters = &srcml_push_parser::characters;
+  handler.ignorableWhitespace = &srcml_push_parser::characters;
+  handler.cdataBlock = &srcml_push_parser::cdata_block;
+  handler.comment = &srcml_push_parser::comment;
+  handler.processingInstruction = &srcml_push_parser::processing_instruction;
+  handler.internalSubset = &srcml_push_parser::internal_subset;
+
+  context = xmlCreatePushParserCtxt(&handler, this, nullptr, 0, nullptr);
+  if(!context) throw srcml_push_parser_error("Error creating parser");
+
+}
+
+srcml_push_parser::~srcml_push_parser() {
+
+  if(context) {
+    if(context->myDoc) xmlFreeDoc(context->myDoc);
+    xmlFreeParserCtxt(context);
+  }
+
+}
+
+/**
+ * next
+ *
+ * Move to the next event, parsing more of the input when the queue
+ * runs out.
+ */
+int srcml_push_parser::next() {
+
+  while(position == ready) {
+    if(!fill()) return failed ? -1 : 0;
+  }
+
+  ++position;
+  return 1;
+}
+
+/**
+ * fill
+ *
+ * Replace the consumed events with those of the next slices of input.
+ * A run of text may continue in the next slice, so it is only handed
+ * out once something else follows it or the input ends.  Returns true
+ * if there are events to hand out.
+ */
+bool srcml_push_parser::fill() {
+
+  std::size_t kept = 0;
+  for(std::size_t pending = ready; pending < event_count; ++pending, ++kept) {
+    std::swap(events[kept], events[pending]);
+    std::swap(depths[kept], depths[pending]);
+  }
+
+  event_count = kept;
+  ready = 0;
+  position = 0;
+
+  while(!ready && !finished && !failed) {
+
+    if(!chunk_size) {
+
+      try {
+        chunk_size = input.read_chunk(chunk_data);
+      } catch(const std::exception &) {
+        failed = true;
+        break;
+      }
+
+      if(!chunk_size) {
+        xmlParseChunk(context, nullptr, 0, 1);
+        finished = true;
+        open_run = 0;
+        ready = event_count;
+      }
+
+    } else {
+
+      std::size_t size = std::min(chunk_size, SLICE_SIZE);
+      xmlParseChunk(context, chunk_data, int(size), 0);
+      chunk_data += size;
+      chunk_size -= size;
+
+    }
+
+    if(!context->wellFormed) failed = true;
+
+  }
+
+  return ready != 0;
+}
+
+std::size_t srcml_push_parser::bytes_consumed() const {
+
+  long consumed = xmlByteConsumed(context);
+  return consumed > 0 ? std::size_t(consumed) : 0;
+}
+
+srcml_node & srcml_push_parser::add_event(std::size_t event_depth) {
+
+  if(event_count == events.size()) {
+    events.emplace_back();
+    depths.push_back(0);
+  }
+
+  depths[event_count] = event_depth;
+  return events[event_count++];
+}
+
+/**
+ * add_run
+ * @param run XML_TEXT_NODE or XML_CDATA_SECTION_NODE
+ *
+ * Character data is reported in pieces, e.g., on either side of an
+ * entity reference, and is joined into one node as libxml2 does when
+ * it builds a tree.
+ */
+void srcml_push_parser::add_run(int run, const xmlChar * data, int length) {
+
+  if(open_run == run) {
+    events[event_count - 1].content.get().append((const char *)data, length);
+    return;
+  }
+
+  ready = event_count;
+  open_run = run;
+
+  srcml_node & node = add_event(depth);
+  node.clear();
+  if(run == XML_TEXT_NODE) {
+    node.type = srcml_node::srcml_node_type::TEXT;
+    node.name = TEXT_SYMBOL;
+  }
+  node.content.assign((const char *)data, length);
+
+}
+
+void srcml_push_parser::add_other(srcml_symbol name, const xmlChar * content) {
+
+  open_run = 0;
+  ready = event_count;
+
+  srcml_node & node = add_event(depth);
+  node.clear();
+  node.name = name;
+  if(content) node.content.assign((const char *)content, std::strlen((const char *)content));
+
+  ready = event_count;
+
+}
+
+void srcml_push_parser::start_element(void * context, const xmlChar * localname, const xmlChar * prefix, const xmlChar * uri,
+                                      int namespace_count, const xmlChar ** namespaces,
+                                      int attribute_count, int, const xmlChar ** attributes) {
+
+  srcml_push_parser * parser = (srcml_push_parser *)context;
+  xmlDictPtr dict = parser->context->dict;
+  srcml_node::srcml_libxml_cache & cache = parser->libxml_cache;
+
+  parser->open_run = 0;
+  parser->ready = parser->event_count;
+
+  // the start tag is kept for the end node, as libxml2 reports the element itself at its end
+  if(parser->depth == parser->open_elements.size()) parser->open_elements.emplace_back();
+  srcml_node & element = parser->open_elements[parser->depth];
+
+  element.type = srcml_node::srcml_node_type::START;
+  element.name = cache.get_symbol(localname, dict);
+  element.ns = cache.get_namespace(uri, prefix, dict);
+  element.content.reset();
+
+  element.ns_definition.clear();
+  for(int i = 0; i < namespace_count; ++i) {
+    element.ns_definition.emplace_back(cache.get_namespace(namespaces[2 * i + 1], namespaces[2 * i], dict));
+  }
+
+  element.attributes.assign(attributes, attribute_count, cache, dict);
+
+  // the check xmlTextReader makes to flag an empty element
+  xmlParserInputPtr in = parser->context->input;
+  parser->empty_open = in && in->cur && in->cur + 1 < in->end && in->cur[0] == '/' && in->cur[1] == '>';
+  element.empty = parser->empty_open;
+  element.extra = parser->empty_open ? 1 : 0;
+  if(!element.user_data.empty()) element.user_data = boost::any();
+
+  parser->add_event(parser->depth) = element;
+  parser->ready = parser->event_count;
+  ++parser->depth;
+
+}
+
+void srcml_push_parser::end_element(void * context, const xmlChar *, const xmlChar *, const xmlChar *) {
+
+  srcml_push_parser * parser = (srcml_push_parser *)context;
+
+  --parser->depth;
+  parser->open_run = 0;
+
+  // an empty element has no end node
+  if(parser->empty_open) {
+    parser->empty_open = false;
+    return;
+  }
+
+  parser->ready = parser->event_count;
+
+  // copied, not moved, so the open element and the queued node both keep their storage
+  srcml_node & node = parser->add_event(parser->depth);
+  node = parser->open_elements[parser->depth];
+  node.type = srcml_node::srcml_node_type::END;
+
+  parser->ready = parser->event_count;
+
+}
+
+void srcml_push_parser::characters(void * context, const xmlChar * data, int length) {
+  ((srcml_push_parser *)context)->add_run(XML_TEXT_NODE, data, length);
+}
+
+void srcml_push_parser::cdata_block(void * context, const xmlChar * data, int length) {
+  ((srcml_push_parser *)context)->add_run(XML_CDATA_SECTION_NODE, data, length);
+}
+
+void srcml_push_parser::comment(void * context, const xmlChar * data) {
+  ((srcml_push_parser *)context)->add_other(COMMENT_SYMBOL, data);
+}
+
+void srcml_push_parser::processing_instruction(void * context, const xmlChar * target, const xmlChar * data) {
+
+  srcml_push_parser * parser = (srcml_push_parser *)context;
+  parser->add_other(parser->libxml_cache.get_symbol(target, parser->context->dict), data);
+
+}
+
+void srcml_push_parser::internal_subset(void * context, const xmlChar * name, const xmlChar *, const xmlChar *) {
+
+  srcml_push_parser * parser = (srcml_push_parser *)context;
+  parser->add_other(parser->libxml_cache.get_symbol(name, parser->context->dict), nullptr);
+
+}
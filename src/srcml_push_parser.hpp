@@ -0,0 +1,112 @@
+/*
+  srcml_push_parser.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_PUSH_PARSER_HPP
+#define INCLUDED_SRCML_PUSH_PARSER_HPP
+
+#include <srcml_event_parser.hpp>
+#include <srcml_input.hpp>
+
+#include <libxml/parser.h>
+
+#include <vector>
+#include <cstddef>
+
+class srcml_push_parser_error;
+
+/**
+ * srcml_push_parser
+ *
+ * Parses srcML with libxml2's SAX2 push interface and builds the
+ * srcml_node events directly in the callbacks, instead of copying them
+ * out of the partial tree an xmlTextReader builds.  The input is fed to
+ * libxml2 in slices and the events of a slice are queued in nodes that
+ * are reused from slice to slice.
+ *
+ * The events are those an xmlTextReader reports for the document, with
+ * the same depths: an empty element is a single start node flagged
+ * empty, an end node carries the attributes and namespace definitions
+ * of its start tag, and adjacent character data is one text node.
+ * A document type declaration is reported, but its internal subset is
+ * not applied; srcML does not use one.
+ */
+class srcml_push_parser : public srcml_event_parser {
+
+private:
+
+  /** bytes given to libxml2 at a time, which bounds the queue */
+  static const std::size_t SLICE_SIZE = 1 << 10;
+
+  srcml_input & input;
+  xmlParserCtxtPtr context;
+  srcml_node::srcml_libxml_cache libxml_cache;
+
+  const char * chunk_data;
+  std::size_t chunk_size;
+  bool finished;
+  bool failed;
+
+  std::vector<srcml_node> events;
+  std::vector<std::size_t> depths;
+  std::size_t event_count;
+  std::size_t ready;
+  std::size_t position;
+
+  std::vector<srcml_node> open_elements;
+  std::size_t depth;
+  bool empty_open;
+
+  /** libxml2 node type of the text or CDATA run still being added to, or 0 */
+  int open_run;
+
+  srcml_node & add_event(std::size_t event_depth);
+  void add_run(int run, const xmlChar * data, int length);
+  void add_other(srcml_symbol name, const xmlChar * content);
+  bool fill();
+
+  static void start_element(void * context, const xmlChar * localname, const xmlChar * prefix, const xmlChar * uri,
+                            int namespace_count, const xmlChar ** namespaces,
+                            int attribute_count, int defaulted_count, const xmlChar ** attributes);
+  static void end_element(void * context, const xmlChar * localname, const xmlChar * prefix, const xmlChar * uri);
+  static void characters(void * context, const xmlChar * data, int length);
+  static void cdata_block(void * context, const xmlChar * data, int length);
+  static void comment(void * context, const xmlChar * data);
+  static void processing_instruction(void * context, const xmlChar * target, const xmlChar * data);
+  static void internal_subset(void * context, const xmlChar * name, const xmlChar * external_id, const xmlChar * system_id);
+
+public:
+
+  srcml_push_parser(srcml_input & input);
+  ~srcml_push_parser();
+
+  srcml_push_parser(const srcml_push_parser &) = delete;
+  srcml_push_parser & operator=(const srcml_push_parser &) = delete;
+
+  virtual int next();
+  virtual srcml_node & current() { return events[position - 1]; }
+  virtual std::size_t current_depth() const { return depths[position - 1]; }
+  virtual std::size_t bytes_consumed() const;
+
+};
+
+#endif
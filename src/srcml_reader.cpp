@@ -22,8 +22,12 @@
 */
 
 #include <srcml_reader.hpp>
+#include <srcml_push_parser.hpp>
+#include <srcml_tokenizer.hpp>
+#include <srcml_text_run.hpp>
 
 #include <iostream>
+#include <cstring>
 
 class srcml_reader_error : public std::runtime_error {
 public:
@@ -31,18 +35,62 @@ public:
 
 };
 
+static const srcml_symbol TEXT_SYMBOL("text");
+static const srcml_symbol UNIT_SYMBOL("unit");
+
+/** libxml2 reader type of a node from the push parser */
+static int reader_type(const srcml_node & node) {
+
+  switch(node.type) {
+
+    case srcml_node::srcml_node_type::START: return XML_READER_TYPE_ELEMENT;
+    case srcml_node::srcml_node_type::END:   return XML_READER_TYPE_END_ELEMENT;
+    case srcml_node::srcml_node_type::TEXT:  return XML_READER_TYPE_TEXT;
+    default:                                 return XML_READER_TYPE_NONE;
+
+  }
+
+}
+
+/** srcml_node type of a libxml2 reader type */
+static srcml_node::srcml_node_type node_type(int type) {
+
+  switch(type) {
+
+    case XML_READER_TYPE_ELEMENT:                return srcml_node::srcml_node_type::START;
+    case XML_READER_TYPE_END_ELEMENT:            return srcml_node::srcml_node_type::END;
+    case XML_READER_TYPE_TEXT:                   return srcml_node::srcml_node_type::TEXT;
+    case XML_READER_TYPE_SIGNIFICANT_WHITESPACE: return srcml_node::srcml_node_type::TEXT;
+    default:                                     return srcml_node::srcml_node_type::OTHER;
+
+  }
+
+}
+
 void srcml_reader::cleanup() {
 
   if(reader) {
-    xmlTextReaderClose(reader);
+    xmlFreeTextReader(reader);
     reader = nullptr;
   }
 
 }
 
-srcml_reader::srcml_reader(const std::string & filename) 
-  : reader(nullptr), offset(std::string::npos), saved_node(), issue_end_tag(false), current_node(),
-    is_eof(false), iterator() {
+srcml_reader::srcml_reader(const std::string & filename, srcml_backend backend)
+  : srcml_reader(nullptr, false) {
+
+  if(backend == srcml_backend::PUSH_PARSER) {
+    input.reset(new srcml_mapped_input(filename));
+    parser.reset(new srcml_push_parser(*input));
+    return;
+  }
+
+  if(backend == srcml_backend::TOKENIZER) {
+    srcml_mapped_input * mapped = new srcml_mapped_input(filename);
+    input.reset(mapped);
+    parser.reset(new srcml_tokenizer(mapped->data(), mapped->size()));
+    return;
+  }
 
   reader = xmlNewTextReaderFilename(filename.c_str());
   if(!reader) {
@@ -52,103 +100,654 @@ srcml_reader::srcml_reader(const std::string & filename)
 
 }
 
-srcml_reader::~srcml_reader() {
-  cleanup();
+/**
+ * srcml_reader
+ * @param data srcML document in memory
+ * @param size length of the document
+ *
+ * Read a document in place.  The buffer is not copied and must outlive
+ * the reader.
+ */
+srcml_reader::srcml_reader(const char * data, std::size_t size, srcml_backend backend)
+  : srcml_reader(std::unique_ptr<srcml_input>(new srcml_memory_input(data, size)), backend) {}
+
+/**
+ * srcml_reader
+ * @param in stream to read the document from
+ * @param block_size bytes read from the stream at a time
+ */
+srcml_reader::srcml_reader(std::istream & in, std::size_t block_size, srcml_backend backend)
+  : srcml_reader(std::unique_ptr<srcml_input>(new srcml_stream_input(in, block_size)), backend) {}
+
+/**
+ * srcml_reader
+ * @param fd open file descriptor to read the document from
+ * @param block_size bytes read from the descriptor at a time
+ */
+srcml_reader::srcml_reader(int fd, std::size_t block_size, srcml_backend backend)
+  : srcml_reader(std::unique_ptr<srcml_input>(new srcml_fd_input(fd, block_size)), backend) {}
+
+/**
+ * srcml_reader
+ * @param input source of the document, e.g., a srcml_mapped_input
+ * @param backend parser to read the document with
+ */
+srcml_reader::srcml_reader(std::unique_ptr<srcml_input> input, srcml_backend backend)
+  : srcml_reader(std::move(input), false, backend) {}
+
+/**
+ * srcml_reader
+ * @param input source of the document
+ * @param hide_root skip the events of the root element
+ * @param backend parser to read the document with
+ */
+srcml_reader::srcml_reader(std::unique_ptr<srcml_input> input, bool hide_root, srcml_backend backend)
+  : srcml_reader(nullptr, hide_root) {
+
+  this->input = std::move(input);
+
+  // the tokenizer needs the whole document in memory
+  if(backend == srcml_backend::TOKENIZER) {
+    srcml_memory_input * memory = dynamic_cast<srcml_memory_input *>(this->input.get());
+    if(memory) {
+      parser.reset(new srcml_tokenizer(memory->data(), memory->size()));
+      return;
+    }
+  }
+
+  if(backend != srcml_backend::TEXT_READER) {
+    parser.reset(new srcml_push_parser(*this->input));
+    return;
+  }
+
+  reader = this->input->create_reader();
+  if(!reader) {
+    cleanup();
+    throw srcml_reader_error("Error opening input");
+  }
+
 }
 
-const std::stack<std::string> & srcml_reader::get_element_stack() const {
-  return element_stack;
+/**
+ * srcml_reader
+ * @param reader libxml2 reader to take ownership of
+ * @param hide_root skip the events of the root element
+ *
+ * A hidden root is still pushed on the element stack, so a unit read
+ * inside a copy of its archive's root start tag sees the same stack it
+ * would when reading the whole archive.
+ */
+srcml_reader::srcml_reader(xmlTextReaderPtr reader, bool hide_root)
+  : input(), reader(reader), parser(), libxml_cache(), text_data(nullptr), text_size(0), offset(std::string::npos),
+    text_node(std::string()), issue_end_tag(false), hide_root(hide_root), element_node(), current_node(nullptr), view(), element_stale(false),
+    is_eof(false), iterator(), element_path(), positioned(false), positioned_result(0), expiring_namespaces(nullptr),
+    is_filtered(false), filter_elements(), skipped_elements(), filter_depth(0), stats(), root_units(0),
+    unit_locator(), position(0), unit_number(npos), units_started(0), leaving_unit(false), unit_modified(false),
+    split_text(true) {
+
+  // libxml2 must be initialized once before readers run on several threads
+  static const bool libxml_initialized = (xmlInitParser(), true);
+  (void)libxml_initialized;
+
 }
 
-static std::string::size_type find_count(const std::string & str, std::string::size_type start) {
+srcml_reader::~srcml_reader() {
+  cleanup();
+}
 
-    bool is_space = std::isspace(str[start]);
-    std::string::size_type size = str.size();
-    std::string::size_type end = start + 1;
-    while(end < size && std::isspace(str[end]) == is_space) {
-      ++end;
-    }
+const srcml_element_path & srcml_reader::get_element_path() const {
+  return element_path;
+}
 
-    if(end >= size) return std::string::npos;
-    return end - start;
+/**
+ * get_element_stack
+ *
+ * The element path as a stack of qualified names.  Kept for existing
+ * callers; get_element_path() answers the same questions without
+ * building strings.
+ */
+const std::stack<std::string> & srcml_reader::get_element_stack() const {
+  return element_path.to_stack();
 }
 
+/**
+ * update_current_text_node
+ *
+ * Point the reused text node at the next whitespace/non-whitespace run
+ * of the current libxml2 text node, or at all of it if text is not
+ * split.  The run is borrowed, not copied, and stays valid until the
+ * next call to xmlTextReaderRead.
+ */
 void srcml_reader::update_current_text_node() {
 
-    std::string::size_type count = find_count(*saved_node->content, offset);
-    current_node = std::make_unique<srcml_node>(saved_node->content->substr(offset, count));
+    SRCML_STATS(srcml_stats::srcml_scoped_timer timer(stats, srcml_stats::TEXT));
+    SRCML_STATS(++stats.text_events);
+
+    std::size_t length = text_size - offset;
+    std::uint32_t line_delta = 0;
+    std::uint32_t column_delta = 0;
+    if(split_text) {
+      srcml_text_run run(text_data + offset, length);
+      length = run.length;
+      line_delta = run.line_delta;
+      column_delta = run.column_delta;
+    } else {
+      srcml_text_run::count_lines(text_data + offset, length, line_delta, column_delta);
+    }
 
-    if(count != std::string::npos) {
-      offset += count;
+    // the node may have been modified or moved from since the last run
+    text_node.type = srcml_node::srcml_node_type::TEXT;
+    text_node.name = TEXT_SYMBOL;
+    if(text_node.ns != srcml_node::SRC_NAMESPACE) text_node.ns = srcml_node::SRC_NAMESPACE;
+    text_node.content.borrow(text_data + offset, length);
+    if(!text_node.ns_definition.empty()) text_node.ns_definition.clear();
+    if(!text_node.attributes.empty()) text_node.attributes.clear();
+    if(!text_node.user_data.empty()) text_node.user_data = boost::any();
+    text_node.line_delta = line_delta;
+    text_node.column_delta = column_delta;
+    current_node = &text_node;
+    view = srcml_node_view(&text_node);
+
+    if(offset + length < text_size) {
+      offset += length;
     } else {
       offset = std::string::npos;
     }
 }
 
 bool srcml_reader::read() {
+
+  if(!read_node()) return false;
+
+  update_unit();
+  return true;
+}
+
+/**
+ * update_unit
+ *
+ * Count the node just moved to and, if units are tracked, find the
+ * unit it is in.  A unit's end tag is still in it.
+ */
+void srcml_reader::update_unit() {
+
+  ++position;
+  if(!unit_locator) return;
+
+  if(leaving_unit) {
+    leaving_unit = false;
+    unit_number = npos;
+  }
+
+  std::size_t unit_depth = unit_locator->is_archive() ? 2 : 1;
+  if(view.is_start() && element_path.depth() == unit_depth && element_path.back() == UNIT_SYMBOL) {
+    unit_number = units_started++;
+    unit_modified = false;
+  } else if(view.is_end() && unit_number != npos && element_path.depth() + 1 == unit_depth) {
+    leaving_unit = true;
+  }
+
+}
+
+bool srcml_reader::read_node() {
   if(is_eof) return false;
 
-  if(offset != std::string::npos && current_node && current_node->is_text()) {
+  if(offset != std::string::npos && current_node == &text_node) {
     update_current_text_node();
     return true;
 
   } else if(issue_end_tag) {
     issue_end_tag = false;
 
-    current_node = std::make_unique<srcml_node>(*current_node);
-    current_node->type = srcml_node::srcml_node_type::END;
-    current_node->attributes.clear();
-    current_node->ns_definition.clear();
+    // the start tag becomes its own end tag, in place once it is built
+    if(element_stale) {
+      view.node_type = srcml_node::srcml_node_type::END;
+      view.with_attributes = false;
+    } else {
+      current_node->type = srcml_node::srcml_node_type::END;
+      current_node->attributes.clear();
+      current_node->ns_definition.clear();
+    }
 
-    if(element_stack.size() > 1) {
-      element_stack.pop();
-    } 
+    if(filter_depth == element_path.depth()) filter_depth = 0;
+    element_path.pop();
 
+    SRCML_STATS(++stats.end_events);
     return true;
 
   }
 
-  int success = xmlTextReaderRead(reader);
-  if(success == -1) throw srcml_reader_error("Error reading file");
-  if(!success) {
-    is_eof = true;
-    current_node = std::make_unique<srcml_node>(srcml_node());
-    return false;
-  }
+  xmlNodePtr node = nullptr;
+  int type = -1;
+  while(true) {
 
-  xmlNodePtr node = xmlTextReaderCurrentNode(reader);
-  if(!node) throw srcml_reader_error("Error getting current node");
+    // libxml2 may free the last element left, and its namespace declarations with it
+    if(expiring_namespaces) {
+      libxml_cache.forget_namespaces(expiring_namespaces);
+      expiring_namespaces = nullptr;
+    }
+
+    int success;
+    {
+      SRCML_STATS(srcml_stats::srcml_scoped_timer timer(stats, srcml_stats::PARSE));
+      success = parser ? parser->next() : positioned ? positioned_result : xmlTextReaderRead(reader);
+    }
+    positioned = false;
+    if(success == -1) throw srcml_reader_error("Error reading file");
+    if(!success) {
+      is_eof = true;
+      element_node.clear();
+      current_node = &element_node;
+      view = srcml_node_view(&element_node);
+      element_stale = false;
+      return false;
+    }
+
+    if(parser) {
+
+      type = reader_type(parser->current());
+
+    } else {
+
+      node = xmlTextReaderCurrentNode(reader);
+      if(!node) throw srcml_reader_error("Error getting current node");
+
+      type = xmlTextReaderNodeType(reader);
+      if(type == -1) srcml_reader_error("Error getting node type");
+
+      if(node->nsDef && (type == XML_READER_TYPE_END_ELEMENT || (type == XML_READER_TYPE_ELEMENT && node->extra)))
+        expiring_namespaces = node->nsDef;
+
+    }
+
+    if(hide_root && (parser ? parser->current_depth() : xmlTextReaderDepth(reader)) == 0) {
 
-  int type = xmlTextReaderNodeType(reader);
-  if(type == -1) srcml_reader_error("Error getting node type");
+      if(type == XML_READER_TYPE_ELEMENT) element_path.push(current_element_name(node));
+
+      continue;
+    }
+
+    if(!is_filtered || accept(node, type)) break;
 
-  srcml_node * temp_node = nullptr;
-  try {
-    temp_node = new srcml_node(*node, (xmlElementType)type);
-  } catch(const std::bad_alloc & memory_error) {
-    throw srcml_reader_error("Memory error getting node");
   }
 
-  if(temp_node->is_text()) {
+  element_stale = false;
+  if(type == XML_READER_TYPE_TEXT || type == XML_READER_TYPE_SIGNIFICANT_WHITESPACE) {
+    if(parser) {
+      text_data = parser->current().content.data();
+      text_size = parser->current().content.size();
+    } else {
+      text_data = node->content ? (const char *)node->content : "";
+      text_size = std::strlen(text_data);
+    }
     offset = 0;
-    saved_node = std::unique_ptr<srcml_node>(temp_node);
     update_current_text_node();
-  } else {
-    current_node = std::unique_ptr<srcml_node>(temp_node);
+    return true;
+  }
+
+  // the libxml2 node is only built into element_node when it is asked for
+  if(parser) {
+
+    current_node = &parser->current();
+    view = srcml_node_view(current_node);
+
     if(current_node->is_empty()) {
       issue_end_tag = true;
       current_node->empty = false;
     }
 
-    if(current_node->is_start()) {
-      element_stack.push(current_node->full_name());
-    } else if(current_node->is_end()){
-      element_stack.pop();
-    }
+  } else {
+
+    current_node = &element_node;
+    element_stale = true;
+
+    srcml_node::srcml_node_type current_type = node_type(type);
+    if(current_type == srcml_node::srcml_node_type::START && node->extra) issue_end_tag = true;
+    view = srcml_node_view(node, current_type, false);
+
+  }
+
+  if(view.is_start()) {
+    element_path.push(current_element_name(node));
+  } else if(view.is_end()){
+    if(filter_depth == element_path.depth()) filter_depth = 0;
+    element_path.pop();
   }
+
+  SRCML_STATS(stats.count_event(view.type()));
+  SRCML_STATS(
+    if(view.is_start() && element_path.depth() <= 2 && element_path.back() == UNIT_SYMBOL) {
+      ++(element_path.depth() == 1 ? root_units : stats.units);
+    }
+  )
+
   return true;
 }
 
+/**
+ * element_name
+ * @param node a libxml2 element
+ *
+ * Qualified name of an element, as srcml_node::qualified_name() would
+ * give it, without building a node.
+ */
+srcml_symbol srcml_reader::element_name(const xmlNode & node) {
+
+  srcml_symbol name = libxml_cache.get_symbol(node.name, node.doc);
+  std::shared_ptr<srcml_node::srcml_namespace> ns = libxml_cache.get_namespace(node.ns);
+
+  if(ns && ns->prefix) return srcml_symbol::qualify(*ns->prefix, name);
+
+  return name;
+}
+
+/**
+ * current_element_name
+ * @param node the libxml2 element the reader is on, null for the push parser
+ */
+srcml_symbol srcml_reader::current_element_name(const xmlNode * node) {
+  return parser ? parser->current().qualified_name() : element_name(*node);
+}
+
+/**
+ * skip_subtree
+ *
+ * Move libxml2 past the current element and everything in it.  The
+ * reader is left on the following node, which the next read() uses
+ * instead of reading another.
+ */
+void srcml_reader::skip_subtree() {
+
+  // the push parser is left on the end of the element, which the next read() passes
+  if(parser) {
+    parser->skip_subtree();
+    return;
+  }
+
+  // the element is freed as it is passed, with the namespaces it declares
+  xmlNodePtr node = xmlTextReaderCurrentNode(reader);
+  if(node) libxml_cache.forget_namespaces(node->nsDef);
+
+  positioned_result = xmlTextReaderNext(reader);
+  positioned = true;
+
+}
+
+/**
+ * accept
+ * @param node the libxml2 node the reader is on, null for the push parser
+ * @param type its libxml2 reader type
+ *
+ * Apply the element filter to a node.  Skipped elements are passed
+ * over with their subtrees.  Outside of a subtree of interest nothing
+ * is returned, but elements are still tracked on the element stack so
+ * it is correct when a subtree of interest starts.
+ */
+bool srcml_reader::accept(const xmlNode * node, int type) {
+
+  bool inside = filter_elements.empty() || filter_depth;
+
+  if(type == XML_READER_TYPE_ELEMENT) {
+
+    srcml_symbol name = current_element_name(node);
+
+    if(skipped_elements.count(name)) {
+      skip_subtree();
+      return false;
+    }
+
+    if(inside) return true;
+
+    if(filter_elements.count(name)) {
+      filter_depth = element_path.depth() + 1;
+      return true;
+    }
+
+    if(!(parser ? parser->current().empty : xmlTextReaderIsEmptyElement(reader))) element_path.push(name);
+    return false;
+
+  }
+
+  if(type == XML_READER_TYPE_END_ELEMENT && !inside) {
+    element_path.pop();
+    return false;
+  }
+
+  return inside;
+}
+
+/**
+ * set_element_filter
+ * @param elements qualified names of the elements of interest
+ * @param skipped qualified names of elements to skip entirely
+ *
+ * Only return the subtrees of the elements of interest, or everything
+ * if there are none.  Subtrees of skipped elements are passed over
+ * without being read into nodes, even inside an element of interest.
+ * Outside of the elements of interest, the reader walks the elements
+ * for the element stack but builds no nodes.
+ */
+void srcml_reader::set_element_filter(const std::vector<std::string> & elements, const std::vector<std::string> & skipped) {
+
+  if(unit_locator && (!elements.empty() || !skipped.empty())) throw srcml_reader_error("Units are tracked, so elements cannot be filtered");
+
+  filter_elements.clear();
+  for(const std::string & element : elements) {
+    filter_elements.emplace(element);
+  }
+
+  skipped_elements.clear();
+  for(const std::string & element : skipped) {
+    skipped_elements.emplace(element);
+  }
+
+  is_filtered = !filter_elements.empty() || !skipped_elements.empty();
+  filter_depth = 0;
+
+}
+
+void srcml_reader::clear_element_filter() {
+  set_element_filter(std::vector<std::string>());
+}
+
+/**
+ * set_split_text
+ * @param split split text into whitespace and non-whitespace runs
+ *
+ * Text is split by default.  Unsplit, each text node is the whole of
+ * the text between two tags, which saves the events when the runs are
+ * not needed, e.g., to write text back.
+ */
+void srcml_reader::set_split_text(bool split) {
+  split_text = split;
+}
+
+/**
+ * skip
+ *
+ * Skip the rest of the current element.  If the current node is a
+ * start tag, its subtree is passed over without being read into nodes
+ * and the current node becomes its end tag; the element stack is
+ * updated as if the subtree had been read.  Otherwise nothing happens.
+ */
+void srcml_reader::skip() {
+
+  if(!*this || current_node == &text_node || !view.is_start()) return;
+
+  // an empty element is followed by its end tag anyway
+  if(issue_end_tag) {
+    read();
+    return;
+  }
+
+  // what is passed over is not written back
+  if(unit_number != npos) unit_modified = true;
+
+  // libxml2 may free the start node while passing its subtree
+  if(!parser) current();
+
+  skip_subtree();
+
+  if(parser) {
+    current_node = &parser->current();
+    view = srcml_node_view(current_node);
+  } else {
+    element_node.type = srcml_node::srcml_node_type::END;
+  }
+  if(filter_depth == element_path.depth()) filter_depth = 0;
+  element_path.pop();
+  update_unit();
+
+  SRCML_STATS(++stats.end_events);
+
+}
+
+/**
+ * current
+ *
+ * The current node, built from the libxml2 node on first use.
+ */
+srcml_node & srcml_reader::current() {
+
+  if(element_stale) {
+
+    SRCML_STATS(srcml_stats::srcml_scoped_timer timer(stats, srcml_stats::NODE));
+    SRCML_STATS(++stats.nodes_built);
+
+    try {
+      view.materialize(element_node, &libxml_cache);
+    } catch(const std::bad_alloc & memory_error) {
+      throw srcml_reader_error("Memory error getting node");
+    }
+
+    element_stale = false;
+    view = srcml_node_view(&element_node);
+
+  }
+
+  return *current_node;
+}
+
+/**
+ * next
+ *
+ * Move to the next node without building it, starting at the first
+ * node of the document.  Returns false at the end.  The node is read
+ * through get_current_view(); dereferencing an iterator builds it.
+ */
+bool srcml_reader::next() {
+
+  if(!iterator.reader) {
+    begin();
+    return *this;
+  }
+
+  return *this && read();
+}
+
+/**
+ * get_current_view
+ *
+ * A view of the current node, valid until the reader advances.
+ */
+const srcml_node_view & srcml_reader::get_current_view() const {
+  return view;
+}
+
+/**
+ * get_stats
+ *
+ * Counters for what has been read so far, all zero unless srcReader is
+ * built with SRCREADER_STATS.  Units are those of an archive, or the
+ * root unit if there are none.
+ */
+srcml_stats srcml_reader::get_stats() const {
+
+  srcml_stats current = stats;
+
+  SRCML_STATS(
+    if(!current.units) current.units = root_units;
+
+    if(parser) {
+      current.bytes = parser->bytes_consumed();
+    } else if(reader) {
+      long consumed = xmlTextReaderByteConsumed(reader);
+      current.bytes = consumed > 0 ? std::size_t(consumed) : 0;
+    }
+  )
+
+  return current;
+}
+
+/**
+ * track_units
+ *
+ * Keep track of the unit each node is in, with the unit's byte range
+ * from a srcml_unit_locator, and of whether it has been modified, so a
+ * srcml_pass_through_writer can copy unmodified units from the source.
+ * Must be called before reading, on a reader of a document in memory.
+ */
+void srcml_reader::track_units() {
+
+  if(iterator.reader) throw srcml_reader_error("Units must be tracked from the start of the document");
+  if(is_filtered) throw srcml_reader_error("Units cannot be tracked with an element filter");
+
+  srcml_memory_input * memory = dynamic_cast<srcml_memory_input *>(input.get());
+  if(!memory) throw srcml_reader_error("Tracking units needs a document in memory");
+
+  if(!unit_locator) unit_locator.reset(new srcml_unit_locator(memory->data(), memory->size()));
+
+}
+
+/** units of the document if they are tracked, otherwise null */
+const srcml_unit_locator * srcml_reader::get_unit_locator() const {
+  return unit_locator.get();
+}
+
+/**
+ * get_unit_number
+ *
+ * Position of the unit the current node is in, numbered as by the
+ * unit locator, or npos outside of a unit or if units are not tracked.
+ */
+std::size_t srcml_reader::get_unit_number() const {
+  return unit_number;
+}
+
+/**
+ * is_unit_modified
+ *
+ * If the current unit has been marked as modified since its start tag.
+ * A unit with a subtree skipped is modified.
+ */
+bool srcml_reader::is_unit_modified() const {
+  return unit_modified;
+}
+
+/**
+ * mark_unit_modified
+ *
+ * Mark the current unit as modified, e.g., when nodes are left out.
+ * Taking the current node through a non-const iterator or modify()
+ * marks it too.  Outside of a unit this does nothing.
+ */
+void srcml_reader::mark_unit_modified() {
+  if(unit_number != npos) unit_modified = true;
+}
+
+/**
+ * modify
+ *
+ * The current node, to be changed in place.  Its unit is marked as
+ * modified.
+ */
+srcml_node & srcml_reader::modify() {
+
+  mark_unit_modified();
+  return current();
+
+}
+
 srcml_reader::srcml_reader_iterator srcml_reader::begin() {
 
   if(!iterator.reader) {
@@ -163,6 +762,12 @@ srcml_reader::srcml_reader_iterator srcml_reader::end() {
   return srcml_reader_iterator();
 }
 
+/**
+ * get_current_doc
+ *
+ * Only the xmlTextReader backend builds a document; with the push
+ * parser this and expand_current_node() throw.
+ */
 xmlDocPtr srcml_reader::get_current_doc() const {
   xmlDocPtr doc = xmlTextReaderCurrentDoc(reader);
   if(doc == nullptr) {
@@ -182,38 +787,58 @@ xmlNodePtr srcml_reader::expand_current_node() const {
 
 
 srcml_reader::operator bool() const {
-  return *current_node != srcml_node();
+  return current_node && !is_eof;
 }
 
 srcml_reader::srcml_reader_iterator::srcml_reader_iterator(srcml_reader * reader)
   : reader(reader) {}
 
 const srcml_node & srcml_reader::srcml_reader_iterator::operator*() const {
-  return *reader->current_node; 
+  return reader->current();
 }
 
+/**
+ * operator*
+ *
+ * The current node, to be changed in place.  As with modify(), its
+ * unit is marked as modified; read through a const iterator to leave
+ * it unmarked.
+ */
 srcml_node & srcml_reader::srcml_reader_iterator::operator*() {
-  return *reader->current_node; 
+  return reader->modify();
 }
 
 const srcml_node * srcml_reader::srcml_reader_iterator::operator->() const {
-  return reader->current_node.get(); 
+  return &reader->current();
 }
 
 srcml_node * srcml_reader::srcml_reader_iterator::operator->() {
-  return reader->current_node.get(); 
+  return &reader->modify();
 }
 
 const srcml_node & srcml_reader::srcml_reader_iterator::operator++() {
 
   reader->read();
-  return *reader->current_node;
+  return reader->current();
 
 }
 
+/**
+ * operator++(int)
+ *
+ * The current node is moved out rather than copied.  Its content is
+ * made owning first since a borrowed text run does not survive the
+ * advance.
+ */
 srcml_node srcml_reader::srcml_reader_iterator::operator++(int) {
 
-  srcml_node node = *reader->current_node;
+  srcml_node node = std::move(reader->current());
+  SRCML_STATS(if(node.content.is_borrowed()) reader->stats.bytes_copied += node.content.size());
+  node.content.own();
+
+  // an empty element becomes its own end tag in place, which needs its namespace
+  if(reader->issue_end_tag) reader->current_node->ns = node.ns;
+
   reader->read();
   return node;
 
@@ -25,12 +25,21 @@
 #define INCLUDED_SRCML_READER_HPP
 
 #include <srcml_node.hpp>
+#include <srcml_node_view.hpp>
+#include <srcml_input.hpp>
+#include <srcml_element_path.hpp>
+#include <srcml_event_parser.hpp>
+#include <srcml_stats.hpp>
+#include <srcml_unit_locator.hpp>
 
 #include <libxml/xmlreader.h>
 
 #include <string>
 #include <memory>
+#include <istream>
 #include <stack>
+#include <vector>
+#include <unordered_set>
 
 class srcml_reader_error;
 
@@ -51,31 +60,112 @@ public:
 
         friend class srcml_reader;
   };
+
+  /**
+   * How the document is parsed: pulled through an xmlTextReader, or
+   * pushed through libxml2's SAX2 callbacks by a srcml_push_parser,
+   * which builds nodes without a partial tree but cannot expand nodes.
+   * TOKENIZER parses a document in memory with a srcml_tokenizer, which
+   * falls back to the push parser for anything srcML does not use;
+   * other inputs use the push parser.
+   */
+  enum class srcml_backend : unsigned int { TEXT_READER = 0, PUSH_PARSER = 1, TOKENIZER = 2 };
+
 private:
 
+  srcml_reader(xmlTextReaderPtr reader, bool hide_root);
+  srcml_reader(std::unique_ptr<srcml_input> input, bool hide_root, srcml_backend backend = srcml_backend::TEXT_READER);
+
   void cleanup();
   bool read();
+  bool read_node();
+  void update_unit();
   void update_current_text_node();
+  srcml_symbol element_name(const xmlNode & node);
+  srcml_symbol current_element_name(const xmlNode * node);
+  void skip_subtree();
+  bool accept(const xmlNode * node, int type);
+  srcml_node & current();
 
+  std::unique_ptr<srcml_input> input;
   xmlTextReaderPtr reader;
+  std::unique_ptr<srcml_event_parser> parser;
+  srcml_node::srcml_libxml_cache libxml_cache;
+
+  const char * text_data;
+  std::size_t text_size;
   std::string::size_type offset;
-  std::unique_ptr<srcml_node> saved_node;
+  srcml_node text_node;
 
   bool issue_end_tag;
+  bool hide_root;
 
-  std::unique_ptr<srcml_node> current_node;
+  srcml_node element_node;
+  srcml_node * current_node;
+  srcml_node_view view;
+  bool element_stale;
   bool is_eof;
 
   srcml_reader_iterator iterator;
 
-  std::stack<std::string> element_stack;
+  srcml_element_path element_path;
+
+  bool positioned;
+  int positioned_result;
+  xmlNsPtr expiring_namespaces;
+
+  bool is_filtered;
+  std::unordered_set<srcml_symbol> filter_elements;
+  std::unordered_set<srcml_symbol> skipped_elements;
+  std::size_t filter_depth;
+
+  srcml_stats stats;
+  std::size_t root_units;
+
+  std::unique_ptr<srcml_unit_locator> unit_locator;
+  std::size_t position;
+  std::size_t unit_number;
+  std::size_t units_started;
+  bool leaving_unit;
+  bool unit_modified;
+
+  bool split_text;
 
 public:
-  srcml_reader(const std::string & filename);
+
+  /** unit number outside of a unit */
+  static const std::size_t npos = std::size_t(-1);
+
+  srcml_reader(const std::string & filename, srcml_backend backend = srcml_backend::TEXT_READER);
+  srcml_reader(const char * data, std::size_t size, srcml_backend backend = srcml_backend::TEXT_READER);
+  srcml_reader(std::istream & in, std::size_t block_size = srcml_input::DEFAULT_BLOCK_SIZE,
+               srcml_backend backend = srcml_backend::TEXT_READER);
+  srcml_reader(int fd, std::size_t block_size = srcml_input::DEFAULT_BLOCK_SIZE,
+               srcml_backend backend = srcml_backend::TEXT_READER);
+  srcml_reader(std::unique_ptr<srcml_input> input, srcml_backend backend = srcml_backend::TEXT_READER);
   ~srcml_reader();
 
+  const srcml_element_path & get_element_path() const;
   const std::stack<std::string> & get_element_stack() const;
 
+  void set_element_filter(const std::vector<std::string> & elements,
+                          const std::vector<std::string> & skipped = std::vector<std::string>());
+  void clear_element_filter();
+  void set_split_text(bool split);
+  void skip();
+
+  bool next();
+  const srcml_node_view & get_current_view() const;
+
+  srcml_stats get_stats() const;
+
+  void track_units();
+  const srcml_unit_locator * get_unit_locator() const;
+  std::size_t get_unit_number() const;
+  bool is_unit_modified() const;
+  void mark_unit_modified();
+  srcml_node & modify();
+
   srcml_reader_iterator begin();
   srcml_reader_iterator end();
   xmlDocPtr get_current_doc() const;
@@ -83,6 +173,10 @@ public:
 
   operator bool() const;
 
+  friend class srcml_parallel_reader;
+  friend class srcml_indexed_reader;
+  friend class srcml_pass_through_writer;
+
 };
 
 #endif
\ No newline at end of file
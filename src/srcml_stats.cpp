@@ -0,0 +1,88 @@
+/*
+  srcml_stats.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_stats.hpp>
+#include <srcml_node.hpp>
+
+#include <sstream>
+
+constexpr bool srcml_stats::enabled;
+
+srcml_stats::srcml_stats() {
+  reset();
+}
+
+void srcml_stats::reset() {
+
+  start_events = 0;
+  end_events = 0;
+  text_events = 0;
+  other_events = 0;
+  bytes = 0;
+  units = 0;
+  nodes_built = 0;
+  bytes_copied = 0;
+  for(std::uint64_t & timer : nanoseconds) {
+    timer = 0;
+  }
+
+}
+
+void srcml_stats::count_event(int type) {
+
+  switch(type) {
+
+    case srcml_node::srcml_node_type::START: ++start_events; break;
+    case srcml_node::srcml_node_type::END:   ++end_events;   break;
+    case srcml_node::srcml_node_type::TEXT:  ++text_events;  break;
+    default:                                 ++other_events; break;
+
+  }
+
+}
+
+/**
+ * to_json
+ *
+ * The counters as a single line JSON object, with times in seconds.
+ */
+std::string srcml_stats::to_json() const {
+
+  std::ostringstream out;
+  out << "{\"enabled\":" << (enabled ? "true" : "false")
+      << ",\"start_events\":" << start_events
+      << ",\"end_events\":" << end_events
+      << ",\"text_events\":" << text_events
+      << ",\"other_events\":" << other_events
+      << ",\"bytes\":" << bytes
+      << ",\"units\":" << units
+      << ",\"nodes_built\":" << nodes_built
+      << ",\"bytes_copied\":" << bytes_copied
+      << ",\"parse_seconds\":" << seconds(PARSE)
+      << ",\"node_seconds\":" << seconds(NODE)
+      << ",\"text_seconds\":" << seconds(TEXT)
+      << ",\"write_seconds\":" << seconds(WRITE)
+      << '}';
+
+  return out.str();
+}
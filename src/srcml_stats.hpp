@@ -0,0 +1,124 @@
+/*
+  srcml_stats.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_STATS_HPP
+#define INCLUDED_SRCML_STATS_HPP
+
+#include <string>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * SRCML_STATS
+ *
+ * Compiles its statement only when srcReader is built with
+ * SRCREADER_STATS, so counting costs nothing otherwise.
+ */
+#ifdef SRCREADER_STATS
+#define SRCML_STATS(...) __VA_ARGS__
+#else
+#define SRCML_STATS(...)
+#endif
+
+/**
+ * srcml_stats
+ *
+ * Counters kept by srcml_reader and srcml_writer when srcReader is
+ * built with SRCREADER_STATS; otherwise they stay zero.  The members
+ * are present either way, so code built with and without the option
+ * can share the headers.
+ *
+ * For a reader, bytes is how much of the input the parser has consumed
+ * and units the number of units read.  For a writer, bytes is the text
+ * handed to libsrcml and units the number of units written.
+ *
+ * nodes_built counts element nodes built from libxml2 nodes and
+ * bytes_copied the text copied into nodes that own it, which is where
+ * reading allocates.  Time is split by what the reader or writer is
+ * doing: parsing, i.e., in libxml2 or the tokenizer, building nodes,
+ * splitting text into runs, or writing through libsrcml.  The push
+ * parser and tokenizer build nodes as they parse, so with them that
+ * time is parse time.
+ */
+class srcml_stats {
+
+public:
+
+  enum srcml_timer : unsigned int { PARSE = 0, NODE = 1, TEXT = 2, WRITE = 3, TIMERS = 4 };
+
+  /**
+   * srcml_scoped_timer
+   *
+   * Adds the time it is alive to one of the timers.
+   */
+  class srcml_scoped_timer {
+
+  private:
+
+    srcml_stats & stats;
+    srcml_timer timer;
+    std::chrono::steady_clock::time_point start;
+
+  public:
+
+    srcml_scoped_timer(srcml_stats & stats, srcml_timer timer)
+      : stats(stats), timer(timer), start(std::chrono::steady_clock::now()) {}
+
+    ~srcml_scoped_timer() {
+      stats.nanoseconds[timer] += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+  };
+
+#ifdef SRCREADER_STATS
+  static constexpr bool enabled = true;
+#else
+  static constexpr bool enabled = false;
+#endif
+
+  std::size_t start_events;
+  std::size_t end_events;
+  std::size_t text_events;
+  std::size_t other_events;
+  std::size_t bytes;
+  std::size_t units;
+  std::size_t nodes_built;
+  std::size_t bytes_copied;
+  std::uint64_t nanoseconds[TIMERS];
+
+  srcml_stats();
+
+  void reset();
+
+  /** count an event of a srcml_node type */
+  void count_event(int type);
+
+  std::size_t events() const { return start_events + end_events + text_events + other_events; }
+  double seconds(srcml_timer timer) const { return nanoseconds[timer] / 1e9; }
+
+  std::string to_json() const;
+
+};
+
+#endif
@@ -0,0 +1,159 @@
+/*
+  srcml_symbol.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_symbol.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+/**
+ * symbol_table
+ *
+ * Strings are stored in fixed-size chunks that never move once
+ * allocated, so a symbol's string can be read without taking the lock.
+ * The id of a symbol is published to other threads either through the
+ * lock in intern() or through whatever handed the symbol over.
+ */
+class symbol_table {
+
+public:
+
+  static const srcml_symbol::id_type CHUNK_BITS = 10;
+  static const srcml_symbol::id_type CHUNK_SIZE = 1 << CHUNK_BITS;
+  static const srcml_symbol::id_type MAX_CHUNKS = 4096;
+
+private:
+
+  std::mutex mutex;
+  std::unordered_map<std::string, srcml_symbol::id_type> index;
+  std::atomic<std::string *> chunks[MAX_CHUNKS];
+  std::atomic<srcml_symbol::id_type> size;
+
+public:
+
+  symbol_table() : mutex(), index(), size(0) {
+
+    for(std::atomic<std::string *> & chunk : chunks) {
+      chunk.store(nullptr, std::memory_order_relaxed);
+    }
+
+    // id 0 is always the empty string
+    intern(std::string());
+
+  }
+
+  ~symbol_table() {
+    for(std::atomic<std::string *> & chunk : chunks) {
+      delete [] chunk.load(std::memory_order_relaxed);
+    }
+  }
+
+  srcml_symbol::id_type intern(const std::string & str) {
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::unordered_map<std::string, srcml_symbol::id_type>::const_iterator citr = index.find(str);
+    if(citr != index.end()) return citr->second;
+
+    srcml_symbol::id_type id = size.load(std::memory_order_relaxed);
+    if((id >> CHUNK_BITS) >= MAX_CHUNKS) throw std::length_error("srcml_symbol table is full");
+
+    std::string * chunk = chunks[id >> CHUNK_BITS].load(std::memory_order_relaxed);
+    if(!chunk) {
+      chunk = new std::string[CHUNK_SIZE];
+      chunks[id >> CHUNK_BITS].store(chunk, std::memory_order_release);
+    }
+
+    chunk[id & (CHUNK_SIZE - 1)] = str;
+    index.emplace(str, id);
+    size.store(id + 1, std::memory_order_release);
+
+    return id;
+  }
+
+  const std::string & lookup(srcml_symbol::id_type id) const {
+    return chunks[id >> CHUNK_BITS].load(std::memory_order_acquire)[id & (CHUNK_SIZE - 1)];
+  }
+
+  std::size_t count() const {
+    return size.load(std::memory_order_acquire);
+  }
+
+};
+
+symbol_table & table() {
+  static symbol_table symbols;
+  return symbols;
+}
+
+}
+
+const std::string & srcml_symbol::lookup(id_type id) {
+  return table().lookup(id);
+}
+
+srcml_symbol::srcml_symbol(const std::string & str)
+  : symbol_id(str.empty() ? 0 : table().intern(str)) {}
+
+srcml_symbol::srcml_symbol(const char * str)
+  : symbol_id(!str || !*str ? 0 : table().intern(str)) {}
+
+srcml_symbol::srcml_symbol(const char * str, std::size_t length)
+  : symbol_id(!length ? 0 : table().intern(std::string(str, length))) {}
+
+srcml_symbol srcml_symbol::from_id(id_type id) {
+
+  if(id >= table().count()) throw std::out_of_range("Invalid srcml_symbol id: " + std::to_string(id));
+
+  srcml_symbol symbol;
+  symbol.symbol_id = id;
+  return symbol;
+}
+
+srcml_symbol srcml_symbol::qualify(srcml_symbol prefix, srcml_symbol local) {
+
+  if(prefix.empty()) return local;
+
+  // symbols are permanent, so a per-thread cache keyed on ids never goes stale
+  thread_local std::unordered_map<std::uint64_t, id_type> qualified;
+
+  std::uint64_t key = (std::uint64_t(prefix.symbol_id) << 32) | local.symbol_id;
+  std::unordered_map<std::uint64_t, id_type>::const_iterator citr = qualified.find(key);
+  if(citr != qualified.end()) {
+    srcml_symbol symbol;
+    symbol.symbol_id = citr->second;
+    return symbol;
+  }
+
+  srcml_symbol symbol(prefix.str() + ":" + local.str());
+  qualified.emplace(key, symbol.symbol_id);
+  return symbol;
+}
+
+std::size_t srcml_symbol::count() {
+  return table().count();
+}
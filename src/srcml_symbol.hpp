@@ -0,0 +1,106 @@
+/*
+  srcml_symbol.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_SYMBOL_HPP
+#define INCLUDED_SRCML_SYMBOL_HPP
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <functional>
+
+/**
+ * srcml_symbol
+ *
+ * Handle to a string interned in the process-wide symbol table.
+ * Symbols are never removed, so the id of a name is stable for the
+ * life of the process and two symbols are equal exactly when their
+ * ids are equal.  Interning is thread-safe; looking up the string of
+ * a symbol is lock-free.
+ */
+class srcml_symbol {
+
+public:
+
+  typedef std::uint32_t id_type;
+
+private:
+
+  id_type symbol_id;
+
+  static const std::string & lookup(id_type id);
+
+public:
+
+  srcml_symbol() : symbol_id(0) {}
+  srcml_symbol(const std::string & str);
+  srcml_symbol(const char * str);
+  srcml_symbol(const char * str, std::size_t length);
+
+  static srcml_symbol from_id(id_type id);
+  static srcml_symbol qualify(srcml_symbol prefix, srcml_symbol local);
+  static std::size_t count();
+
+  id_type id() const { return symbol_id; }
+  const std::string & str() const { return lookup(symbol_id); }
+  operator const std::string &() const { return lookup(symbol_id); }
+
+  const char * c_str() const { return str().c_str(); }
+  std::size_t size() const { return str().size(); }
+  bool empty() const { return symbol_id == 0; }
+
+  bool operator==(srcml_symbol that) const { return symbol_id == that.symbol_id; }
+  bool operator!=(srcml_symbol that) const { return symbol_id != that.symbol_id; }
+  bool operator<(srcml_symbol that) const { return symbol_id < that.symbol_id; }
+
+  bool operator==(const std::string & that) const { return str() == that; }
+  bool operator!=(const std::string & that) const { return str() != that; }
+  bool operator==(const char * that) const { return std::strcmp(c_str(), that) == 0; }
+  bool operator!=(const char * that) const { return std::strcmp(c_str(), that) != 0; }
+
+};
+
+inline bool operator==(const std::string & str, srcml_symbol symbol) { return symbol == str; }
+inline bool operator!=(const std::string & str, srcml_symbol symbol) { return symbol != str; }
+inline bool operator==(const char * str, srcml_symbol symbol) { return symbol == str; }
+inline bool operator!=(const char * str, srcml_symbol symbol) { return symbol != str; }
+
+inline std::string operator+(srcml_symbol symbol, const std::string & str) { return symbol.str() + str; }
+inline std::string operator+(const std::string & str, srcml_symbol symbol) { return str + symbol.str(); }
+inline std::string operator+(srcml_symbol symbol, const char * str) { return symbol.str() + str; }
+inline std::string operator+(const char * str, srcml_symbol symbol) { return str + symbol.str(); }
+
+inline std::ostream & operator<<(std::ostream & out, srcml_symbol symbol) { return out << symbol.str(); }
+
+namespace std {
+
+template<>
+struct hash<srcml_symbol> {
+  std::size_t operator()(srcml_symbol symbol) const { return symbol.id(); }
+};
+
+}
+
+#endif
@@ -0,0 +1,208 @@
+/*
+  srcml_text_run.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_text_run.hpp>
+
+#include <bitset>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define SRCML_TEXT_RUN_SSE2
+#endif
+
+static inline unsigned int first_bit(unsigned int mask) {
+
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return index;
+#else
+  return __builtin_ctz(mask);
+#endif
+
+}
+
+static inline unsigned int last_bit(unsigned int mask) {
+
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanReverse(&index, mask);
+  return index;
+#else
+  return 31 - __builtin_clz(mask);
+#endif
+
+}
+
+static inline std::size_t count_bits(unsigned int mask) {
+  return std::bitset<32>(mask).count();
+}
+
+/**
+ * srcml_text_run
+ * @param data text starting with the run
+ * @param size length of the text
+ *
+ * Each block yields masks of its whitespace bytes, newlines and UTF-8
+ * continuation bytes.  The first byte of the other class ends the run;
+ * below it, newlines are counted in a whitespace run and characters in
+ * a non-whitespace run, which has no newlines.
+ */
+srcml_text_run::srcml_text_run(const char * data, std::size_t size)
+  : length(0), is_space(size && is_whitespace(data[0])), line_delta(0), column_delta(0) {
+
+  const char * pos = data;
+  const char * const end = data + size;
+  const char * last_newline = nullptr;
+  std::size_t characters = 0;
+  bool ended = false;
+
+#ifdef __AVX2__
+  const __m256i space_32 = _mm256_set1_epi8(' ');
+  const __m256i below_tab_32 = _mm256_set1_epi8('\t' - 1);
+  const __m256i above_return_32 = _mm256_set1_epi8('\r' + 1);
+  const __m256i newline_32 = _mm256_set1_epi8('\n');
+  const __m256i continuation_32 = _mm256_set1_epi8(char(0xC0));
+
+  while(!ended && end - pos >= 32) {
+
+    __m256i block = _mm256_loadu_si256((const __m256i *)pos);
+    __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(block, space_32),
+                                    _mm256_and_si256(_mm256_cmpgt_epi8(block, below_tab_32), _mm256_cmpgt_epi8(above_return_32, block)));
+
+    unsigned int space_mask = (unsigned int)_mm256_movemask_epi8(space);
+    unsigned int boundary = is_space ? ~space_mask : space_mask;
+    unsigned int inside = boundary ? (1u << first_bit(boundary)) - 1 : ~0u;
+
+    if(is_space) {
+      unsigned int newlines = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline_32)) & inside;
+      if(newlines) {
+        line_delta += std::uint32_t(count_bits(newlines));
+        last_newline = pos + last_bit(newlines);
+      }
+    } else {
+      // continuation bytes are 0x80-0xBF, those below 0xC0 when signed
+      unsigned int continuations = (unsigned int)_mm256_movemask_epi8(_mm256_cmpgt_epi8(continuation_32, block));
+      characters += count_bits(~continuations & inside);
+    }
+
+    if(boundary) {
+      pos += first_bit(boundary);
+      ended = true;
+    } else {
+      pos += 32;
+    }
+
+  }
+#endif
+
+#ifdef SRCML_TEXT_RUN_SSE2
+  const __m128i space_16 = _mm_set1_epi8(' ');
+  const __m128i below_tab_16 = _mm_set1_epi8('\t' - 1);
+  const __m128i above_return_16 = _mm_set1_epi8('\r' + 1);
+  const __m128i newline_16 = _mm_set1_epi8('\n');
+  const __m128i continuation_16 = _mm_set1_epi8(char(0xC0));
+
+  while(!ended && end - pos >= 16) {
+
+    __m128i block = _mm_loadu_si128((const __m128i *)pos);
+    __m128i space = _mm_or_si128(_mm_cmpeq_epi8(block, space_16),
+                                 _mm_and_si128(_mm_cmpgt_epi8(block, below_tab_16), _mm_cmplt_epi8(block, above_return_16)));
+
+    unsigned int space_mask = (unsigned int)_mm_movemask_epi8(space);
+    unsigned int boundary = (is_space ? ~space_mask : space_mask) & 0xFFFF;
+    unsigned int inside = boundary ? (1u << first_bit(boundary)) - 1 : 0xFFFF;
+
+    if(is_space) {
+      unsigned int newlines = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline_16)) & inside;
+      if(newlines) {
+        line_delta += std::uint32_t(count_bits(newlines));
+        last_newline = pos + last_bit(newlines);
+      }
+    } else {
+      unsigned int continuations = (unsigned int)_mm_movemask_epi8(_mm_cmplt_epi8(block, continuation_16));
+      characters += count_bits(~continuations & inside);
+    }
+
+    if(boundary) {
+      pos += first_bit(boundary);
+      ended = true;
+    } else {
+      pos += 16;
+    }
+
+  }
+#endif
+
+  for(; !ended && pos < end && is_whitespace(*pos) == is_space; ++pos) {
+
+    if(*pos == '\n') {
+      ++line_delta;
+      last_newline = pos;
+    }
+
+    if(!is_space && ((unsigned char)*pos & 0xC0) != 0x80) ++characters;
+
+  }
+
+  length = pos - data;
+  if(!is_space) column_delta = std::uint32_t(characters);
+  else column_delta = std::uint32_t(last_newline ? pos - last_newline - 1 : length);
+
+}
+
+/**
+ * count_lines
+ *
+ * The line and column deltas of reading over any text, run by run.
+ */
+void srcml_text_run::count_lines(const char * data, std::size_t size, std::uint32_t & line_delta, std::uint32_t & column_delta) {
+
+  line_delta = 0;
+  column_delta = 0;
+
+  while(size) {
+
+    srcml_text_run run(data, size);
+    if(run.line_delta) {
+      line_delta += run.line_delta;
+      column_delta = run.column_delta;
+    } else {
+      column_delta += run.column_delta;
+    }
+
+    data += run.length;
+    size -= run.length;
+
+  }
+
+}
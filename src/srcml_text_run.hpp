@@ -0,0 +1,60 @@
+/*
+  srcml_text_run.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_TEXT_RUN_HPP
+#define INCLUDED_SRCML_TEXT_RUN_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * srcml_text_run
+ *
+ * The maximal run of whitespace or of non-whitespace at the start of
+ * some text, as srcml_reader splits text into nodes, found 16 or 32
+ * bytes at a time with SSE2 or AVX2.  Whitespace is what std::isspace
+ * reports in the "C" locale, whatever the current locale.
+ *
+ * Reading over the run moves line_delta lines down.  column_delta is
+ * the number of characters after the last newline of the run, or in
+ * the whole run if it has none; a tab is one character and a non-ASCII
+ * UTF-8 sequence is one character.
+ */
+class srcml_text_run {
+
+public:
+
+  std::size_t length;
+  bool is_space;
+  std::uint32_t line_delta;
+  std::uint32_t column_delta;
+
+  srcml_text_run(const char * data, std::size_t size);
+
+  static bool is_whitespace(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+  static void count_lines(const char * data, std::size_t size, std::uint32_t & line_delta, std::uint32_t & column_delta);
+
+};
+
+#endif
@@ -0,0 +1,827 @@
+/*
+  srcml_tokenizer.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_tokenizer.hpp>
+#include <srcml_xml_util.hpp>
+
+#include <libxml/parserInternals.h>
+
+#include <cstring>
+#include <utility>
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define SRCML_TOKENIZER_SSE2
+#endif
+
+static const srcml_symbol TEXT_SYMBOL("text");
+static const srcml_symbol COMMENT_SYMBOL("comment");
+
+static const char * const XML_NAMESPACE_URI = "http://www.w3.org/XML/1998/namespace";
+
+/** libxml2's limit on element depth without XML_PARSE_HUGE */
+static const std::size_t MAX_DEPTH = 256;
+
+static inline bool is_name_start(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static inline bool is_name_char(char c) {
+  return is_name_start(c) || (c >= '0' && c <= '9') || c == '-' || c == '.' || c == ':';
+}
+
+static inline const char * skip_space(const char * pos, const char * end) {
+  while(pos < end && srcml_xml_util::is_space(*pos)) ++pos;
+  return pos;
+}
+
+static inline const char * scan_name(const char * pos, const char * end) {
+  while(pos < end && is_name_char(*pos)) ++pos;
+  return pos;
+}
+
+/**
+ * split_name
+ *
+ * Split an ASCII qualified name into its prefix, empty if there is
+ * none, and local name.  False if it is not a qualified name.
+ */
+static bool split_name(const char * begin, const char * end, boost::string_view & prefix, boost::string_view & local) {
+
+  if(begin == end || !is_name_start(*begin)) return false;
+
+  const char * colon = (const char *)std::memchr(begin, ':', end - begin);
+  if(!colon) {
+    prefix = boost::string_view();
+    local = boost::string_view(begin, end - begin);
+    return true;
+  }
+
+  if(colon + 1 == end || !is_name_start(colon[1]) || std::memchr(colon + 1, ':', end - colon - 1)) return false;
+
+  prefix = boost::string_view(begin, colon - begin);
+  local = boost::string_view(colon + 1, end - colon - 1);
+  return true;
+}
+
+static inline unsigned int first_bit(unsigned int mask) {
+
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return index;
+#else
+  return __builtin_ctz(mask);
+#endif
+
+}
+
+/**
+ * find_special
+ * @param layout whether tab and newline are ordinary characters
+ *
+ * The first of first, second or third, a control character or a
+ * non-ASCII byte at or after pos, or end if there is none.  Blocks of
+ * 32 or 16 bytes are compared at once, control characters and
+ * non-ASCII bytes together as the bytes below ' ' when signed.
+ */
+static const char * find_special(const char * pos, const char * end, char first, char second, char third, bool layout) {
+
+#ifdef __AVX2__
+  const __m256i first_32 = _mm256_set1_epi8(first);
+  const __m256i second_32 = _mm256_set1_epi8(second);
+  const __m256i third_32 = _mm256_set1_epi8(third);
+  const __m256i space_32 = _mm256_set1_epi8(' ');
+  const __m256i tab_32 = _mm256_set1_epi8('\t');
+  const __m256i newline_32 = _mm256_set1_epi8('\n');
+
+  for(; end - pos >= 32; pos += 32) {
+
+    __m256i block = _mm256_loadu_si256((const __m256i *)pos);
+    __m256i found = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, first_32), _mm256_cmpeq_epi8(block, second_32)),
+                                    _mm256_cmpeq_epi8(block, third_32));
+    __m256i control = _mm256_cmpgt_epi8(space_32, block);
+    if(layout)
+      control = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, tab_32), _mm256_cmpeq_epi8(block, newline_32)), control);
+
+    unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_or_si256(found, control));
+    if(mask) return pos + first_bit(mask);
+
+  }
+#endif
+
+#ifdef SRCML_TOKENIZER_SSE2
+  const __m128i first_16 = _mm_set1_epi8(first);
+  const __m128i second_16 = _mm_set1_epi8(second);
+  const __m128i third_16 = _mm_set1_epi8(third);
+  const __m128i space_16 = _mm_set1_epi8(' ');
+  const __m128i tab_16 = _mm_set1_epi8('\t');
+  const __m128i newline_16 = _mm_set1_epi8('\n');
+
+  for(; end - pos >= 16; pos += 16) {
+
+    __m128i block = _mm_loadu_si128((const __m128i *)pos);
+    __m128i found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, first_16), _mm_cmpeq_epi8(block, second_16)),
+                                 _mm_cmpeq_epi8(block, third_16));
+    __m128i control = _mm_cmplt_epi8(block, space_16);
+    if(layout)
+      control = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi8(block, tab_16), _mm_cmpeq_epi8(block, newline_16)), control);
+
+    unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_or_si128(found, control));
+    if(mask) return pos + first_bit(mask);
+
+  }
+#endif
+
+  for(; pos < end; ++pos) {
+
+    const char c = *pos;
+    if(c == first || c == second || c == third) return pos;
+
+    const unsigned char byte = (unsigned char)c;
+    if(byte >= 0x80 || (byte < 0x20 && !(layout && (c == '\t' || c == '\n')))) return pos;
+
+  }
+
+  return end;
+}
+
+/**
+ * utf8_length
+ *
+ * Length of the UTF-8 sequence at pos if it encodes a character XML
+ * allows, otherwise 0.
+ */
+static std::size_t utf8_length(const char * pos, const char * end) {
+
+  const unsigned char * bytes = (const unsigned char *)pos;
+  const std::size_t available = end - pos;
+  auto continuation = [bytes](std::size_t i) { return (bytes[i] & 0xC0) == 0x80; };
+
+  if(bytes[0] < 0xC2) return 0;
+
+  if(bytes[0] < 0xE0) return available >= 2 && continuation(1) ? 2 : 0;
+
+  if(bytes[0] < 0xF0) {
+
+    if(available < 3 || !continuation(1) || !continuation(2)) return 0;
+
+    unsigned long code_point = ((bytes[0] & 0x0F) << 12) | ((bytes[1] & 0x3F) << 6) | (bytes[2] & 0x3F);
+    if(code_point < 0x800 || (code_point >= 0xD800 && code_point <= 0xDFFF) || code_point >= 0xFFFE) return 0;
+    return 3;
+
+  }
+
+  if(bytes[0] < 0xF5) {
+
+    if(available < 4 || !continuation(1) || !continuation(2) || !continuation(3)) return 0;
+
+    unsigned long code_point = ((bytes[0] & 0x07) << 18) | ((bytes[1] & 0x3F) << 12) | ((bytes[2] & 0x3F) << 6) | (bytes[3] & 0x3F);
+    if(code_point < 0x10000 || code_point > 0x10FFFF) return 0;
+    return 4;
+
+  }
+
+  return 0;
+}
+
+/**
+ * is_plain
+ *
+ * Whether comment or processing instruction data can be handed out as
+ * it is: valid UTF-8 with no control characters other than tab and
+ * newline, so there are no carriage returns to normalize.
+ */
+static bool is_plain(const char * pos, const char * end) {
+
+  while((pos = find_special(pos, end, '\0', '\0', '\0', true)) != end) {
+
+    std::size_t length = utf8_length(pos, end);
+    if(!length) return false;
+    pos += length;
+
+  }
+
+  return true;
+}
+
+/** FNV-1a, as names are short */
+std::size_t srcml_tokenizer::srcml_name_hash::operator()(boost::string_view name) const {
+
+  std::size_t hash = 2166136261u;
+  for(char c : name) {
+    hash = (hash ^ (unsigned char)c) * 16777619u;
+  }
+
+  return hash;
+}
+
+/**
+ * srcml_tokenizer
+ * @param data srcML document in memory, which must outlive the tokenizer
+ * @param size length of the document
+ */
+srcml_tokenizer::srcml_tokenizer(const char * data, std::size_t size)
+  : data(data), size(size), pos(data), end(data + size), in_dialect(true), event(), event_depth(0),
+    open_elements(), open_names(), depth(0), seen_root(false), bindings(), raw_attributes(), namespaces(),
+    symbols(), text(), delivered(0), fallback_input(), fallback() {
+
+  if(size >= 3 && std::memcmp(pos, "\xEF\xBB\xBF", 3) == 0) pos += 3;
+
+  if(end - pos >= 6 && std::memcmp(pos, "<?xml", 5) == 0 && srcml_xml_util::is_space(pos[5]))
+    in_dialect = read_declaration();
+
+}
+
+/**
+ * next
+ *
+ * Move to the next event, handing the document to the push parser at
+ * the first thing outside the dialect.
+ */
+int srcml_tokenizer::next() {
+
+  if(fallback) return fallback->next();
+
+  int result = in_dialect ? tokenize() : -1;
+  if(result == -1) return fall_back();
+
+  if(result == 1) ++delivered;
+  return result;
+}
+
+/**
+ * fall_back
+ *
+ * Parse the document with libxml2 from the start, passing the events
+ * that were already handed out.
+ */
+int srcml_tokenizer::fall_back() {
+
+  fallback_input.reset(new srcml_memory_input(data, size));
+  fallback.reset(new srcml_push_parser(*fallback_input));
+
+  for(std::size_t replayed = 0; replayed < delivered; ++replayed) {
+    int result = fallback->next();
+    if(result != 1) return result;
+  }
+
+  return fallback->next();
+}
+
+/**
+ * read_declaration
+ *
+ * Pass the XML declaration.  Only UTF-8 documents are in the dialect.
+ */
+bool srcml_tokenizer::read_declaration() {
+
+  const char * start = pos + 5;
+  const char * close = start;
+  while(true) {
+    close = (const char *)std::memchr(close, '?', end - close);
+    if(!close || close + 1 == end) return false;
+    if(close[1] == '>') break;
+    ++close;
+  }
+
+  boost::string_view declaration(start, close - start);
+  const char * version = skip_space(start, close);
+  if(boost::string_view(version, close - version).substr(0, 7) != "version") return false;
+
+  boost::string_view::size_type encoding = declaration.find("encoding");
+  if(encoding != boost::string_view::npos) {
+
+    const char * value = skip_space(start + encoding + 8, close);
+    if(value == close || *value != '=') return false;
+    value = skip_space(value + 1, close);
+    if(value == close || (*value != '"' && *value != '\'')) return false;
+
+    const char * value_end = (const char *)std::memchr(value + 1, *value, close - value - 1);
+    if(!value_end || value_end - value - 1 != 5) return false;
+
+    static const char UTF8[] = "utf-8";
+    for(std::size_t i = 0; i < 5; ++i) {
+      char c = value[1 + i];
+      if(c >= 'A' && c <= 'Z') c += 'a' - 'A';
+      if(c != UTF8[i]) return false;
+    }
+
+  }
+
+  pos = close + 2;
+  return true;
+}
+
+/**
+ * tokenize
+ *
+ * Read the next event: 1 if there is one, 0 at the end of the document,
+ * and -1 when the document leaves the dialect.
+ */
+int srcml_tokenizer::tokenize() {
+
+  // only comments and processing instructions surround the root element
+  if(depth == 0) {
+    pos = skip_space(pos, end);
+    if(pos == end) return seen_root ? 0 : -1;
+    if(*pos != '<') return -1;
+  }
+
+  if(pos == end) return -1;
+  if(*pos != '<') return read_text() ? 1 : -1;
+  if(end - pos < 2) return -1;
+
+  switch(pos[1]) {
+
+    case '/': return read_end_tag() ? 1 : -1;
+    case '?': return read_processing_instruction() ? 1 : -1;
+    case '!': return end - pos >= 4 && pos[2] == '-' && pos[3] == '-' && read_comment() ? 1 : -1;
+    default:  return read_start_tag() ? 1 : -1;
+
+  }
+
+}
+
+/**
+ * read_start_tag
+ *
+ * Read a start tag into the element kept for its end node.  Namespace
+ * declarations are bound before any name of the tag is resolved, as
+ * they may follow the attributes that use them.
+ */
+bool srcml_tokenizer::read_start_tag() {
+
+  if(depth >= MAX_DEPTH || (depth == 0 && seen_root)) return false;
+
+  const char * name_start = pos + 1;
+  const char * name_end = scan_name(name_start, end);
+  boost::string_view prefix, local;
+  if(!split_name(name_start, name_end, prefix, local)) return false;
+
+  if(depth == open_elements.size()) {
+    open_elements.emplace_back();
+    open_names.emplace_back();
+  }
+
+  srcml_node & element = open_elements[depth];
+  open_names[depth] = boost::string_view(name_start, name_end - name_start);
+  element.ns_definition.clear();
+  raw_attributes.clear();
+
+  const std::size_t tag_bindings = bindings.size();
+  std::size_t attribute_count = 0;
+  bool empty = false;
+
+  pos = name_end;
+  while(true) {
+
+    const char * space = pos;
+    pos = skip_space(pos, end);
+    if(pos == end) return false;
+
+    if(*pos == '>') {
+      ++pos;
+      break;
+    }
+
+    if(*pos == '/') {
+      if(pos + 1 == end || pos[1] != '>') return false;
+      pos += 2;
+      empty = true;
+      break;
+    }
+
+    if(pos == space) return false;
+
+    const char * attribute_start = pos;
+    pos = scan_name(pos, end);
+    srcml_raw_attribute attribute;
+    if(!split_name(attribute_start, pos, attribute.prefix, attribute.name)) return false;
+
+    pos = skip_space(pos, end);
+    if(pos == end || *pos != '=') return false;
+    pos = skip_space(pos + 1, end);
+    if(pos == end || (*pos != '"' && *pos != '\'')) return false;
+    const char quote = *pos++;
+
+    if(attribute.prefix.empty() ? attribute.name == "xmlns" : attribute.prefix == "xmlns") {
+
+      if(!read_value(quote, text) || text.empty()) return false;
+
+      boost::string_view bound = attribute.prefix.empty() ? boost::string_view() : attribute.name;
+      if(bound == "xml" || bound == "xmlns") return false;
+      for(std::size_t i = tag_bindings; i < bindings.size(); ++i) {
+        if(bindings[i].prefix == bound) return false;
+      }
+
+      std::shared_ptr<srcml_node::srcml_namespace> ns = get_namespace(text, bound);
+      element.ns_definition.push_back(ns);
+      bindings.push_back(srcml_binding{ bound, ns, depth });
+      continue;
+
+    }
+
+    if(attribute_count == element.attributes.size()) element.attributes.resize(attribute_count + 1);
+    srcml_node::srcml_attribute & value = (element.attributes.begin() + attribute_count)->second;
+    if(!value.value) value.value = std::string();
+    if(!read_value(quote, *value.value)) return false;
+
+    raw_attributes.push_back(attribute);
+    ++attribute_count;
+
+  }
+
+  element.attributes.resize(attribute_count);
+
+  element.type = srcml_node::srcml_node_type::START;
+  element.name = get_symbol(local);
+  const std::shared_ptr<srcml_node::srcml_namespace> * element_ns = find_binding(prefix);
+  if(element_ns) element.ns = *element_ns;
+  else if(prefix.empty()) element.ns = srcml_node::SRC_NAMESPACE;
+  else return false;
+
+  srcml_node::srcml_attribute_map::iterator attributes = element.attributes.begin();
+  for(std::size_t i = 0; i < attribute_count; ++i) {
+
+    const srcml_raw_attribute & raw = raw_attributes[i];
+    srcml_node::srcml_attribute & attribute = attributes[i].second;
+    attribute.name = get_symbol(raw.name);
+
+    if(raw.prefix.empty()) {
+      attribute.ns = srcml_node::SRC_NAMESPACE;
+    } else if(raw.prefix == "xml") {
+      attribute.ns = get_namespace(XML_NAMESPACE_URI, raw.prefix);
+    } else {
+      const std::shared_ptr<srcml_node::srcml_namespace> * attribute_ns = find_binding(raw.prefix);
+      if(!attribute_ns) return false;
+      attribute.ns = *attribute_ns;
+    }
+
+    for(std::size_t j = 0; j < i; ++j) {
+      if(attributes[j].second.name == attribute.name && attributes[j].second.ns == attribute.ns) return false;
+    }
+
+    attributes[i].first = attribute.qualified_name();
+
+  }
+
+  element.content.reset();
+  element.empty = empty;
+  element.extra = empty ? 1 : 0;
+  if(!element.user_data.empty()) element.user_data = boost::any();
+
+  event = element;
+  event_depth = depth;
+
+  if(empty) {
+    pop_bindings();
+    if(depth == 0) seen_root = true;
+  } else {
+    ++depth;
+  }
+
+  return true;
+}
+
+/**
+ * read_end_tag
+ *
+ * The end node is the element kept from its start tag, as libxml2
+ * reports the element itself at its end.
+ */
+bool srcml_tokenizer::read_end_tag() {
+
+  if(depth == 0) return false;
+
+  const boost::string_view name = open_names[depth - 1];
+  const char * name_start = pos + 2;
+  if(std::size_t(end - name_start) < name.size() || std::memcmp(name_start, name.data(), name.size()) != 0) return false;
+
+  pos = name_start + name.size();
+  if(pos < end && is_name_char(*pos)) return false;
+  pos = skip_space(pos, end);
+  if(pos == end || *pos != '>') return false;
+  ++pos;
+
+  --depth;
+  std::swap(event, open_elements[depth]);
+  event.type = srcml_node::srcml_node_type::END;
+  event_depth = depth;
+
+  pop_bindings();
+  if(depth == 0) seen_root = true;
+
+  return true;
+}
+
+/**
+ * read_text
+ *
+ * Read character data up to the next markup.  Text without references
+ * or carriage returns is borrowed from the document, otherwise it is
+ * decoded into a buffer.
+ */
+bool srcml_tokenizer::read_text() {
+
+  const char * start = pos;
+  const char * copied = pos;
+  bool decoded = false;
+
+  while(true) {
+
+    const char * special = find_special(pos, end, '<', '&', ']', true);
+    if(special == end) return false;
+    if(*special == '<') {
+      pos = special;
+      break;
+    }
+
+    if(*special == ']') {
+      if(end - special >= 3 && special[1] == ']' && special[2] == '>') return false;
+      pos = special + 1;
+      continue;
+    }
+
+    if((unsigned char)*special >= 0x80) {
+      std::size_t length = utf8_length(special, end);
+      if(!length) return false;
+      pos = special + length;
+      continue;
+    }
+
+    if(*special != '&' && *special != '\r') return false;
+
+    if(!decoded) {
+      text.clear();
+      decoded = true;
+    }
+    text.append(copied, special - copied);
+
+    pos = special;
+    if(*pos == '&') {
+      if(!read_reference(text)) return false;
+    } else {
+      text += '\n';
+      ++pos;
+      if(pos < end && *pos == '\n') ++pos;
+    }
+    copied = pos;
+
+  }
+
+  if(std::size_t(pos - start) > XML_MAX_TEXT_LENGTH) return false;
+
+  event.clear();
+  event.type = srcml_node::srcml_node_type::TEXT;
+  event.name = TEXT_SYMBOL;
+  if(decoded) {
+    text.append(copied, pos - copied);
+    event.content.assign(text.data(), text.size());
+  } else {
+    event.content.borrow(start, pos - start);
+  }
+  event_depth = depth;
+
+  return true;
+}
+
+/**
+ * read_value
+ * @param quote the quote the value started with
+ * @param value destination of the normalized value
+ *
+ * Read an attribute value after its opening quote.  White space
+ * characters become spaces, as libxml2 normalizes CDATA attributes.
+ */
+bool srcml_tokenizer::read_value(char quote, std::string & value) {
+
+  value.clear();
+
+  while(true) {
+
+    const char * special = find_special(pos, end, quote, '<', '&', false);
+    if(special == end) return false;
+
+    value.append(pos, special - pos);
+    pos = special;
+
+    if(*pos == quote) {
+      ++pos;
+      return true;
+    }
+
+    if(*pos == '&') {
+      if(!read_reference(value)) return false;
+    } else if(*pos == '\t' || *pos == '\n') {
+      value += ' ';
+      ++pos;
+    } else if(*pos == '\r') {
+      value += ' ';
+      ++pos;
+      if(pos < end && *pos == '\n') ++pos;
+    } else if((unsigned char)*pos >= 0x80) {
+      std::size_t length = utf8_length(pos, end);
+      if(!length) return false;
+      value.append(pos, length);
+      pos += length;
+    } else {
+      return false;
+    }
+
+  }
+
+}
+
+/**
+ * read_reference
+ *
+ * Decode the predefined entity or character reference at pos.
+ */
+bool srcml_tokenizer::read_reference(std::string & decoded) {
+
+  static const std::size_t MAX_REFERENCE = 32;
+
+  const char * name = pos + 1;
+  const char * semicolon = (const char *)std::memchr(name, ';', std::min<std::size_t>(end - name, MAX_REFERENCE));
+  if(!semicolon) return false;
+
+  boost::string_view reference(name, semicolon - name);
+  if(reference == "lt")        decoded += '<';
+  else if(reference == "gt")   decoded += '>';
+  else if(reference == "amp")  decoded += '&';
+  else if(reference == "quot") decoded += '"';
+  else if(reference == "apos") decoded += '\'';
+  else if(reference.size() >= 2 && reference[0] == '#') {
+
+    const bool hex = reference[1] == 'x';
+    boost::string_view digits = reference.substr(hex ? 2 : 1);
+    if(digits.empty()) return false;
+
+    unsigned long code_point = 0;
+    for(char c : digits) {
+
+      unsigned long digit;
+      if(c >= '0' && c <= '9') digit = c - '0';
+      else if(hex && c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+      else if(hex && c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+      else return false;
+
+      code_point = code_point * (hex ? 16 : 10) + digit;
+      if(code_point > 0x10FFFF) return false;
+
+    }
+
+    const bool is_char = code_point == 0x9 || code_point == 0xA || code_point == 0xD
+      || (code_point >= 0x20 && code_point <= 0xD7FF) || (code_point >= 0xE000 && code_point <= 0xFFFD)
+      || code_point >= 0x10000;
+    if(!is_char) return false;
+
+    srcml_xml_util::append_utf8(decoded, code_point);
+
+  } else {
+    return false;
+  }
+
+  pos = semicolon + 1;
+  return true;
+}
+
+bool srcml_tokenizer::read_comment() {
+
+  const char * start = pos + 4;
+  const char * close = start;
+  while(true) {
+    close = (const char *)std::memchr(close, '-', end - close);
+    if(!close || end - close < 3) return false;
+    if(close[1] == '-') break;
+    ++close;
+  }
+
+  // "--" may only end a comment
+  if(close[2] != '>' || !is_plain(start, close)) return false;
+
+  event.clear();
+  event.name = COMMENT_SYMBOL;
+  event.content.borrow(start, close - start);
+  event_depth = depth;
+
+  pos = close + 3;
+  return true;
+}
+
+bool srcml_tokenizer::read_processing_instruction() {
+
+  const char * target_start = pos + 2;
+  const char * target_end = scan_name(target_start, end);
+  if(target_start == target_end || !is_name_start(*target_start)
+     || std::memchr(target_start, ':', target_end - target_start)) return false;
+
+  // the reserved target of the XML declaration
+  if(target_end - target_start == 3 && (target_start[0] | 0x20) == 'x' && (target_start[1] | 0x20) == 'm'
+     && (target_start[2] | 0x20) == 'l') return false;
+
+  event.clear();
+  event.name = get_symbol(boost::string_view(target_start, target_end - target_start));
+  event_depth = depth;
+
+  pos = target_end;
+  if(end - pos >= 2 && pos[0] == '?' && pos[1] == '>') {
+    pos += 2;
+    return true;
+  }
+
+  if(pos == end || !srcml_xml_util::is_space(*pos)) return false;
+  const char * start = skip_space(pos, end);
+  const char * close = start;
+  while(true) {
+    close = (const char *)std::memchr(close, '?', end - close);
+    if(!close || close + 1 == end) return false;
+    if(close[1] == '>') break;
+    ++close;
+  }
+
+  if(!is_plain(start, close)) return false;
+
+  event.content.borrow(start, close - start);
+  pos = close + 2;
+  return true;
+}
+
+srcml_symbol srcml_tokenizer::get_symbol(boost::string_view name) {
+
+  std::unordered_map<boost::string_view, srcml_symbol, srcml_name_hash>::const_iterator citr = symbols.find(name);
+  if(citr != symbols.end()) return citr->second;
+
+  srcml_symbol symbol(name.data(), name.size());
+  symbols.emplace(boost::string_view(symbol.str()), symbol);
+  return symbol;
+}
+
+/**
+ * get_namespace
+ * @param uri namespace URI
+ * @param prefix its prefix, empty for the default namespace
+ *
+ * Namespaces are looked up by URI, as srcml_node registers them.
+ */
+std::shared_ptr<srcml_node::srcml_namespace> srcml_tokenizer::get_namespace(const std::string & uri, boost::string_view prefix) {
+
+  for(const std::pair<std::string, std::shared_ptr<srcml_node::srcml_namespace>> & entry : namespaces) {
+    if(entry.first == uri) return entry.second;
+  }
+
+  std::shared_ptr<srcml_node::srcml_namespace> found
+    = srcml_node::get_namespace(uri, prefix.empty() ? boost::optional<std::string>() : boost::optional<std::string>(prefix.to_string()));
+  namespaces.emplace_back(uri, found);
+  return found;
+}
+
+/** the innermost namespace bound to prefix, or null if it is not bound */
+const std::shared_ptr<srcml_node::srcml_namespace> * srcml_tokenizer::find_binding(boost::string_view prefix) const {
+
+  for(std::vector<srcml_binding>::const_reverse_iterator citr = bindings.rbegin(); citr != bindings.rend(); ++citr) {
+    if(citr->prefix == prefix) return &citr->ns;
+  }
+
+  return nullptr;
+}
+
+/** end the scope of the namespaces declared by the element at depth */
+void srcml_tokenizer::pop_bindings() {
+
+  while(!bindings.empty() && bindings.back().depth == depth) {
+    bindings.pop_back();
+  }
+
+}
@@ -0,0 +1,140 @@
+/*
+  srcml_tokenizer.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_TOKENIZER_HPP
+#define INCLUDED_SRCML_TOKENIZER_HPP
+
+#include <srcml_event_parser.hpp>
+#include <srcml_push_parser.hpp>
+#include <srcml_input.hpp>
+
+#include <boost/utility/string_view.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstddef>
+
+/**
+ * srcml_tokenizer
+ *
+ * An event parser for the part of XML that srcML uses: UTF-8 elements,
+ * attributes and namespaces, text with the predefined entities and
+ * character references, comments and processing instructions.  It
+ * parses a document in memory in place, finds the ends of text and
+ * attribute values with SIMD scans, SSE2 and with SRCREADER_AVX2 also
+ * AVX2, and borrows text from the buffer when there is nothing in it
+ * to decode.
+ *
+ * Anything else, a document type declaration, CDATA, another encoding,
+ * and every error, hands the document to a srcml_push_parser, which
+ * parses it again from the start and continues after the events
+ * already handed out.  The events are therefore always those libxml2
+ * reports.
+ */
+class srcml_tokenizer : public srcml_event_parser {
+
+private:
+
+  /** a namespace prefix in scope; the default namespace has an empty prefix */
+  class srcml_binding {
+
+  public:
+
+    boost::string_view prefix;
+    std::shared_ptr<srcml_node::srcml_namespace> ns;
+    std::size_t depth;
+
+  };
+
+  /** an attribute name as written, resolved once the whole start tag is read */
+  class srcml_raw_attribute {
+
+  public:
+
+    boost::string_view prefix;
+    boost::string_view name;
+
+  };
+
+  class srcml_name_hash {
+
+  public:
+
+    std::size_t operator()(boost::string_view name) const;
+
+  };
+
+  const char * data;
+  std::size_t size;
+  const char * pos;
+  const char * end;
+  bool in_dialect;
+
+  srcml_node event;
+  std::size_t event_depth;
+
+  std::vector<srcml_node> open_elements;
+  std::vector<boost::string_view> open_names;
+  std::size_t depth;
+  bool seen_root;
+
+  std::vector<srcml_binding> bindings;
+  std::vector<srcml_raw_attribute> raw_attributes;
+  std::vector<std::pair<std::string, std::shared_ptr<srcml_node::srcml_namespace>>> namespaces;
+  std::unordered_map<boost::string_view, srcml_symbol, srcml_name_hash> symbols;
+  std::string text;
+
+  std::size_t delivered;
+  std::unique_ptr<srcml_memory_input> fallback_input;
+  std::unique_ptr<srcml_push_parser> fallback;
+
+  bool read_declaration();
+  int tokenize();
+  bool read_start_tag();
+  bool read_end_tag();
+  bool read_text();
+  bool read_comment();
+  bool read_processing_instruction();
+  bool read_value(char quote, std::string & value);
+  bool read_reference(std::string & decoded);
+
+  srcml_symbol get_symbol(boost::string_view name);
+  std::shared_ptr<srcml_node::srcml_namespace> get_namespace(const std::string & uri, boost::string_view prefix);
+  const std::shared_ptr<srcml_node::srcml_namespace> * find_binding(boost::string_view prefix) const;
+  void pop_bindings();
+  int fall_back();
+
+public:
+
+  srcml_tokenizer(const char * data, std::size_t size);
+
+  virtual int next();
+  virtual srcml_node & current() { return fallback ? fallback->current() : event; }
+  virtual std::size_t current_depth() const { return fallback ? fallback->current_depth() : event_depth; }
+  virtual std::size_t bytes_consumed() const { return fallback ? fallback->bytes_consumed() : std::size_t(pos - data); }
+
+};
+
+#endif
@@ -0,0 +1,205 @@
+/*
+  srcml_unit_builder.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_unit_builder.hpp>
+
+
+class srcml_unit_builder_error : public std::runtime_error {
+public:
+  srcml_unit_builder_error(const std::string & what_arg) : std::runtime_error(what_arg) {}
+
+};
+
+static const srcml_symbol UNIT_SYMBOL("unit");
+
+/**
+ * A unit attribute srcML writes and what passes it to libsrcml, if
+ * anything; libsrcml generates the attributes without a setter.
+ */
+class srcml_unit_attribute_handler {
+public:
+  srcml_symbol name;
+  int (*set)(srcml_unit * unit, const char * value);
+
+};
+
+static const srcml_unit_attribute_handler UNIT_ATTRIBUTE_HANDLERS[] = {
+  { srcml_symbol("language"), srcml_unit_set_language },
+  { srcml_symbol("filename"), srcml_unit_set_filename },
+  { srcml_symbol("hash"),     nullptr },
+  { srcml_symbol("revision"), nullptr },
+  { srcml_symbol("author"),   nullptr },
+  { srcml_symbol("modifier"), nullptr },
+};
+
+/** the message is only built on an error, as these are called for every node */
+static void check_srcml_error(int error_code, const char * message, const std::string & detail = std::string()) {
+  if(error_code != SRCML_STATUS_OK) throw srcml_unit_builder_error(message + detail);
+}
+
+srcml_unit_builder::srcml_unit_builder(srcml_unit * unit)
+  : unit(unit), depth(0), complete(false), pending_text() {
+
+  if(!unit) throw srcml_unit_builder_error("Failure creating srcML Unit");
+
+}
+
+srcml_unit_builder::~srcml_unit_builder() {
+  srcml_unit_free(unit);
+}
+
+/**
+ * write
+ * @param node the next node of the unit
+ *
+ * The first node must be the unit's start tag; text before it, such as
+ * the whitespace between the units of an archive, is ignored.  Nothing
+ * may follow the unit's end tag.
+ */
+bool srcml_unit_builder::write(const srcml_node & node) {
+
+  if(complete) throw srcml_unit_builder_error("Unit is already complete");
+
+  if(!depth) {
+
+    if(node.is_text()) return true;
+    if(!node.is_start() || node.name != UNIT_SYMBOL) throw srcml_unit_builder_error("Expected the start of a unit");
+
+    check_srcml_error(srcml_write_start_unit(unit), "Error starting unit");
+    set_unit_attributes(unit, node.attributes);
+    ++depth;
+
+    if(node.is_empty()) {
+      check_srcml_error(srcml_write_end_unit(unit), "Error ending unit");
+      depth = 0;
+      complete = true;
+    }
+
+    return true;
+
+  }
+
+  if(!node.is_text()) write_pending_text(unit, pending_text);
+
+  switch(node.type) {
+
+    case srcml_node::srcml_node_type::START:
+      write_start_element(unit, node);
+      if(node.is_empty()) {
+        write_end_element(unit);
+      } else {
+        ++depth;
+      }
+      break;
+
+    case srcml_node::srcml_node_type::END:
+      if(--depth) {
+        write_end_element(unit);
+      } else {
+        check_srcml_error(srcml_write_end_unit(unit), "Error ending unit");
+        complete = true;
+      }
+      break;
+
+    case srcml_node::srcml_node_type::TEXT:
+      if(!node.content) break;
+      if(!node.attributes.size()) {
+        pending_text.append(node.content.data(), node.content.size());
+        break;
+      }
+      write_pending_text(unit, pending_text);
+      write_start_element(unit, node);
+      write_string(unit, node);
+      write_end_element(unit);
+      break;
+
+    default:
+      throw srcml_unit_builder_error("Invalid srcml_node type: " + std::to_string(node.type));
+
+  }
+
+  return true;
+}
+
+/**
+ * set_unit_attributes
+ *
+ * Pass the attributes of a unit start tag to libsrcml.  Names are
+ * matched by symbol against UNIT_ATTRIBUTE_HANDLERS.
+ */
+void srcml_unit_builder::set_unit_attributes(srcml_unit * unit, const srcml_node::srcml_attribute_map & attributes) {
+
+  for(const srcml_node::srcml_attribute_map_pair & attr : attributes) {
+
+    const srcml_unit_attribute_handler * handler = std::begin(UNIT_ATTRIBUTE_HANDLERS);
+    while(handler != std::end(UNIT_ATTRIBUTE_HANDLERS) && handler->name != attr.first) {
+      ++handler;
+    }
+    if(handler == std::end(UNIT_ATTRIBUTE_HANDLERS)) throw srcml_unit_builder_error("Unimplemented attribute: " + attr.first);
+
+    if(handler->set) check_srcml_error(handler->set(unit, attr.second.value ? attr.second.value->c_str() : 0), "Error setting archive", attr.first);
+
+  }
+
+}
+
+void srcml_unit_builder::write_start_element(srcml_unit * unit, const srcml_node & node) {
+
+  check_srcml_error(srcml_write_start_element(unit, node.ns->prefix ? node.ns->prefix->c_str() : 0, node.name.c_str(), node.ns->uri.c_str()),
+                    "Error writing start tag");
+
+  for(const std::shared_ptr<srcml_node::srcml_namespace> & ns : node.ns_definition) {
+    check_srcml_error(srcml_write_namespace(unit, ns->prefix ? ns->prefix->c_str() : 0, ns->uri.c_str()), "Error writing namespace", ns->uri);
+  }
+
+  /** @TODO FIX as this is temporary fix for srcml writing out namespace */
+  for(const srcml_node::srcml_attribute_map_pair & attr : node.attributes) {
+    check_srcml_error(srcml_write_attribute(unit, 0, attr.second.full_name().c_str(), 0, attr.second.value ? attr.second.value->c_str() : 0),
+                      "Error writing attribute", attr.first);
+  }
+
+}
+
+void srcml_unit_builder::write_end_element(srcml_unit * unit) {
+  check_srcml_error(srcml_write_end_element(unit), "Error writing end tag");
+}
+
+void srcml_unit_builder::write_string(srcml_unit * unit, const srcml_node & node) {
+  check_srcml_error(srcml_write_string(unit, node.content->c_str()), "Error writing text");
+}
+
+/**
+ * write_pending_text
+ *
+ * Write adjacent text, e.g., the whitespace and non-whitespace runs the
+ * reader splits text into, collected in pending_text, with one call to
+ * libsrcml, and clear it.  Called before each tag.
+ */
+void srcml_unit_builder::write_pending_text(srcml_unit * unit, std::string & pending_text) {
+
+  if(pending_text.empty()) return;
+
+  check_srcml_error(srcml_write_string(unit, pending_text.c_str()), "Error writing text");
+  pending_text.clear();
+
+}
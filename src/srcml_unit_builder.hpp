@@ -0,0 +1,84 @@
+/*
+  srcml_unit_builder.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_UNIT_BUILDER_HPP
+#define INCLUDED_SRCML_UNIT_BUILDER_HPP
+
+#include <srcml_node.hpp>
+
+#include <srcml.h>
+
+#include <string>
+#include <stdexcept>
+
+class srcml_unit_builder_error;
+
+/**
+ * srcml_unit_builder
+ *
+ * Builds one unit of a srcml_writer's archive from the nodes of the
+ * unit, from its start tag to its end tag.  libsrcml keeps a unit's
+ * srcML with the unit until it is written to the archive, so builders
+ * for different units can be used on different threads at once.  A
+ * complete unit is appended with srcml_writer::write_unit(), or in a
+ * fixed order by a srcml_unit_committer.
+ *
+ * The static members write single nodes, and text collected from
+ * adjacent nodes, to a libsrcml unit, as srcml_writer does too.
+ */
+class srcml_unit_builder {
+
+private:
+
+  srcml_unit * unit;
+  std::size_t depth;
+  bool complete;
+
+  /** adjacent text, written as one string when the next tag arrives */
+  std::string pending_text;
+
+  srcml_unit_builder(srcml_unit * unit);
+
+public:
+
+  ~srcml_unit_builder();
+
+  srcml_unit_builder(const srcml_unit_builder &) = delete;
+  srcml_unit_builder & operator=(const srcml_unit_builder &) = delete;
+
+  bool write(const srcml_node & node);
+
+  /** true once the end tag of the unit is written */
+  bool is_complete() const { return complete; }
+
+  static void set_unit_attributes(srcml_unit * unit, const srcml_node::srcml_attribute_map & attributes);
+  static void write_start_element(srcml_unit * unit, const srcml_node & node);
+  static void write_end_element(srcml_unit * unit);
+  static void write_string(srcml_unit * unit, const srcml_node & node);
+  static void write_pending_text(srcml_unit * unit, std::string & pending_text);
+
+  friend class srcml_writer;
+
+};
+
+#endif
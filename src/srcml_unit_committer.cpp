@@ -0,0 +1,106 @@
+/*
+  srcml_unit_committer.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_unit_committer.hpp>
+
+#include <stdexcept>
+
+class srcml_unit_committer_error : public std::runtime_error {
+public:
+  srcml_unit_committer_error(const std::string & what_arg) : std::runtime_error(what_arg) {}
+
+};
+
+srcml_unit_committer::srcml_unit_committer(srcml_writer & writer)
+  : writer(writer), mutex(), submitted(0), written(0), waiting(), error() {}
+
+/**
+ * submit
+ *
+ * The position in the archive of the next unit.  Safe to call from
+ * several threads, though the order positions are handed out in is
+ * then up to the threads.
+ */
+std::size_t srcml_unit_committer::submit() {
+
+  std::lock_guard<std::mutex> lock(mutex);
+  return submitted++;
+
+}
+
+/**
+ * commit
+ * @param position position of the unit from submit()
+ * @param builder the complete unit
+ *
+ * Write the unit if all units before it are written, or hold it until
+ * they are.  Safe to call from several threads.
+ */
+void srcml_unit_committer::commit(std::size_t position, std::unique_ptr<srcml_unit_builder> builder) {
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if(error) std::rethrow_exception(error);
+  if(position < written || position >= submitted || waiting.count(position))
+    throw srcml_unit_committer_error("Unit position " + std::to_string(position) + " is not waiting to be committed");
+  if(!builder || !builder->is_complete()) throw srcml_unit_committer_error("Unit is not complete");
+
+  if(position != written) {
+    waiting.emplace(position, std::move(builder));
+    return;
+  }
+
+  try {
+
+    writer.write_unit(*builder);
+    ++written;
+
+    std::map<std::size_t, std::unique_ptr<srcml_unit_builder>>::iterator next;
+    while((next = waiting.find(written)) != waiting.end()) {
+      writer.write_unit(*next->second);
+      waiting.erase(next);
+      ++written;
+    }
+
+  } catch(...) {
+    error = std::current_exception();
+    throw;
+  }
+
+}
+
+/**
+ * finish
+ *
+ * Check that every submitted unit has been written, e.g., before the
+ * end of the archive root is written.
+ */
+void srcml_unit_committer::finish() {
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if(error) std::rethrow_exception(error);
+  if(written != submitted)
+    throw srcml_unit_committer_error(std::to_string(submitted - written) + " submitted units were not committed");
+
+}
@@ -0,0 +1,71 @@
+/*
+  srcml_unit_committer.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_UNIT_COMMITTER_HPP
+#define INCLUDED_SRCML_UNIT_COMMITTER_HPP
+
+#include <srcml_writer.hpp>
+#include <srcml_unit_builder.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <exception>
+
+class srcml_unit_committer_error;
+
+/**
+ * srcml_unit_committer
+ *
+ * Appends units built on several threads to a srcml_writer's archive
+ * in the order they were submitted, whatever order they finish in.
+ * submit() hands out consecutive positions starting at 0.  A thread
+ * that commits the next unit to be written also writes any later units
+ * that were waiting on it; earlier units are held until then.
+ *
+ * If writing a unit throws, that commit rethrows the error and so does
+ * every later commit() and finish().
+ */
+class srcml_unit_committer {
+
+private:
+
+  srcml_writer & writer;
+
+  std::mutex mutex;
+  std::size_t submitted;
+  std::size_t written;
+  std::map<std::size_t, std::unique_ptr<srcml_unit_builder>> waiting;
+  std::exception_ptr error;
+
+public:
+
+  srcml_unit_committer(srcml_writer & writer);
+
+  std::size_t submit();
+  void commit(std::size_t position, std::unique_ptr<srcml_unit_builder> builder);
+  void finish();
+
+};
+
+#endif
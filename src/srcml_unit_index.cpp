@@ -0,0 +1,391 @@
+/*
+  srcml_unit_index.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_unit_index.hpp>
+#include <srcml_unit_locator.hpp>
+#include <srcml_xml_util.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <limits>
+
+class srcml_unit_index_error : public std::runtime_error {
+public:
+  srcml_unit_index_error(const std::string & what_arg) : std::runtime_error(what_arg) {}
+
+};
+
+/*
+  Sidecar layout, all integers little-endian:
+
+    "SRCMLIDX" u32 version u32 flags
+    u64 source size u64 source mtime u64 prolog size u64 prolog checksum
+    u64 unit count u64 strings size
+    u64 root name offset u64 root name size
+    per unit: u64 offset u64 length u64 start tag length u64 start tag checksum
+              u64 offset/size of filename, language and hash
+    per unit: u32 unit number, in filename order
+    strings
+*/
+static const char INDEX_MAGIC[8] = { 'S', 'R', 'C', 'M', 'L', 'I', 'D', 'X' };
+static const std::uint32_t INDEX_VERSION = 2;
+static const std::uint32_t ARCHIVE_FLAG = 1;
+static const std::size_t HEADER_SIZE = 8 + 4 + 4 + 8 * 8;
+static const std::size_t UNIT_SIZE = 8 * 4 + 8 * 6;
+
+static void write_integer(std::string & out, std::uint64_t value, int bytes) {
+  for(int i = 0; i < bytes; ++i) {
+    out += char((value >> (8 * i)) & 0xff);
+  }
+}
+
+static std::uint64_t read_integer(const char *& pos, int bytes) {
+  std::uint64_t value = 0;
+  for(int i = 0; i < bytes; ++i) {
+    value |= std::uint64_t((unsigned char)pos[i]) << (8 * i);
+  }
+  pos += bytes;
+  return value;
+}
+
+/** attribute value with entity and character references replaced */
+static std::string unescape(const char * start, const char * end) {
+
+  std::string value;
+  value.reserve(end - start);
+
+  for(const char * pos = start; pos < end; ++pos) {
+
+    const char * semicolon = *pos == '&' ? (const char *)std::memchr(pos, ';', end - pos) : nullptr;
+    if(!semicolon) {
+      value += *pos;
+      continue;
+    }
+
+    std::string entity(pos + 1, semicolon);
+    if(entity == "amp")       value += '&';
+    else if(entity == "lt")   value += '<';
+    else if(entity == "gt")   value += '>';
+    else if(entity == "quot") value += '"';
+    else if(entity == "apos") value += '\'';
+    else if(entity.size() > 1 && entity[0] == '#' && (entity[1] == 'x' || entity[1] == 'X'))
+      srcml_xml_util::append_utf8(value, std::strtoul(entity.c_str() + 2, nullptr, 16));
+    else if(entity.size() > 1 && entity[0] == '#')
+      srcml_xml_util::append_utf8(value, std::strtoul(entity.c_str() + 1, nullptr, 10));
+    else
+      value.append(pos, semicolon + 1);
+
+    pos = semicolon;
+  }
+
+  return value;
+}
+
+/** value of an unprefixed attribute in a start tag */
+static std::string find_attribute(const char * tag, std::size_t length, const char * name) {
+
+  const char * end = tag + length;
+  std::size_t name_length = std::strlen(name);
+
+  const char * pos = tag + 1;
+  while(pos < end && !srcml_xml_util::is_space(*pos) && *pos != '>' && *pos != '/') ++pos;
+
+  while(pos < end) {
+
+    while(pos < end && srcml_xml_util::is_space(*pos)) ++pos;
+    if(pos >= end || *pos == '>' || *pos == '/') break;
+
+    const char * attribute = pos;
+    while(pos < end && *pos != '=' && !srcml_xml_util::is_space(*pos)) ++pos;
+    const char * attribute_end = pos;
+
+    while(pos < end && (srcml_xml_util::is_space(*pos) || *pos == '=')) ++pos;
+    if(pos >= end) break;
+
+    char quote = *pos++;
+    const char * value = pos;
+    while(pos < end && *pos != quote) ++pos;
+    if(pos >= end) break;
+
+    if(std::size_t(attribute_end - attribute) == name_length && std::memcmp(attribute, name, name_length) == 0)
+      return unescape(value, pos);
+
+    ++pos;
+  }
+
+  return std::string();
+}
+
+srcml_unit_index::srcml_unit_index()
+  : archive(false), source_size(0), source_mtime(0), prolog_size(0), prolog_checksum(0), root_name(), units(), by_filename(), strings() {}
+
+/**
+ * srcml_unit_index
+ * @param data srcML document in memory
+ * @param size length of the document
+ * @param source_mtime modification time of the document's file, or 0
+ *
+ * Build the index with a single scan of the document.  Only the start
+ * tags of the units are examined for their attributes.
+ */
+srcml_unit_index::srcml_unit_index(const char * data, std::size_t size, std::uint64_t source_mtime)
+  : srcml_unit_index() {
+
+  srcml_unit_locator locator(data, size);
+
+  // units are numbered with 32 bits in the sidecar
+  if(locator.get_units().size() > std::numeric_limits<std::uint32_t>::max())
+    throw srcml_unit_index_error("Too many units to index");
+
+  archive = locator.is_archive();
+  source_size = size;
+  this->source_mtime = source_mtime;
+  prolog_size = locator.get_prolog_size();
+  prolog_checksum = srcml_xml_util::checksum(data, prolog_size);
+  root_name = add_string(locator.get_root_name());
+
+  units.reserve(locator.get_units().size());
+  for(const srcml_unit_locator::srcml_unit_range & range : locator.get_units()) {
+
+    srcml_unit_entry unit;
+    unit.offset = range.offset;
+    unit.length = range.length;
+    unit.start_tag_length = range.start_tag_length;
+    unit.start_tag_checksum = srcml_xml_util::checksum(data + range.offset, range.start_tag_length);
+
+    const char * tag = data + range.offset;
+    unit.filename = add_string(find_attribute(tag, range.start_tag_length, "filename"));
+    unit.language = add_string(find_attribute(tag, range.start_tag_length, "language"));
+    unit.hash = add_string(find_attribute(tag, range.start_tag_length, "hash"));
+
+    units.push_back(unit);
+  }
+
+  sort_filenames();
+
+}
+
+std::string srcml_unit_index::sidecar_filename(const std::string & archive) {
+  return archive + ".idx";
+}
+
+/**
+ * matches
+ * @param data srcML document in memory
+ * @param size length of the document
+ * @param source_mtime modification time of the document's file
+ *
+ * Whether this index is of the document, by its size, modification time
+ * and the checksum of its prolog.  A unit's own start tag is checked
+ * with unit_matches() before it is read.
+ */
+bool srcml_unit_index::matches(const char * data, std::size_t size, std::uint64_t source_mtime) const {
+
+  return size == source_size && source_mtime == this->source_mtime
+      && prolog_size <= size && srcml_xml_util::checksum(data, prolog_size) == prolog_checksum;
+
+}
+
+/**
+ * unit_matches
+ * @param data srcML document in memory, of the size this index is of
+ * @param unit_number position of the unit
+ *
+ * Whether the unit's start tag in the document is the one indexed.
+ */
+bool srcml_unit_index::unit_matches(const char * data, std::size_t unit_number) const {
+
+  const srcml_unit_entry & unit = units[unit_number];
+  return srcml_xml_util::checksum(data + unit.offset, unit.start_tag_length) == unit.start_tag_checksum;
+
+}
+
+srcml_unit_index::srcml_string_ref srcml_unit_index::add_string(const std::string & str) {
+
+  srcml_string_ref ref;
+  ref.offset = strings.size();
+  ref.size = str.size();
+  strings += str;
+
+  return ref;
+}
+
+boost::string_view srcml_unit_index::get_string(srcml_string_ref ref) const {
+  return boost::string_view(strings.data() + ref.offset, ref.size);
+}
+
+void srcml_unit_index::sort_filenames() {
+
+  by_filename.resize(units.size());
+  for(std::size_t i = 0; i < units.size(); ++i) {
+    by_filename[i] = i;
+  }
+
+  std::stable_sort(by_filename.begin(), by_filename.end(), [this](std::uint32_t first, std::uint32_t second) {
+    return get_string(units[first].filename) < get_string(units[second].filename);
+  });
+
+}
+
+void srcml_unit_index::save(const std::string & filename) const {
+
+  std::string out;
+  out.reserve(HEADER_SIZE + units.size() * (UNIT_SIZE + 4) + strings.size());
+
+  out.append(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+  write_integer(out, INDEX_VERSION, 4);
+  write_integer(out, archive ? ARCHIVE_FLAG : 0, 4);
+  write_integer(out, source_size, 8);
+  write_integer(out, source_mtime, 8);
+  write_integer(out, prolog_size, 8);
+  write_integer(out, prolog_checksum, 8);
+  write_integer(out, units.size(), 8);
+  write_integer(out, strings.size(), 8);
+  write_integer(out, root_name.offset, 8);
+  write_integer(out, root_name.size, 8);
+
+  for(const srcml_unit_entry & unit : units) {
+    write_integer(out, unit.offset, 8);
+    write_integer(out, unit.length, 8);
+    write_integer(out, unit.start_tag_length, 8);
+    write_integer(out, unit.start_tag_checksum, 8);
+    write_integer(out, unit.filename.offset, 8);
+    write_integer(out, unit.filename.size, 8);
+    write_integer(out, unit.language.offset, 8);
+    write_integer(out, unit.language.size, 8);
+    write_integer(out, unit.hash.offset, 8);
+    write_integer(out, unit.hash.size, 8);
+  }
+
+  for(std::uint32_t unit_number : by_filename) {
+    write_integer(out, unit_number, 4);
+  }
+
+  out += strings;
+
+  std::ofstream file(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+  file.write(out.data(), out.size());
+  if(!file) throw srcml_unit_index_error("Error writing: " + filename);
+
+}
+
+void srcml_unit_index::load(const std::string & filename) {
+
+  std::ifstream file(filename, std::ios::in | std::ios::binary);
+  if(!file) throw srcml_unit_index_error("Error openining: " + filename);
+
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  const std::string in = contents.str();
+
+  if(in.size() < HEADER_SIZE || std::memcmp(in.data(), INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0)
+    throw srcml_unit_index_error("Not a unit index: " + filename);
+
+  const char * pos = in.data() + sizeof(INDEX_MAGIC);
+  if(read_integer(pos, 4) != INDEX_VERSION) throw srcml_unit_index_error("Unsupported unit index version: " + filename);
+
+  archive = read_integer(pos, 4) & ARCHIVE_FLAG;
+  source_size = read_integer(pos, 8);
+  source_mtime = read_integer(pos, 8);
+  prolog_size = read_integer(pos, 8);
+  prolog_checksum = read_integer(pos, 8);
+  std::uint64_t count = read_integer(pos, 8);
+  std::uint64_t strings_size = read_integer(pos, 8);
+  root_name.offset = read_integer(pos, 8);
+  root_name.size = read_integer(pos, 8);
+
+  // sizes are checked by division, so a corrupt count or strings size cannot overflow
+  std::uint64_t body_size = in.size() - HEADER_SIZE;
+  if(count > body_size / (UNIT_SIZE + 4) || strings_size != body_size - count * (UNIT_SIZE + 4))
+    throw srcml_unit_index_error("Truncated unit index: " + filename);
+
+  units.resize(count);
+  for(srcml_unit_entry & unit : units) {
+    unit.offset = read_integer(pos, 8);
+    unit.length = read_integer(pos, 8);
+    unit.start_tag_length = read_integer(pos, 8);
+    unit.start_tag_checksum = read_integer(pos, 8);
+    unit.filename.offset = read_integer(pos, 8);
+    unit.filename.size = read_integer(pos, 8);
+    unit.language.offset = read_integer(pos, 8);
+    unit.language.size = read_integer(pos, 8);
+    unit.hash.offset = read_integer(pos, 8);
+    unit.hash.size = read_integer(pos, 8);
+  }
+
+  by_filename.resize(count);
+  for(std::uint32_t & unit_number : by_filename) {
+    unit_number = read_integer(pos, 4);
+    if(unit_number >= count) throw srcml_unit_index_error("Corrupt unit index: " + filename);
+  }
+
+  strings.assign(pos, strings_size);
+
+  auto in_strings = [strings_size](srcml_string_ref ref) { return ref.offset <= strings_size && ref.size <= strings_size - ref.offset; };
+  bool valid = in_strings(root_name) && prolog_size <= source_size;
+  for(const srcml_unit_entry & unit : units) {
+    valid = valid && in_strings(unit.filename) && in_strings(unit.language) && in_strings(unit.hash)
+                  && unit.offset <= source_size && unit.length <= source_size - unit.offset
+                  && unit.start_tag_length <= unit.length;
+  }
+  if(!valid) throw srcml_unit_index_error("Corrupt unit index: " + filename);
+
+}
+
+std::string srcml_unit_index::get_root_end_tag() const {
+  return "</" + get_string(root_name).to_string() + ">";
+}
+
+boost::string_view srcml_unit_index::get_filename(std::size_t unit_number) const {
+  return get_string(units[unit_number].filename);
+}
+
+boost::string_view srcml_unit_index::get_language(std::size_t unit_number) const {
+  return get_string(units[unit_number].language);
+}
+
+boost::string_view srcml_unit_index::get_hash(std::size_t unit_number) const {
+  return get_string(units[unit_number].hash);
+}
+
+/**
+ * find
+ * @param filename filename attribute of a unit
+ *
+ * Binary search of the units in filename order.
+ */
+std::size_t srcml_unit_index::find(boost::string_view filename) const {
+
+  std::vector<std::uint32_t>::const_iterator itr = std::lower_bound(by_filename.begin(), by_filename.end(), filename,
+    [this](std::uint32_t unit_number, boost::string_view value) {
+      return get_string(units[unit_number].filename) < value;
+    });
+
+  if(itr == by_filename.end() || get_string(units[*itr].filename) != filename) return npos;
+
+  return *itr;
+}
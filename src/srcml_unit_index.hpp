@@ -0,0 +1,135 @@
+/*
+  srcml_unit_index.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_UNIT_INDEX_HPP
+#define INCLUDED_SRCML_UNIT_INDEX_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/utility/string_view.hpp>
+
+class srcml_unit_index_error;
+
+/**
+ * srcml_unit_index
+ *
+ * Byte range, filename, language and hash of every unit in a srcML
+ * archive.  An index is built with one scan of the archive and can be
+ * saved to a compact sidecar file, so later runs can jump straight to
+ * a unit by position or by filename.  The index records the archive's
+ * size, modification time and checksums of its prolog and of each
+ * unit's start tag, so a stale sidecar is detected.
+ */
+class srcml_unit_index {
+
+private:
+
+  class srcml_string_ref {
+
+  public:
+
+    std::uint64_t offset;
+    std::uint64_t size;
+
+    srcml_string_ref() : offset(0), size(0) {}
+
+  };
+
+public:
+
+  static const std::size_t npos = std::size_t(-1);
+
+  class srcml_unit_entry {
+
+  private:
+
+    srcml_string_ref filename;
+    srcml_string_ref language;
+    srcml_string_ref hash;
+    std::uint64_t start_tag_checksum;
+
+  public:
+
+    std::uint64_t offset;
+    std::uint64_t length;
+    std::uint64_t start_tag_length;
+
+    srcml_unit_entry() : filename(), language(), hash(), start_tag_checksum(0), offset(0), length(0), start_tag_length(0) {}
+
+    friend class srcml_unit_index;
+
+  };
+
+private:
+
+  bool archive;
+  std::uint64_t source_size;
+  std::uint64_t source_mtime;
+  std::uint64_t prolog_size;
+  std::uint64_t prolog_checksum;
+  srcml_string_ref root_name;
+
+  std::vector<srcml_unit_entry> units;
+  std::vector<std::uint32_t> by_filename;
+  std::string strings;
+
+  srcml_string_ref add_string(const std::string & str);
+  boost::string_view get_string(srcml_string_ref ref) const;
+  void sort_filenames();
+
+public:
+
+  srcml_unit_index();
+  srcml_unit_index(const char * data, std::size_t size, std::uint64_t source_mtime = 0);
+
+  /** default sidecar file for an archive */
+  static std::string sidecar_filename(const std::string & archive);
+
+  void save(const std::string & filename) const;
+  void load(const std::string & filename);
+
+  bool matches(const char * data, std::size_t size, std::uint64_t source_mtime) const;
+  bool unit_matches(const char * data, std::size_t unit_number) const;
+
+  bool is_archive() const { return archive; }
+  std::uint64_t get_source_size() const { return source_size; }
+  std::uint64_t get_source_mtime() const { return source_mtime; }
+  std::uint64_t get_prolog_size() const { return prolog_size; }
+  std::string get_root_end_tag() const;
+
+  std::size_t size() const { return units.size(); }
+  const srcml_unit_entry & get_unit(std::size_t unit_number) const { return units[unit_number]; }
+
+  boost::string_view get_filename(std::size_t unit_number) const;
+  boost::string_view get_language(std::size_t unit_number) const;
+  boost::string_view get_hash(std::size_t unit_number) const;
+
+  /** position of the first unit with the filename, or npos */
+  std::size_t find(boost::string_view filename) const;
+
+};
+
+#endif
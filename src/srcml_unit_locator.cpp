@@ -0,0 +1,213 @@
+/*
+  srcml_unit_locator.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcml_unit_locator.hpp>
+#include <srcml_xml_util.hpp>
+
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <cstring>
+
+class srcml_unit_locator_error : public std::runtime_error {
+public:
+  srcml_unit_locator_error(const std::string & what_arg) : std::runtime_error(what_arg) {}
+
+};
+
+srcml_unit_locator::srcml_unit_locator(const char * data, std::size_t size)
+  : data(data), size(size), root_name(), root_offset(0), root_start_tag_end(0), archive(false), units() {
+
+  locate();
+
+}
+
+std::string srcml_unit_locator::get_root_end_tag() const {
+  return "</" + root_name + ">";
+}
+
+static const char * find_string(const char * start, const char * end, const char * str) {
+
+  std::size_t length = std::strlen(str);
+  while(start + length <= end) {
+    const char * found = (const char *)std::memchr(start, str[0], end - start);
+    if(!found || found + length > end) return nullptr;
+    if(std::memcmp(found, str, length) == 0) return found;
+    start = found + 1;
+  }
+
+  return nullptr;
+}
+
+/** end of a start or end tag, skipping '>' inside quoted attribute values */
+static const char * find_tag_end(const char * start, const char * end) {
+
+  for(const char * pos = start; pos < end; ++pos) {
+
+    if(*pos == '>') return pos;
+
+    if(*pos == '"' || *pos == '\'') {
+      pos = (const char *)std::memchr(pos + 1, *pos, end - pos - 1);
+      if(!pos) return nullptr;
+    }
+
+  }
+
+  return nullptr;
+}
+
+static bool is_name_end(char ch) {
+  return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == '/' || ch == '>';
+}
+
+static bool is_unit(const char * name, std::size_t length) {
+  return (length == 4 && std::memcmp(name, "unit", 4) == 0)
+      || (length > 5 && std::memcmp(name + length - 5, ":unit", 5) == 0);
+}
+
+/**
+ * locate
+ *
+ * Scan the document for its units.  Malformed markup throws, as it does
+ * for a reader, instead of silently dropping a partial unit: an
+ * unterminated tag, comment or processing instruction, an end tag that
+ * does not match its start tag, a document that ends inside its root,
+ * and anything but markup and whitespace after the root.
+ */
+void srcml_unit_locator::locate() {
+
+  const char * begin = data;
+  const char * end = data + size;
+
+  // names of the open elements
+  std::vector<std::pair<const char *, std::size_t>> open;
+  bool have_root = false;
+  bool closed_root = false;
+  const char * unit_start = nullptr;
+  std::size_t unit_start_tag_length = 0;
+
+  const char * pos = begin;
+
+  // a UTF-8 byte order mark
+  if(size >= 3 && std::memcmp(begin, "\xEF\xBB\xBF", 3) == 0) pos += 3;
+
+  while(pos < end) {
+
+    const char * tag = (const char *)std::memchr(pos, '<', end - pos);
+
+    // only markup and whitespace are allowed outside of the root
+    if(open.empty()) {
+      for(const char * text = pos; text < (tag ? tag : end); ++text) {
+        if(!srcml_xml_util::is_space(*text)) throw srcml_unit_locator_error("Content outside of the root element");
+      }
+    }
+
+    if(!tag) break;
+    if(tag + 1 >= end) throw srcml_unit_locator_error("Unterminated tag at end of document");
+
+    // processing instructions, comments, CDATA and declarations
+    if(tag[1] == '?' || tag[1] == '!') {
+
+      const char * close = nullptr;
+      if(tag[1] == '?')
+        close = find_string(tag + 2, end, "?>");
+      else if(end - tag >= 4 && std::memcmp(tag, "<!--", 4) == 0)
+        close = find_string(tag + 4, end, "-->");
+      else if(end - tag >= 9 && std::memcmp(tag, "<![CDATA[", 9) == 0)
+        close = find_string(tag + 9, end, "]]>");
+      else
+        close = find_tag_end(tag + 2, end);
+
+      if(!close) throw srcml_unit_locator_error("Unterminated markup at offset " + std::to_string(tag - begin));
+      pos = (const char *)std::memchr(close, '>', end - close) + 1;
+      continue;
+    }
+
+    bool is_end_tag = tag[1] == '/';
+    const char * name = tag + (is_end_tag ? 2 : 1);
+    const char * name_end = name;
+    while(name_end < end && !is_name_end(*name_end)) ++name_end;
+
+    const char * tag_end = find_tag_end(name_end, end);
+    if(!tag_end) throw srcml_unit_locator_error("Unterminated tag at offset " + std::to_string(tag - begin));
+    pos = tag_end + 1;
+
+    if(closed_root) throw srcml_unit_locator_error("Element after the root element at offset " + std::to_string(tag - begin));
+
+    if(is_end_tag) {
+
+      std::size_t length = name_end - name;
+      if(open.empty() || open.back().second != length || std::memcmp(open.back().first, name, length) != 0)
+        throw srcml_unit_locator_error("Unbalanced end tag at offset " + std::to_string(tag - begin));
+      open.pop_back();
+
+      if(open.size() == 1 && unit_start) {
+        units.emplace_back(unit_start - begin, pos - unit_start, unit_start_tag_length);
+        unit_start = nullptr;
+      }
+
+      if(open.empty()) {
+        if(units.empty()) units.emplace_back(root_offset, pos - begin - root_offset, root_start_tag_end - root_offset);
+        else archive = true;
+        closed_root = true;
+      }
+
+      continue;
+    }
+
+    bool is_empty = tag_end[-1] == '/';
+
+    if(!have_root) {
+      have_root = true;
+      root_name.assign(name, name_end);
+      root_offset = tag - begin;
+      root_start_tag_end = pos - begin;
+
+      if(is_empty) {
+        units.emplace_back(root_offset, pos - begin - root_offset, pos - begin - root_offset);
+        closed_root = true;
+        continue;
+      }
+
+      open.emplace_back(name, name_end - name);
+      continue;
+    }
+
+    if(open.size() == 1 && is_unit(name, name_end - name)) {
+
+      if(is_empty) {
+        units.emplace_back(tag - begin, pos - tag, pos - tag);
+        continue;
+      }
+
+      unit_start = tag;
+      unit_start_tag_length = pos - tag;
+    }
+
+    if(!is_empty) open.emplace_back(name, name_end - name);
+
+  }
+
+  if(!closed_root) throw srcml_unit_locator_error(have_root ? "Document ends inside an element" : "No root element");
+
+}
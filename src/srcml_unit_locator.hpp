@@ -0,0 +1,92 @@
+/*
+  srcml_unit_locator.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_UNIT_LOCATOR_HPP
+#define INCLUDED_SRCML_UNIT_LOCATOR_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+class srcml_unit_locator_error;
+
+/**
+ * srcml_unit_locator
+ *
+ * Finds the byte range of every unit in an in-memory srcML document
+ * without parsing it.  Only markup is examined: srcML escapes '<' in
+ * text, so every '<' starts a tag, comment, processing instruction or
+ * CDATA section.  For an archive the units are the children of the
+ * root unit; for a solitary unit the root itself is the only unit.
+ * Malformed markup throws a srcml_unit_locator_error.
+ */
+class srcml_unit_locator {
+
+public:
+
+  class srcml_unit_range {
+
+  public:
+
+    std::size_t offset;
+    std::size_t length;
+    std::size_t start_tag_length;
+
+    srcml_unit_range(std::size_t offset = 0, std::size_t length = 0, std::size_t start_tag_length = 0)
+      : offset(offset), length(length), start_tag_length(start_tag_length) {}
+
+  };
+
+private:
+
+  const char * data;
+  std::size_t size;
+
+  std::string root_name;
+  std::size_t root_offset;
+  std::size_t root_start_tag_end;
+  bool archive;
+  std::vector<srcml_unit_range> units;
+
+  void locate();
+
+public:
+
+  srcml_unit_locator(const char * data, std::size_t size);
+
+  /** true if the root unit contains units, i.e., this is an archive */
+  bool is_archive() const { return archive; }
+
+  /** qualified name of the root element */
+  const std::string & get_root_name() const { return root_name; }
+
+  /** bytes from the start of the document to the end of the root start tag */
+  std::size_t get_prolog_size() const { return root_start_tag_end; }
+
+  const std::vector<srcml_unit_range> & get_units() const { return units; }
+
+  std::string get_root_end_tag() const;
+
+};
+
+#endif
@@ -33,6 +33,8 @@ public:
 
 };
 
+static const srcml_symbol UNIT_SYMBOL("unit");
+
 void srcml_writer::cleanup() {
   if(archive) {
     srcml_archive_close(archive);
@@ -62,7 +64,7 @@ void srcml_writer::check_srcml_error(int error_code, bool perform_cleanup, const
 
 
 srcml_writer::srcml_writer(const std::string & filename)
-  : archive(nullptr), unit(nullptr), saved_characters(), in_unit(true), started(false) {
+  : archive(nullptr), unit(nullptr), pending_text(), in_unit(true), state(BEFORE_ROOT), stats() {
 
     archive = srcml_archive_create();
     if(!archive) throw srcml_writer_error("Failure creating srcML Archive");
@@ -74,42 +76,53 @@ srcml_writer::~srcml_writer() {
   cleanup();
 }
 
+/**
+ * write
+ * @param node the next node of the document
+ *
+ * Dispatch on the node type and, for start tags and text, on the state
+ * of the writer.
+ */
 bool srcml_writer::write(const srcml_node & node) {
-  return write_process_map[node.type](node);
-}
 
-// typename std::unordered_map<std::string, std::function<int (srcml_archive *, const char *)::const_iterator archive_attr_map_citr;
-// std::unordered_map<std::string, std::function<int (srcml_archive *, const char *)>> archive_attr_map = {
+  SRCML_STATS(srcml_stats::srcml_scoped_timer timer(stats, srcml_stats::WRITE));
+  SRCML_STATS(stats.count_event(node.type));
 
-//     { "url", srcml_archive_set_url },
-// };
+  switch(node.type) {
 
-void srcml_writer::set_unit_attr(srcml_unit * unit, const srcml_node::srcml_attribute_map & attributes) {
+    case srcml_node::srcml_node_type::START:
+      if(state == WRITING) return write_start(node);
+      return state == BEFORE_ROOT ? setup_archive(node) : write_start_first(node);
 
-  static std::function<int (srcml_unit *, const char *)> no_op = [](srcml_unit * unit, const char * str) { return SRCML_STATUS_OK; };
-  typedef std::unordered_map<std::string, std::function<int (srcml_unit *, const char *)>>::const_iterator unit_attr_map_citr;
-  static std::unordered_map<std::string, std::function<int (srcml_unit *, const char *)>> unit_attr_map = {
-    { "language", srcml_unit_set_language },
-    { "filename", srcml_unit_set_filename },
-    { "hash"    , no_op },
-    { "revision", no_op },
-    { "author", no_op },
-    { "modifier", no_op },
-  };
+    case srcml_node::srcml_node_type::END:
+      return write_end(node);
 
-  for(const srcml_node::srcml_attribute_map_pair & attr : attributes) {
+    case srcml_node::srcml_node_type::TEXT:
+      return state == WRITING ? write_text(node) : write_text_first(node);
 
-    unit_attr_map_citr citr = unit_attr_map.find(attr.first);
-    if(citr != unit_attr_map.end()) {
-      check_srcml_error(unit_attr_map[attr.first](unit, attr.second.value ? attr.second.value->c_str() : 0), false, "Error setting archive", attr.first.c_str());
-    } else {
-      throw srcml_writer_error("Unimplemented attribute: " + attr.first);
-    }
+    default:
+      return write_error(node);
 
   }
 
 }
 
+/**
+ * get_stats
+ *
+ * Counters for what has been written so far, all zero unless srcReader
+ * is built with SRCREADER_STATS.
+ */
+const srcml_stats & srcml_writer::get_stats() const {
+  return stats;
+}
+
+// typename std::unordered_map<std::string, std::function<int (srcml_archive *, const char *)::const_iterator archive_attr_map_citr;
+// std::unordered_map<std::string, std::function<int (srcml_archive *, const char *)>> archive_attr_map = {
+
+//     { "url", srcml_archive_set_url },
+// };
+
 bool srcml_writer::setup_archive(const srcml_node & node) {
   unit = srcml_unit_create(archive);
   if(!unit) throw srcml_writer_error("Failure creating srcML Unit");
@@ -120,30 +133,71 @@ bool srcml_writer::setup_archive(const srcml_node & node) {
                       false, "Error error registering namespace: ", ns->uri.c_str());
   }
 
-  set_unit_attr(unit, node.attributes);
+  srcml_unit_builder::set_unit_attributes(unit, node.attributes);
 
-  write_process_map[srcml_node::srcml_node_type::START] = std::bind(&srcml_writer::write_start_first, this, std::placeholders::_1);
+  state = BEFORE_FIRST_START;
 
   return true;
 }
 
+/**
+ * create_unit_builder
+ *
+ * A builder for a unit of this archive, which may be used on another
+ * thread.  Safe to call from several threads.
+ */
+std::unique_ptr<srcml_unit_builder> srcml_writer::create_unit_builder() {
+
+  std::lock_guard<std::mutex> lock(archive_mutex);
+  return std::unique_ptr<srcml_unit_builder>(new srcml_unit_builder(srcml_unit_create(archive)));
+
+}
+
+/**
+ * write_unit
+ * @param builder a complete unit
+ *
+ * Append a unit built by a srcml_unit_builder to the archive, as if its
+ * nodes had been written here.  The root of the archive must already be
+ * written, and no unit may be partly written through write().  Safe to
+ * call while other threads build units, but not from several threads
+ * at once; srcml_unit_committer orders the calls.
+ */
+void srcml_writer::write_unit(const srcml_unit_builder & builder) {
+
+  if(!builder.is_complete()) throw srcml_writer_error("Unit is not complete");
+  if(!unit) throw srcml_writer_error("Archive root has not been written");
+  if(state == WRITING && in_unit) throw srcml_writer_error("A unit is being written");
+
+  // the first unit makes this an archive, as in write_start_first()
+  if(state != WRITING) {
+    state = WRITING;
+    check_srcml_error(srcml_archive_disable_solitary_unit(archive), false, "Error enabling archive");
+  }
+  in_unit = false;
+
+  SRCML_STATS(srcml_stats::srcml_scoped_timer timer(stats, srcml_stats::WRITE));
+
+  std::lock_guard<std::mutex> lock(archive_mutex);
+  check_srcml_error(srcml_archive_write_unit(archive, builder.unit), false, "Error writing unit");
+  SRCML_STATS(++stats.units);
+
+}
+
 bool srcml_writer::write_start_first(const srcml_node & node) {
 
-  /// @todo figure how to check a bound function pointer
-  started = true;
-  write_process_map[srcml_node::srcml_node_type::START] = std::bind(&srcml_writer::write_start, this, std::placeholders::_1);
-  write_process_map[srcml_node::srcml_node_type::TEXT] = std::bind(&srcml_writer::write_text, this, std::placeholders::_1);
+  state = WRITING;
 
-  if(node.name != "unit") {
+  // text before the first start tag is only written inside a solitary unit
+  if(node.name != UNIT_SYMBOL) {
     check_srcml_error(srcml_write_start_unit(unit), false, "Error starting unit");
-    write_process_map[srcml_node::srcml_node_type::TEXT](srcml_node(saved_characters));
+    if(!in_unit) pending_text.clear();
   } else {
+    pending_text.clear();
     check_srcml_error(srcml_archive_disable_solitary_unit(archive), false, "Error enabling archive");
   }
 
-  write_process_map[srcml_node::srcml_node_type::START](node);
-
-  return true;
+  return write_start(node);
 
 }
 /**
@@ -152,54 +206,42 @@ bool srcml_writer::write_start_first(const srcml_node & node) {
  */
 bool srcml_writer::write_start(const srcml_node & node) {
 
-  if(node.name != "unit") {
-    check_srcml_error(srcml_write_start_element(unit, node.ns->prefix ? node.ns->prefix->c_str() : 0, node.name.c_str(), node.ns->uri.c_str()),
-                      false, "Error writing start tag");
-
-    for(const std::shared_ptr<srcml_node::srcml_namespace> ns : node.ns_definition) {
-      check_srcml_error(srcml_write_namespace(unit, ns->prefix ? ns->prefix->c_str() : 0, ns->uri.c_str()), "Error writing namespace", ns->uri.c_str());
-    }
-
-    for(const srcml_node::srcml_attribute_map_pair & attr : node.attributes) {
-
-      /** @TODO FIX as this is temporary fix for srcml writing out namespace */
-
-      check_srcml_error(srcml_write_attribute(unit, 0,
-                                                    attr.second.full_name().c_str(),
-                                                    0,
-      // check_srcml_error(srcml_write_attribute(unit, attr.second.ns->prefix ? attr.second.ns->prefix->c_str() : 0,
-      //                                               attr.first.c_str(),
-      //                                               attr.second.ns->uri.c_str(),
-                                                    attr.second.value ? attr.second.value->c_str() : 0),
-                        "Error writing attribute", attr.first.c_str());
-    }
+  srcml_unit_builder::write_pending_text(unit, pending_text);
 
+  if(node.name != UNIT_SYMBOL) {
+    srcml_unit_builder::write_start_element(unit, node);
   } else {
     in_unit = true;
     check_srcml_error(srcml_write_start_unit(unit), false, "Error starting unit");
-    set_unit_attr(unit, node.attributes);
+    srcml_unit_builder::set_unit_attributes(unit, node.attributes);
   }
 
-  if(node.is_empty()) write_process_map[srcml_node::srcml_node_type::END](node);
+  if(node.is_empty()) write_end(node);
   return true;
 }
 
 bool srcml_writer::write_end(const srcml_node & node) {
 
-  if(node.name != "unit") {
-    check_srcml_error(srcml_write_end_element(unit), false, "Error writing end tag");
+  if(node.name != UNIT_SYMBOL) {
+    srcml_unit_builder::write_pending_text(unit, pending_text);
+    srcml_unit_builder::write_end_element(unit);
     return true;
   }
 
   if(!in_unit) return true;
 
-  if(!started) {
+  // a solitary unit with no elements in it was never started, and its text is not written
+  if(state != WRITING) {
+    pending_text.clear();
     check_srcml_error(srcml_write_start_unit(unit), false, "Error starting unit");
-    started = true;
   }
+  srcml_unit_builder::write_pending_text(unit, pending_text);
 
   check_srcml_error(srcml_write_end_unit(unit), false, "Error ending unit");
+
+  std::lock_guard<std::mutex> lock(archive_mutex);
   check_srcml_error(srcml_archive_write_unit(archive, unit), false, "Error writing unit");
+  SRCML_STATS(++stats.units);
   srcml_unit_free(unit);
   in_unit = false;
 
@@ -213,26 +255,34 @@ bool srcml_writer::write_text_first(const srcml_node & node) {
 
   if(!node.content) return true;
 
-  saved_characters += *node.content;
+  SRCML_STATS(stats.bytes += node.content.size());
+  SRCML_STATS(stats.bytes_copied += node.content.size());
+  pending_text.append(node.content.data(), node.content.size());
   return true;
 
 }
 
+/**
+ * write_text
+ *
+ * Adjacent text is collected and written by the next tag, with
+ * srcml_unit_builder::write_pending_text().
+ */
 bool srcml_writer::write_text(const srcml_node & node) {
   if(!node.content) return true;
   if(!in_unit) return true;
 
+  SRCML_STATS(stats.bytes += node.content.size());
 
   if(node.attributes.size()) {
     write_start(node);
-  }
-
-  check_srcml_error(srcml_write_string(unit, node.content->c_str()), false, "Error writing text");
-
-  if(node.attributes.size()) {
+    srcml_unit_builder::write_string(unit, node);
     write_end(node);
+    return true;
   }
 
+  pending_text.append(node.content.data(), node.content.size());
+
   return true;
 }
 
@@ -25,19 +25,30 @@
 #define INCLUDED_SRCML_WRITER_HPP
 
 #include <srcml_node.hpp>
+#include <srcml_stats.hpp>
+#include <srcml_unit_builder.hpp>
 
 #include <srcml.h>
 
 #include <string>
 #include <stdexcept>
-#include <unordered_map>
-#include <functional>
+#include <memory>
+#include <mutex>
 
 class srcml_writer_error;
 
 class srcml_writer {
 
 private:
+
+    /**
+     * Where the writer is in the document, which decides how a start
+     * tag or text is written: before the root, between the root and
+     * its first child, whose name tells if the document is an archive,
+     * or past that.
+     */
+    enum srcml_writer_state : unsigned int { BEFORE_ROOT = 0, BEFORE_FIRST_START = 1, WRITING = 2 };
+
     bool setup_archive(const srcml_node & node);
     bool write_start_first(const srcml_node & node);
     bool write_start(const srcml_node & node);
@@ -46,30 +57,33 @@ private:
     bool write_text(const srcml_node & node);
     bool write_error(const srcml_node & node);
 
-    std::unordered_map<int, std::function<bool (const srcml_node & node)>> write_process_map = { 
-        { srcml_node::srcml_node_type::START, std::bind(&srcml_writer::setup_archive, this, std::placeholders::_1) },
-        { srcml_node::srcml_node_type::END, std::bind(&srcml_writer::write_end, this, std::placeholders::_1) },
-        { srcml_node::srcml_node_type::TEXT, std::bind(&srcml_writer::write_text_first, this, std::placeholders::_1) },
-        { srcml_node::srcml_node_type::OTHER, std::bind(&srcml_writer::write_error, this, std::placeholders::_1) },
-    };
-
     void cleanup();
 
     template<class... message_type>
     void check_srcml_error(int error_code, bool perform_cleanup, const message_type &... message);
-    void set_unit_attr(srcml_unit * unit, const srcml_node::srcml_attribute_map & attributes);
 
     srcml_archive * archive;
     srcml_unit * unit;
-    std::string saved_characters;
+    /** adjacent text, written as one string when the next tag arrives */
+    std::string pending_text;
     bool in_unit;
-    bool started;
+    srcml_writer_state state;
+
+    srcml_stats stats;
+
+    /** guards the archive while units are built on other threads */
+    std::mutex archive_mutex;
 
 public:
     srcml_writer(const std::string & filename);
     ~srcml_writer();
     bool write(const srcml_node & node);
 
+    const srcml_stats & get_stats() const;
+
+    std::unique_ptr<srcml_unit_builder> create_unit_builder();
+    void write_unit(const srcml_unit_builder & builder);
+
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,82 @@
+/*
+  srcml_xml_util.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCML_XML_UTIL_HPP
+#define INCLUDED_SRCML_XML_UTIL_HPP
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * srcml_xml_util
+ *
+ * Byte-level helpers for the parts of srcReader that read XML text
+ * directly rather than through libxml2: the tokenizer, the unit locator
+ * and index, and the decoding of attribute values.
+ */
+class srcml_xml_util {
+
+public:
+
+  /** XML whitespace */
+  static bool is_space(char ch) {
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+  }
+
+  /** append a character reference's code point as UTF-8 */
+  static void append_utf8(std::string & str, unsigned long code_point) {
+
+    if(code_point < 0x80) {
+      str += char(code_point);
+    } else if(code_point < 0x800) {
+      str += char(0xC0 | (code_point >> 6));
+      str += char(0x80 | (code_point & 0x3F));
+    } else if(code_point < 0x10000) {
+      str += char(0xE0 | (code_point >> 12));
+      str += char(0x80 | ((code_point >> 6) & 0x3F));
+      str += char(0x80 | (code_point & 0x3F));
+    } else {
+      str += char(0xF0 | (code_point >> 18));
+      str += char(0x80 | ((code_point >> 12) & 0x3F));
+      str += char(0x80 | ((code_point >> 6) & 0x3F));
+      str += char(0x80 | (code_point & 0x3F));
+    }
+
+  }
+
+  /** 64-bit FNV-1a */
+  static std::uint64_t checksum(const char * data, std::size_t size) {
+
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    for(std::size_t i = 0; i < size; ++i) {
+      hash ^= (unsigned char)data[i];
+      hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+  }
+
+};
+
+#endif
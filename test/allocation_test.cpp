@@ -0,0 +1,117 @@
+/*
+  allocation_test.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_test.hpp>
+#include <allocation_counter.hpp>
+
+#include <srcml_reader.hpp>
+
+#include <string>
+
+/** the archive fixture with its units repeated, so most of its events are seen before */
+static std::string repeated_archive(const std::string & fixtures, int copies) {
+
+  std::string archive = srcreader_test::read_file(fixtures + "/archive.xml");
+  std::string::size_type first = archive.find("<unit", archive.find("<unit") + 1);
+  std::string::size_type last = archive.rfind("</unit>");
+  std::string units = archive.substr(first, last - first);
+
+  std::string repeated = archive.substr(0, first);
+  for(int copy = 0; copy < copies; ++copy)
+    repeated += units;
+  repeated += archive.substr(last);
+
+  return repeated;
+}
+
+/** allocations made advancing through all but the first copy of the units, counting the events advanced to */
+static std::size_t steady_allocations(const std::string & archive, int copies, srcml_reader::srcml_backend backend, std::size_t & events) {
+
+  static const int UNITS = 4;
+
+  srcml_reader reader(archive.data(), archive.size(), backend);
+  srcml_reader::srcml_reader_iterator itr = reader.begin();
+
+  int units = 0;
+  while(units < UNITS) {
+    ++itr;
+    SRCREADER_CHECK(itr != reader.end());
+    if(itr->is_end() && itr->full_name() == "unit") ++units;
+  }
+
+  std::size_t starts = 0;
+  std::size_t ends = 0;
+  std::size_t texts = 0;
+  std::size_t allocations = 0;
+  events = 0;
+  while(units < copies * UNITS) {
+
+    std::size_t before = allocation_count.load(std::memory_order_relaxed);
+    ++itr;
+    allocations += allocation_count.load(std::memory_order_relaxed) - before;
+    SRCREADER_CHECK(itr != reader.end());
+    ++events;
+
+    if(itr->is_start()) {
+      ++starts;
+    } else if(itr->is_end()) {
+      ++ends;
+      if(itr->full_name() == "unit") ++units;
+    } else if(itr->is_text()) {
+      ++texts;
+    }
+
+  }
+
+  SRCREADER_CHECK(starts > 1000);
+  SRCREADER_CHECK(ends > 1000);
+  SRCREADER_CHECK(texts > 1000);
+
+  return allocations;
+}
+
+/**
+ * Once the reader has seen a document's names, namespaces and attribute
+ * counts, advancing to a start tag, end tag or text run reuses the
+ * storage from earlier events.  The first copy of the units is warm-up.
+ * The archive's own end tag is left out: it carries the root's namespace
+ * definitions and may grow their storage once per document.
+ *
+ * The text reader makes no allocation at all over the remaining copies.
+ * The push parser and the tokenizer hand out events from a queue of
+ * nodes that rotate as the queue is refilled, so each queued node grows
+ * once to the largest attributes and text it is given.  Those few
+ * allocations die out as the copies go on; over 50 copies they stay
+ * below one per 50 events.
+ */
+SRCREADER_TEST(allocation) {
+
+  static const int COPIES = 50;
+  std::string archive = repeated_archive(fixtures, COPIES);
+
+  std::size_t events = 0;
+  SRCREADER_CHECK_EQUAL(steady_allocations(archive, COPIES, srcml_reader::srcml_backend::TEXT_READER, events), std::size_t(0));
+  SRCREADER_CHECK(steady_allocations(archive, COPIES, srcml_reader::srcml_backend::PUSH_PARSER, events) * 50 < events);
+  SRCREADER_CHECK(steady_allocations(archive, COPIES, srcml_reader::srcml_backend::TOKENIZER, events) * 50 < events);
+
+}
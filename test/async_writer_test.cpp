@@ -0,0 +1,129 @@
+/*
+  async_writer_test.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_test.hpp>
+
+#include <srcml_reader.hpp>
+#include <srcml_writer.hpp>
+#include <srcml_async_writer.hpp>
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cstdio>
+
+/** the nodes of a document, copied out of the reader */
+static std::vector<srcml_node> read_nodes(const std::string & document) {
+
+  std::vector<srcml_node> nodes;
+  srcml_reader reader(document.data(), document.size());
+  for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end();) {
+    nodes.push_back(itr++);
+  }
+
+  return nodes;
+}
+
+/** what srcml_writer writes for nodes, or the message of the error it throws */
+static std::string write_sync(const std::vector<srcml_node> & nodes) {
+
+  std::string error;
+  try {
+    srcml_writer writer("async_writer_test.xml");
+    for(const srcml_node & node : nodes) {
+      writer.write(node);
+    }
+  } catch(const std::runtime_error & writer_error) {
+    error = writer_error.what();
+  }
+
+  std::string xml = srcreader_test::read_file("async_writer_test.xml");
+  std::remove("async_writer_test.xml");
+
+  return error.empty() ? xml : error;
+}
+
+/** what srcml_async_writer writes for nodes, or the message of the error write() or flush() rethrows */
+static std::string write_async(const std::vector<srcml_node> & nodes, std::size_t batch_size, std::size_t batches) {
+
+  std::string error;
+  try {
+    srcml_async_writer writer("async_writer_test.xml", batch_size, batches);
+    for(const srcml_node & node : nodes) {
+      writer.write(node);
+    }
+    writer.flush();
+  } catch(const std::runtime_error & writer_error) {
+    error = writer_error.what();
+  }
+
+  std::string xml = srcreader_test::read_file("async_writer_test.xml");
+  std::remove("async_writer_test.xml");
+
+  return error.empty() ? xml : error + '\n' + xml;
+}
+
+/**
+ * srcml_async_writer writes the same bytes as srcml_writer, with one
+ * node per batch, with batches that do not divide the document, and
+ * with the default batches.  A node the writer rejects in the middle of
+ * an archive is rethrown by write() or flush(), and the units after it
+ * are not written.  The fixtures are used without pos:tabs, and files
+ * are written to the working directory.
+ */
+SRCREADER_TEST(async_writer) {
+
+  for(const char * fixture : { "/text.xml", "/archive.xml", "/position.xml" }) {
+
+    const std::vector<srcml_node> nodes = read_nodes(srcreader_test::without_tabs(srcreader_test::read_file(fixtures + fixture)));
+    const std::string expected = write_sync(nodes);
+    SRCREADER_CHECK(expected.find("</unit>") != std::string::npos);
+
+    std::size_t non_divisor = 2;
+    while(nodes.size() % non_divisor == 0) ++non_divisor;
+
+    SRCREADER_CHECK_EQUAL(write_async(nodes, 1, 2), expected);
+    SRCREADER_CHECK_EQUAL(write_async(nodes, non_divisor, 2), expected);
+    SRCREADER_CHECK_EQUAL(write_async(nodes, srcml_async_writer::DEFAULT_BATCH_SIZE, srcml_async_writer::DEFAULT_BATCHES), expected);
+
+  }
+
+  // a node of no type after the first unit of the archive
+  std::vector<srcml_node> nodes = read_nodes(srcreader_test::without_tabs(srcreader_test::read_file(fixtures + "/archive.xml")));
+  std::size_t first_unit_end = 0;
+  while(!(nodes[first_unit_end].is_end() && nodes[first_unit_end].full_name() == "unit")) ++first_unit_end;
+  nodes.insert(nodes.begin() + first_unit_end + 1, srcml_node());
+
+  const std::string error = write_sync(nodes);
+  SRCREADER_CHECK(error.find("</unit>") == std::string::npos);
+
+  for(std::size_t batch_size : { std::size_t(1), std::size_t(3), srcml_async_writer::DEFAULT_BATCH_SIZE }) {
+
+    const std::string written = write_async(nodes, batch_size, 2);
+    SRCREADER_CHECK_EQUAL(written.substr(0, error.size() + 1), error + '\n');
+    SRCREADER_CHECK(written.find("point.hpp") != std::string::npos);
+    SRCREADER_CHECK(written.find("main.cpp") == std::string::npos);
+
+  }
+
+}
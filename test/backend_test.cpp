@@ -0,0 +1,92 @@
+/*
+  backend_test.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_test.hpp>
+
+#include <srcml_reader.hpp>
+
+#include <string>
+#include <vector>
+
+/** how a document is read */
+enum read_mode { FULL, SKIP, FILTER };
+
+/**
+ * events
+ *
+ * The events of a document read with a backend.  SKIP passes over the
+ * rest of every declaration and macro definition with skip(); FILTER
+ * only returns names and skips comments with an element filter.
+ */
+static std::vector<std::string> events(const std::string & filename, srcml_reader::srcml_backend backend, read_mode mode) {
+
+  srcml_reader reader(filename, backend);
+  if(mode == FILTER) reader.set_element_filter({ "name" }, { "comment" });
+
+  std::vector<std::string> described;
+  for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+
+    if(mode == SKIP && itr->is_start() && (itr->full_name() == "decl" || itr->full_name() == "cpp:define")) {
+      described.push_back("skip " + srcreader_test::describe(*itr, reader.get_element_path().depth()));
+      reader.skip();
+    }
+
+    described.push_back(srcreader_test::describe(*itr, reader.get_element_path().depth()));
+
+  }
+
+  return described;
+}
+
+/** fail on the first event where a backend differs from the text reader */
+static void check_same_events(const std::string & filename, srcml_reader::srcml_backend backend) {
+
+  for(read_mode mode : { FULL, SKIP, FILTER }) {
+
+    std::vector<std::string> expected = events(filename, srcml_reader::srcml_backend::TEXT_READER, mode);
+    std::vector<std::string> actual = events(filename, backend, mode);
+
+    SRCREADER_CHECK_EVENTS(actual, expected, filename + " mode " + std::to_string(mode));
+
+  }
+
+}
+
+/**
+ * The push parser and the tokenizer deliver the same events as the text
+ * reader: every field of every node, and the element stack, whether
+ * reading all of a document, skipping subtrees or filtering elements.
+ * The fixtures cover comments, processing instructions, CDATA, a
+ * DOCTYPE, character and entity references, CRLF line ends, ISO-8859-1,
+ * prefixed and empty elements, an archive and a unit with positions.
+ * Only the markup and ISO-8859-1 fixtures make the tokenizer fall back
+ * to libxml2; the srcML ones are read by the tokenizer alone.
+ */
+SRCREADER_TEST(backend) {
+
+  for(const char * fixture : { "/text.xml", "/markup.xml", "/latin1.xml", "/archive.xml", "/position.xml" }) {
+    check_same_events(fixtures + fixture, srcml_reader::srcml_backend::PUSH_PARSER);
+    check_same_events(fixtures + fixture, srcml_reader::srcml_backend::TOKENIZER);
+  }
+
+}
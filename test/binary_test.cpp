@@ -0,0 +1,162 @@
+/*
+  binary_test.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_test.hpp>
+
+#include <srcml_reader.hpp>
+#include <srcml_writer.hpp>
+#include <srcml_binary_reader.hpp>
+#include <srcml_binary_writer.hpp>
+#include <srcml_binary_format.hpp>
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cstdio>
+
+/** the described events of a document read as XML */
+static std::vector<std::string> xml_events(const std::string & document, bool split_text) {
+
+  srcml_reader reader(document.data(), document.size());
+  reader.set_split_text(split_text);
+
+  std::vector<std::string> described;
+  for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+    described.push_back(srcreader_test::describe(*itr, reader.get_element_path().depth()));
+  }
+
+  return described;
+}
+
+/**
+ * to_binary
+ *
+ * A document converted to the binary format.  Split text is written as
+ * SPLIT_TEXT records, whole text nodes as plain ones, and end nodes as
+ * MATCHES_START records.
+ */
+static std::string to_binary(const std::string & document, bool split_text) {
+
+  {
+    srcml_reader reader(document.data(), document.size());
+    reader.set_split_text(split_text);
+    srcml_binary_writer writer("binary_test.bin");
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+      writer.write(*itr);
+    }
+  }
+
+  std::string binary = srcreader_test::read_file("binary_test.bin");
+  std::remove("binary_test.bin");
+
+  return binary;
+}
+
+/** the described events of a document in the binary format */
+static std::vector<std::string> binary_events(const std::string & binary) {
+
+  srcml_binary_reader reader(binary.data(), binary.size());
+
+  std::vector<std::string> described;
+  for(srcml_binary_reader::srcml_binary_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+    described.push_back(srcreader_test::describe(*itr, reader.get_element_path().depth()));
+  }
+
+  return described;
+}
+
+/** the XML srcml_writer writes for the events of a reader */
+template<class reader_type>
+static std::string write_xml(reader_type & reader) {
+
+  {
+    srcml_writer writer("binary_test.xml");
+    for(const srcml_node & node : reader) {
+      writer.write(node);
+    }
+  }
+
+  std::string xml = srcreader_test::read_file("binary_test.xml");
+  std::remove("binary_test.xml");
+
+  return xml;
+}
+
+/** true if reading all of a binary document throws */
+static bool read_throws(const std::string & binary) {
+
+  try {
+    binary_events(binary);
+  } catch(const std::runtime_error &) {
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * Converting a document to the binary format and reading it back gives
+ * the events of reading the XML, with and without split text, and
+ * srcml_writer writes the same XML for them.  Cutting the binary
+ * document anywhere after its header, or corrupting it, throws.  The
+ * fixtures are used without pos:tabs, and files are written to the
+ * working directory.
+ */
+SRCREADER_TEST(binary) {
+
+  for(const char * fixture : { "/text.xml", "/archive.xml", "/position.xml" }) {
+
+    const std::string document = srcreader_test::without_tabs(srcreader_test::read_file(fixtures + fixture));
+
+    for(bool split_text : { true, false }) {
+
+      const std::string binary = to_binary(document, split_text);
+      SRCREADER_CHECK_EVENTS(binary_events(binary), xml_events(document, split_text),
+                             fixture + std::string(split_text ? " split" : " whole"));
+
+      srcml_reader reader(document.data(), document.size());
+      reader.set_split_text(split_text);
+      srcml_binary_reader binary_reader(binary.data(), binary.size());
+      SRCREADER_CHECK_EQUAL(write_xml(binary_reader), write_xml(reader));
+
+    }
+
+  }
+
+  const std::string binary = to_binary(srcreader_test::read_file(fixtures + "/text.xml"), true);
+  const std::size_t header_size = srcml_binary_format::MAGIC_SIZE + 1;
+  for(std::size_t size = 0; size < binary.size(); ++size) {
+    if(size == header_size) continue;
+    SRCREADER_CHECK(read_throws(binary.substr(0, size)));
+  }
+
+  std::string bad_magic = binary;
+  bad_magic[0] = 'X';
+  SRCREADER_CHECK(read_throws(bad_magic));
+
+  // a record of a kind that does not exist
+  std::string bad_kind = binary;
+  bad_kind[header_size] = srcml_binary_format::KIND_MASK;
+  SRCREADER_CHECK(read_throws(bad_kind));
+
+}
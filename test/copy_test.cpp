@@ -0,0 +1,106 @@
+/*
+  copy_test.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_test.hpp>
+
+#include <srcml_reader.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * counted_data
+ *
+ * user_data payload that counts how often it is copied.
+ */
+class counted_data {
+
+public:
+
+  static std::size_t copies;
+
+  counted_data() {}
+  counted_data(const counted_data &) { ++copies; }
+  counted_data(counted_data &&) noexcept {}
+  counted_data & operator=(const counted_data &) { ++copies; return *this; }
+  counted_data & operator=(counted_data &&) noexcept { return *this; }
+
+};
+
+std::size_t counted_data::copies = 0;
+
+/**
+ * Reading, collecting nodes with the postfix iterator and moving them
+ * into a container make no copies of a node's payload.  Only an
+ * explicit copy does.
+ */
+static void check_copies(const std::string & filename, srcml_reader::srcml_backend backend) {
+
+  std::size_t events = 0;
+
+  srcml_reader scan(filename, backend);
+  for(srcml_reader::srcml_reader_iterator itr = scan.begin(); itr != scan.end(); ++events) {
+
+    itr->user_data = counted_data();
+
+    std::size_t before = counted_data::copies;
+    ++itr;
+    SRCREADER_CHECK_EQUAL(counted_data::copies - before, std::size_t(0));
+
+  }
+
+  SRCREADER_CHECK(events > 100);
+
+  std::vector<srcml_node> collected;
+  srcml_reader reader(filename, backend);
+  for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end();) {
+
+    itr->user_data = counted_data();
+
+    std::size_t before = counted_data::copies;
+    srcml_node node = itr++;
+    SRCREADER_CHECK_EQUAL(counted_data::copies - before, std::size_t(0));
+    SRCREADER_CHECK(!node.user_data.empty());
+
+    collected.push_back(std::move(node));
+    SRCREADER_CHECK_EQUAL(counted_data::copies - before, std::size_t(0));
+
+  }
+
+  SRCREADER_CHECK_EQUAL(collected.size(), events);
+
+  std::size_t before = counted_data::copies;
+  srcml_node copy = collected.back();
+  SRCREADER_CHECK_EQUAL(counted_data::copies - before, std::size_t(1));
+  SRCREADER_CHECK(!copy.user_data.empty());
+
+}
+
+SRCREADER_TEST(copy) {
+
+  check_copies(fixtures + "/archive.xml", srcml_reader::srcml_backend::TEXT_READER);
+  check_copies(fixtures + "/archive.xml", srcml_reader::srcml_backend::PUSH_PARSER);
+  check_copies(fixtures + "/archive.xml", srcml_reader::srcml_backend::TOKENIZER);
+
+}
@@ -0,0 +1,115 @@
+/*
+  namespace_test.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_test.hpp>
+
+#include <srcml_reader.hpp>
+
+#include <string>
+#include <cstring>
+
+/**
+ * Sibling elements each declare the prefix "a" for a different URI.
+ * libxml2 frees an element's namespace declarations with the element,
+ * so later siblings get reused xmlNs memory, and a namespace cached by
+ * pointer must not outlive its element.  Both empty elements and
+ * elements with content are read, and with each backend.
+ */
+static void check_namespaces(srcml_reader::srcml_backend backend) {
+
+  static const int ELEMENTS = 2000;
+
+  std::string document = "<unit xmlns=\"http://www.srcML.org/srcML/src\">";
+  for(int element = 0; element < ELEMENTS; ++element) {
+    std::string number = std::to_string(element);
+    document += "<a:name xmlns:a=\"urn:" + number + "\" a:number=\"" + number + "\"";
+    document += element % 2 ? "/>" : ">x</a:name>";
+  }
+  document += "</unit>";
+
+  srcml_reader reader(document.data(), document.size(), backend);
+
+  int starts = 0;
+  int ends = 0;
+  for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+
+    if(!itr->is_start() && !itr->is_end()) continue;
+    if(itr->full_name() == "unit") continue;
+
+    int element = itr->is_start() ? starts++ : ends++;
+    std::string uri = "urn:" + std::to_string(element);
+
+    SRCREADER_CHECK(bool(itr->ns));
+    SRCREADER_CHECK_EQUAL(itr->ns->uri, uri);
+
+    if(itr->is_start()) {
+      SRCREADER_CHECK_EQUAL(itr->ns_definition.size(), std::size_t(1));
+      SRCREADER_CHECK_EQUAL(itr->ns_definition.front()->uri, uri);
+      SRCREADER_CHECK_EQUAL(itr->attributes.size(), std::size_t(1));
+      SRCREADER_CHECK_EQUAL(itr->attributes.begin()->second.ns->uri, uri);
+    }
+
+  }
+
+  SRCREADER_CHECK_EQUAL(starts, ELEMENTS);
+  SRCREADER_CHECK_EQUAL(ends, ELEMENTS);
+
+}
+
+/**
+ * A namespace is cached by its xmlNsPtr alone, so it is only looked up
+ * again once it is forgotten, as the reader does for the declarations
+ * of an element it leaves.
+ */
+static void check_cache() {
+
+  xmlNs ns;
+  std::memset(&ns, 0, sizeof(ns));
+  ns.type = XML_NAMESPACE_DECL;
+  ns.prefix = (const xmlChar *)"a";
+
+  srcml_node::srcml_libxml_cache cache;
+
+  ns.href = (const xmlChar *)"urn:first";
+  SRCREADER_CHECK_EQUAL(cache.get_namespace(&ns)->uri, "urn:first");
+
+  ns.href = (const xmlChar *)"urn:second";
+  SRCREADER_CHECK_EQUAL(cache.get_namespace(&ns)->uri, "urn:first");
+
+  cache.forget_namespaces(&ns);
+  SRCREADER_CHECK_EQUAL(cache.get_namespace(&ns)->uri, "urn:second");
+
+}
+
+SRCREADER_TEST(namespace) {
+
+  // the documents are built here
+  (void)fixtures;
+
+  check_cache();
+
+  check_namespaces(srcml_reader::srcml_backend::TEXT_READER);
+  check_namespaces(srcml_reader::srcml_backend::PUSH_PARSER);
+  check_namespaces(srcml_reader::srcml_backend::TOKENIZER);
+
+}
@@ -0,0 +1,120 @@
+/*
+  pass_through_test.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_test.hpp>
+
+#include <srcml_reader.hpp>
+#include <srcml_pass_through_writer.hpp>
+
+#include <string>
+#include <cstdio>
+
+/** how a document is changed while it is written back */
+enum edit_mode { NONE, CONTENT, ATTRIBUTE, EVERY_NODE };
+
+/**
+ * pass_through
+ *
+ * Write a document back, changing nodes in place through the iterator
+ * as asked.  Nodes are looked at and written through a const iterator,
+ * except with EVERY_NODE, which takes each one through the iterator as
+ * if to change it.
+ */
+static std::string pass_through(const std::string & document, srcml_reader::srcml_backend backend, edit_mode edit) {
+
+  {
+    srcml_reader reader(document.data(), document.size(), backend);
+    reader.track_units();
+    srcml_pass_through_writer writer("pass_through_test.xml", reader);
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+
+      const srcml_reader::srcml_reader_iterator & node = itr;
+      if((edit == CONTENT || edit == EVERY_NODE) && node->content.view() == "int") itr->content = std::string("long");
+
+      const std::string * filename = node->get_attribute_value("filename");
+      if(edit == ATTRIBUTE && filename && *filename == "main.cpp") *(*itr).get_attribute_value("filename") = "main.cc";
+
+      if(edit == EVERY_NODE) {
+        writer.write(*itr);
+      } else {
+        writer.write(itr);
+      }
+    }
+  }
+
+  std::string written = srcreader_test::read_file("pass_through_test.xml");
+  std::remove("pass_through_test.xml");
+
+  return written;
+}
+
+/** all text of a document, with each text node that is int read as long */
+static std::string text_of(const std::string & document, bool long_for_int) {
+
+  std::string text;
+  srcml_reader reader(document.data(), document.size());
+  for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+    if(!itr->is_text()) continue;
+    text += long_for_int && itr->content.view() == "int" ? std::string("long") : std::string(itr->content.view());
+  }
+
+  return text;
+}
+
+/**
+ * An unchanged document is written back byte for byte.  Nodes changed
+ * through the iterator are written as changed, and units without a
+ * change are still copied from the source.  Taking every node through
+ * the iterator writes every unit node by node, with the same text.  The
+ * output is written to the working directory.
+ */
+SRCREADER_TEST(pass_through) {
+
+  const std::string archive = srcreader_test::read_file(fixtures + "/archive.xml");
+  const std::string first_unit = archive.substr(archive.find("<unit revision"), archive.find("</unit>") + 7 - archive.find("<unit revision"));
+
+  for(srcml_reader::srcml_backend backend : { srcml_reader::srcml_backend::TEXT_READER,
+                                              srcml_reader::srcml_backend::PUSH_PARSER,
+                                              srcml_reader::srcml_backend::TOKENIZER }) {
+
+    SRCREADER_CHECK_EQUAL(pass_through(archive, backend, NONE), archive);
+
+    const std::string edited = pass_through(archive, backend, CONTENT);
+    SRCREADER_CHECK(edited.find("<type><name>long</name></type> <name>main</name>") != std::string::npos);
+    SRCREADER_CHECK(edited.find("<name>int</name>") == std::string::npos);
+    SRCREADER_CHECK(edited.find(first_unit) != std::string::npos);
+    SRCREADER_CHECK_EQUAL(text_of(edited, false), text_of(archive, true));
+
+    const std::string renamed = pass_through(archive, backend, ATTRIBUTE);
+    SRCREADER_CHECK(renamed.find("filename=\"main.cc\"") != std::string::npos);
+    SRCREADER_CHECK(renamed.find("filename=\"main.cpp\"") == std::string::npos);
+    SRCREADER_CHECK(renamed.find(first_unit) != std::string::npos);
+
+    const std::string rewritten = pass_through(archive, backend, EVERY_NODE);
+    SRCREADER_CHECK(rewritten.find("<type><name>long</name></type> <name>main</name>") != std::string::npos);
+    SRCREADER_CHECK(rewritten.find(first_unit) == std::string::npos);
+    SRCREADER_CHECK_EQUAL(text_of(rewritten, false), text_of(archive, true));
+
+  }
+
+}
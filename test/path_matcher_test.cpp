@@ -0,0 +1,175 @@
+/*
+  path_matcher_test.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_test.hpp>
+
+#include <srcml_reader.hpp>
+#include <srcml_path_matcher.hpp>
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+/** the open start tags, outermost first */
+typedef std::vector<srcml_node> element_stack;
+
+/** a query and when it matches, given the open start tags with the new one last */
+struct expected_query {
+  const char * query;
+  std::function<bool (const element_stack & elements)> matches;
+};
+
+static bool named(const srcml_node & node, const char * name) {
+  return node.full_name() == name;
+}
+
+static bool has_value(const srcml_node & node, const char * attribute, const char * value) {
+  const std::string * actual = node.get_attribute_value(attribute);
+  return actual && *actual == value;
+}
+
+/** true if any element enclosing the last one satisfies a condition */
+static bool has_ancestor(const element_stack & elements, std::function<bool (const srcml_node &)> condition) {
+  return std::any_of(elements.begin(), elements.end() - 1, condition);
+}
+
+/** the queries, and the reference each is checked against */
+static const std::vector<expected_query> & expected_queries() {
+
+  static const std::vector<expected_query> queries = {
+
+    { "/unit/unit", [](const element_stack & elements) {
+        return elements.size() == 2 && named(elements[0], "unit") && named(elements[1], "unit"); } },
+
+    { "/unit/unit[@language='C++']", [](const element_stack & elements) {
+        return elements.size() == 2 && named(elements[0], "unit") && named(elements[1], "unit")
+          && has_value(elements[1], "language", "C++"); } },
+
+    { "/unit/*/cpp:include", [](const element_stack & elements) {
+        return elements.size() == 3 && named(elements[0], "unit") && named(elements[2], "cpp:include"); } },
+
+    { "//function//decl_stmt", [](const element_stack & elements) {
+        return named(elements.back(), "decl_stmt")
+          && has_ancestor(elements, [](const srcml_node & node) { return named(node, "function"); }); } },
+
+    { "name", [](const element_stack & elements) {
+        return named(elements.back(), "name"); } },
+
+    { "//decl/type[@ref]", [](const element_stack & elements) {
+        return elements.size() > 1 && named(elements[elements.size() - 2], "decl") && named(elements.back(), "type")
+          && elements.back().get_attribute_value("ref"); } },
+
+    { "//unit[@language!='C++']//name", [](const element_stack & elements) {
+        return named(elements.back(), "name") && has_ancestor(elements, [](const srcml_node & node) {
+          const std::string * language = node.get_attribute_value("language");
+          return named(node, "unit") && language && *language != "C++"; }); } },
+
+    { "//block/*", [](const element_stack & elements) {
+        return elements.size() > 1 && named(elements[elements.size() - 2], "block"); } },
+
+  };
+
+  return queries;
+}
+
+/**
+ * check_matches
+ *
+ * Feed every node of a document to a matcher with all of the queries
+ * and check started() after each start tag, and ended() after each end
+ * tag, against the reference.  Returns how often each query started.
+ */
+static std::vector<std::size_t> check_matches(const std::string & filename) {
+
+  const std::vector<expected_query> & queries = expected_queries();
+
+  srcml_path_matcher matcher;
+  for(const expected_query & query : queries) {
+    matcher.add(query.query);
+  }
+
+  std::vector<std::size_t> counts(queries.size(), 0);
+  element_stack elements;
+  std::vector<std::vector<std::size_t>> started;
+  std::size_t event = 0;
+  srcml_reader reader(filename);
+  for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr, ++event) {
+
+    matcher.process(*itr);
+
+    std::vector<std::size_t> expected_started;
+    std::vector<std::size_t> expected_ended;
+    if(itr->is_start()) {
+
+      elements.push_back(*itr);
+      for(std::size_t query = 0; query < queries.size(); ++query) {
+        if(!queries[query].matches(elements)) continue;
+        expected_started.push_back(query);
+        ++counts[query];
+      }
+      started.push_back(expected_started);
+
+    } else if(itr->is_end()) {
+
+      expected_ended = started.back();
+      started.pop_back();
+      elements.pop_back();
+
+    }
+
+    const std::string where = filename + " event " + std::to_string(event);
+    srcreader_test::check(matcher.started() == expected_started, (where + " started").c_str(), __FILE__, __LINE__);
+    srcreader_test::check(matcher.ended() == expected_ended, (where + " ended").c_str(), __FILE__, __LINE__);
+
+    for(std::size_t query = 0; query < queries.size(); ++query) {
+      bool inside = std::any_of(started.begin(), started.end(), [query](const std::vector<std::size_t> & queries) {
+        return std::find(queries.begin(), queries.end(), query) != queries.end(); });
+      srcreader_test::check(matcher.is_inside(query) == inside, (where + " inside").c_str(), __FILE__, __LINE__);
+    }
+
+  }
+
+  return counts;
+}
+
+/**
+ * The matcher reports the same matches as a direct check of the open
+ * elements for child, wildcard, descendant and predicate steps, with
+ * and without a leading slash, over the archive and a solitary unit.
+ * Every query matches somewhere.
+ */
+SRCREADER_TEST(path_matcher) {
+
+  std::vector<std::size_t> archive = check_matches(fixtures + "/archive.xml");
+  std::vector<std::size_t> unit = check_matches(fixtures + "/position.xml");
+
+  for(std::size_t query = 0; query < expected_queries().size(); ++query) {
+    SRCREADER_CHECK(archive[query] + unit[query] > 0);
+  }
+
+  SRCREADER_CHECK_EQUAL(archive[0], std::size_t(4));
+  SRCREADER_CHECK_EQUAL(archive[1], std::size_t(2));
+  SRCREADER_CHECK_EQUAL(unit[0], std::size_t(0));
+
+}
@@ -0,0 +1,171 @@
+/*
+  srcreader_test.hpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#ifndef INCLUDED_SRCREADER_TEST_HPP
+#define INCLUDED_SRCREADER_TEST_HPP
+
+#include <srcml_node.hpp>
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+/**
+ * srcreader_test
+ *
+ * Support for the test programs under test/.  Each program is one ctest
+ * test, run with the fixtures directory as its argument, and fails when
+ * a check throws.
+ */
+class srcreader_test {
+
+public:
+
+  typedef void (*test_function)(const std::string & fixtures);
+
+  static void check(bool condition, const char * expression, const char * file, int line) {
+
+    if(condition) return;
+
+    std::ostringstream message;
+    message << file << ':' << line << ": check failed: " << expression;
+    throw std::runtime_error(message.str());
+
+  }
+
+  template<class actual_type, class expected_type>
+  static void check_equal(const actual_type & actual, const expected_type & expected, const char * expression, const char * file, int line) {
+
+    if(actual == expected) return;
+
+    std::ostringstream message;
+    message << file << ':' << line << ": check failed: " << expression << "\n  actual:   " << actual << "\n  expected: " << expected;
+    throw std::runtime_error(message.str());
+
+  }
+
+  /** the contents of a file, e.g., a fixture */
+  static std::string read_file(const std::string & filename) {
+
+    std::ifstream in(filename, std::ios::binary);
+    if(!in) throw std::runtime_error("cannot open " + filename);
+
+    std::ostringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+
+  }
+
+  /** a document without pos:tabs attributes, which srcml_writer does not write */
+  static std::string without_tabs(std::string document) {
+
+    for(std::string::size_type tabs; (tabs = document.find(" pos:tabs=\"")) != std::string::npos;) {
+      document.erase(tabs, document.find('"', tabs + 11) + 1 - tabs);
+    }
+
+    return document;
+  }
+
+  /** every field of an event, and the depth of the element stack after it */
+  static std::string describe(const srcml_node & node, std::size_t depth) {
+
+    std::ostringstream out;
+    out << "type=" << int(node.type) << " name=" << node.full_name() << " depth=" << depth;
+
+    if(node.ns) {
+      out << " ns=" << node.ns->uri;
+      if(node.ns->prefix) out << " prefix=" << node.ns->prefix->str();
+    }
+
+    if(node.content) out << " content='" << node.content.view() << '\'';
+
+    for(const std::shared_ptr<srcml_node::srcml_namespace> & ns : node.ns_definition) {
+      out << " xmlns";
+      if(ns->prefix) out << ':' << ns->prefix->str();
+      out << "='" << ns->uri << '\'';
+    }
+
+    for(const srcml_node::srcml_attribute_map_pair & attribute : node.attributes) {
+      out << ' ' << attribute.first.str() << '=';
+      if(attribute.second.value) out << '\'' << *attribute.second.value << '\'';
+      if(attribute.second.ns) out << " ns=" << attribute.second.ns->uri;
+    }
+
+    if(node.empty) out << " empty";
+
+    return out.str();
+  }
+
+  /** fail on the first of two sequences of described events that differ */
+  static void check_events(const std::vector<std::string> & actual, const std::vector<std::string> & expected,
+                           const std::string & where, const char * file, int line) {
+
+    check(expected.size() > 2, (where + ": expected events").c_str(), file, line);
+    for(std::size_t event = 0; event < expected.size() || event < actual.size(); ++event) {
+
+      std::string location = where + " event " + std::to_string(event);
+      check_equal(event < actual.size() ? actual[event] : "(no event)",
+                  event < expected.size() ? expected[event] : "(no event)",
+                  location.c_str(), file, line);
+
+    }
+
+  }
+
+  static int run(int argc, char * argv[], test_function test) {
+
+    if(argc != 2) {
+      std::cerr << "usage: " << argv[0] << " <fixtures directory>\n";
+      return 2;
+    }
+
+    try {
+      test(argv[1]);
+    } catch(const std::exception & error) {
+      std::cerr << error.what() << '\n';
+      return 1;
+    }
+
+    return 0;
+  }
+
+};
+
+#define SRCREADER_CHECK(CONDITION) \
+  srcreader_test::check((CONDITION), #CONDITION, __FILE__, __LINE__)
+
+#define SRCREADER_CHECK_EQUAL(ACTUAL, EXPECTED) \
+  srcreader_test::check_equal((ACTUAL), (EXPECTED), #ACTUAL " == " #EXPECTED, __FILE__, __LINE__)
+
+#define SRCREADER_CHECK_EVENTS(ACTUAL, EXPECTED, WHERE) \
+  srcreader_test::check_events((ACTUAL), (EXPECTED), (WHERE), __FILE__, __LINE__)
+
+#define SRCREADER_TEST(NAME) \
+  static void NAME##_test(const std::string & fixtures); \
+  int main(int argc, char * argv[]) { return srcreader_test::run(argc, argv, NAME##_test); } \
+  static void NAME##_test(const std::string & fixtures)
+
+#endif
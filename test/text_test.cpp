@@ -0,0 +1,84 @@
+/*
+  text_test.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_test.hpp>
+
+#include <srcml_reader.hpp>
+
+#include <string>
+
+/** the events of a document, one per line: start and end tags by name, text quoted */
+static std::string events(const std::string & filename) {
+
+  std::string events;
+  srcml_reader reader(filename);
+  for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+
+    if(itr->is_start()) {
+      events += '<' + itr->full_name() + '>';
+    } else if(itr->is_end()) {
+      events += "</" + itr->full_name() + '>';
+    } else if(itr->is_text()) {
+      events += '\'' + itr->content.view().to_string() + '\'';
+    }
+    events += '\n';
+
+  }
+
+  return events;
+}
+
+/**
+ * Text is split into maximal runs of whitespace and of non-whitespace,
+ * so a run of indentation is one event rather than one per character.
+ */
+SRCREADER_TEST(text) {
+
+  SRCREADER_CHECK_EQUAL(events(fixtures + "/text.xml"),
+                        "<unit>\n"
+                        "<decl_stmt>\n"
+                        "<decl>\n"
+                        "<type>\n"
+                        "<name>\n"
+                        "'int'\n"
+                        "</name>\n"
+                        "</type>\n"
+                        "'   '\n"
+                        "<name>\n"
+                        "'x'\n"
+                        "</name>\n"
+                        "</decl>\n"
+                        "';'\n"
+                        "</decl_stmt>\n"
+                        "'\n\t'\n"
+                        "<comment>\n"
+                        "'//'\n"
+                        "' '\n"
+                        "'a'\n"
+                        "'  '\n"
+                        "'b'\n"
+                        "</comment>\n"
+                        "'\n'\n"
+                        "</unit>\n");
+
+}
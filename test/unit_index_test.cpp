@@ -0,0 +1,142 @@
+/*
+  unit_index_test.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_test.hpp>
+
+#include <srcml_unit_index.hpp>
+#include <srcml_indexed_reader.hpp>
+
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <cstdio>
+
+static void write_file(const std::string & filename, const std::string & contents) {
+
+  std::ofstream out(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+  out.write(contents.data(), contents.size());
+  if(!out) throw std::runtime_error("cannot write " + filename);
+
+}
+
+/** filename attribute of the first node a unit reader returns */
+static std::string first_filename(const srcml_indexed_reader & reader, std::size_t unit_number) {
+
+  std::unique_ptr<srcml_reader> unit = reader.read_unit(unit_number);
+  srcml_reader::srcml_reader_iterator itr = unit->begin();
+  const std::string * filename = itr->get_attribute_value("filename");
+
+  return filename ? *filename : std::string();
+}
+
+/** true if loading a sidecar throws */
+static bool load_throws(const std::string & filename) {
+
+  try {
+    srcml_unit_index index;
+    index.load(filename);
+  } catch(const std::runtime_error &) {
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * An index is saved and loaded back unchanged, and is only trusted for
+ * the archive it was built from: its size, modification time, prolog
+ * and each unit's start tag are checked.  A corrupt sidecar with sizes
+ * that would overflow is rejected.  Files are written to the working
+ * directory.
+ */
+SRCREADER_TEST(unit_index) {
+
+  std::string archive = srcreader_test::read_file(fixtures + "/archive.xml");
+
+  srcml_unit_index built(archive.data(), archive.size(), 42);
+  built.save("unit_index_test.idx");
+
+  srcml_unit_index loaded;
+  loaded.load("unit_index_test.idx");
+  SRCREADER_CHECK(loaded.is_archive());
+  SRCREADER_CHECK_EQUAL(loaded.size(), std::size_t(4));
+  SRCREADER_CHECK_EQUAL(loaded.get_source_mtime(), std::uint64_t(42));
+  SRCREADER_CHECK_EQUAL(loaded.get_root_end_tag(), "</unit>");
+  SRCREADER_CHECK_EQUAL(loaded.get_filename(1), "main.cpp");
+  SRCREADER_CHECK_EQUAL(loaded.get_language(3), "Java");
+  SRCREADER_CHECK_EQUAL(loaded.get_hash(0), "2b6e7c1d0f");
+  SRCREADER_CHECK_EQUAL(loaded.find("empty.c"), std::size_t(2));
+  SRCREADER_CHECK(loaded.find("missing.c") == srcml_unit_index::npos);
+  for(std::size_t unit = 0; unit < loaded.size(); ++unit) {
+    SRCREADER_CHECK_EQUAL(loaded.get_unit(unit).offset, built.get_unit(unit).offset);
+    SRCREADER_CHECK_EQUAL(loaded.get_unit(unit).length, built.get_unit(unit).length);
+  }
+
+  // a change of the same size is caught by the modification time, the prolog or the unit itself
+  std::string renamed = archive;
+  renamed.replace(renamed.find("point.hpp"), 9, "pnint.hpp");
+  std::string retabbed = archive;
+  retabbed.replace(retabbed.find("pos:tabs=\"8\""), 12, "pos:tabs=\"4\"");
+
+  SRCREADER_CHECK(loaded.matches(archive.data(), archive.size(), 42));
+  SRCREADER_CHECK(!loaded.matches(archive.data(), archive.size(), 43));
+  SRCREADER_CHECK(!loaded.matches(archive.data(), archive.size() - 1, 42));
+  SRCREADER_CHECK(!loaded.matches(retabbed.data(), retabbed.size(), 42));
+  SRCREADER_CHECK(loaded.matches(renamed.data(), renamed.size(), 42));
+  SRCREADER_CHECK(!loaded.unit_matches(renamed.data(), 0));
+  SRCREADER_CHECK(loaded.unit_matches(renamed.data(), 1));
+
+  // rewriting the archive in place never reads a unit through the stale sidecar
+  write_file("unit_index_test.xml", archive);
+  std::remove("unit_index_test.xml.idx");
+  {
+    srcml_indexed_reader reader("unit_index_test.xml");
+    SRCREADER_CHECK_EQUAL(first_filename(reader, 0), "point.hpp");
+  }
+
+  write_file("unit_index_test.xml", renamed);
+  {
+    srcml_indexed_reader reader("unit_index_test.xml");
+    try {
+      SRCREADER_CHECK_EQUAL(first_filename(reader, 0), "pnint.hpp");
+    } catch(const std::runtime_error & error) {
+      SRCREADER_CHECK_EQUAL(std::string(error.what()), "Unit index does not match archive");
+    }
+    SRCREADER_CHECK_EQUAL(first_filename(reader, 1), "main.cpp");
+  }
+
+  // a unit count whose size would overflow
+  std::string sidecar = srcreader_test::read_file("unit_index_test.idx");
+  std::string corrupt = sidecar;
+  corrupt.replace(8 + 4 + 4 + 8 * 4, 8, std::string("\x00\x00\x00\x00\x00\x00\x00\x04", 8));
+  write_file("unit_index_test.idx", corrupt);
+  SRCREADER_CHECK(load_throws("unit_index_test.idx"));
+
+  write_file("unit_index_test.idx", sidecar.substr(0, sidecar.size() - 1));
+  SRCREADER_CHECK(load_throws("unit_index_test.idx"));
+
+  std::remove("unit_index_test.idx");
+  std::remove("unit_index_test.xml");
+  std::remove("unit_index_test.xml.idx");
+
+}
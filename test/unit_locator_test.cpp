@@ -0,0 +1,109 @@
+/*
+  unit_locator_test.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_test.hpp>
+
+#include <srcml_unit_locator.hpp>
+#include <srcml_parallel_reader.hpp>
+#include <srcml_reader.hpp>
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+/** true if locating the units of a document throws */
+static bool locate_throws(const std::string & document) {
+
+  try {
+    srcml_unit_locator locator(document.data(), document.size());
+  } catch(const std::runtime_error &) {
+    return true;
+  }
+
+  return false;
+}
+
+/** true if reading a whole file throws */
+static bool read_throws(const std::string & filename) {
+
+  try {
+    srcml_reader reader(filename);
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr)
+      ;
+  } catch(const std::runtime_error &) {
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * Units are located in an archive and in a solitary unit, and malformed
+ * or truncated documents throw instead of losing a partial unit.  The
+ * parallel reader fails on a truncated archive as the sequential reader
+ * does.
+ */
+SRCREADER_TEST(unit_locator) {
+
+  std::string archive = srcreader_test::read_file(fixtures + "/archive.xml");
+  srcml_unit_locator locator(archive.data(), archive.size());
+  SRCREADER_CHECK(locator.is_archive());
+  SRCREADER_CHECK_EQUAL(locator.get_root_name(), "unit");
+  SRCREADER_CHECK_EQUAL(locator.get_units().size(), std::size_t(4));
+  for(const srcml_unit_locator::srcml_unit_range & range : locator.get_units()) {
+    SRCREADER_CHECK_EQUAL(archive.compare(range.offset, 5, "<unit"), 0);
+    SRCREADER_CHECK(archive.compare(range.offset + range.length - 7, 7, "</unit>") == 0
+                    || archive.compare(range.offset + range.length - 2, 2, "/>") == 0);
+  }
+
+  std::string unit = srcreader_test::read_file(fixtures + "/text.xml");
+  srcml_unit_locator solitary(unit.data(), unit.size());
+  SRCREADER_CHECK(!solitary.is_archive());
+  SRCREADER_CHECK_EQUAL(solitary.get_units().size(), std::size_t(1));
+
+  SRCREADER_CHECK(!locate_throws("<unit><unit>x</unit><!-- done --></unit>\n<?pi?>\n"));
+  SRCREADER_CHECK(!locate_throws("\xEF\xBB\xBF<unit/>"));
+
+  SRCREADER_CHECK(locate_throws(""));
+  SRCREADER_CHECK(locate_throws("<unit><unit>x</unit>"));
+  SRCREADER_CHECK(locate_throws("<unit><unit>x</unit></unit"));
+  SRCREADER_CHECK(locate_throws("<unit><unit>x</unit><"));
+  SRCREADER_CHECK(locate_throws("<unit><unit>x<!-- </unit></unit>"));
+  SRCREADER_CHECK(locate_throws("<unit><unit>x</name></unit></unit>"));
+  SRCREADER_CHECK(locate_throws("<unit><unit>x</unit></unit></unit>"));
+  SRCREADER_CHECK(locate_throws("<unit><unit>x</unit></unit><unit/>"));
+  SRCREADER_CHECK(locate_throws("<unit><unit>x</unit></unit>x"));
+  SRCREADER_CHECK(locate_throws(archive.substr(0, archive.size() / 2)));
+
+  SRCREADER_CHECK(read_throws(fixtures + "/truncated.xml"));
+
+  bool parallel_threw = false;
+  try {
+    srcml_parallel_reader parallel(fixtures + "/truncated.xml", 2);
+    parallel.read([](std::size_t, std::vector<srcml_node> &) {});
+  } catch(const std::runtime_error &) {
+    parallel_threw = true;
+  }
+  SRCREADER_CHECK(parallel_threw);
+
+}
@@ -0,0 +1,77 @@
+/*
+  writer_test.cpp
+
+  Copyright (C) 2018 srcML, LLC. (www.srcML.org)
+
+  This file is part of a translator from source code to srcReader
+
+  srcReader is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  srcReader is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with the srcML translator; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+*/
+
+#include <srcreader_test.hpp>
+
+#include <srcml_reader.hpp>
+#include <srcml_writer.hpp>
+
+#include <string>
+#include <cstdio>
+
+/** what srcml_writer writes for a document read with or without split text */
+static std::string write_xml(const std::string & document, bool split_text) {
+
+  {
+    srcml_reader reader(document.data(), document.size());
+    reader.set_split_text(split_text);
+    srcml_writer writer("writer_test.xml");
+    for(srcml_reader::srcml_reader_iterator itr = reader.begin(); itr != reader.end(); ++itr) {
+      writer.write(*itr);
+    }
+  }
+
+  std::string xml = srcreader_test::read_file("writer_test.xml");
+  std::remove("writer_test.xml");
+
+  return xml;
+}
+
+/**
+ * srcml_writer writes the same bytes whether the reader splits text
+ * into whitespace and non-whitespace runs or not: for archives, for
+ * solitary units, for text before the first start tag of a solitary
+ * unit, which is held until that tag, and for a solitary unit with
+ * only text.  The fixtures are used without pos:tabs, and the output is
+ * written to the working directory.
+ */
+SRCREADER_TEST(writer) {
+
+  for(const char * fixture : { "/text.xml", "/archive.xml", "/position.xml" }) {
+
+    const std::string document = srcreader_test::without_tabs(srcreader_test::read_file(fixtures + fixture));
+    SRCREADER_CHECK_EQUAL(write_xml(document, false), write_xml(document, true));
+
+  }
+
+  const std::string leading_text = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+    "<unit xmlns=\"http://www.srcML.org/srcML/src\" language=\"C\" filename=\"a.c\">\n  x  =  1 ;\t<expr_stmt><expr><name>y</name></expr>;</expr_stmt>\n</unit>\n";
+  const std::string split = write_xml(leading_text, true);
+  SRCREADER_CHECK_EQUAL(write_xml(leading_text, false), split);
+  SRCREADER_CHECK(split.find("\n  x  =  1 ;\t<expr_stmt>") != std::string::npos);
+
+  const std::string only_text = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+    "<unit xmlns=\"http://www.srcML.org/srcML/src\" language=\"C\" filename=\"b.c\">  x  =  1 ;\n</unit>\n";
+  SRCREADER_CHECK_EQUAL(write_xml(only_text, false), write_xml(only_text, true));
+
+}